@@ -4,6 +4,7 @@ Name: crash-reporter
 Version: 1.15.17
 Release: 0
 URL: https://github.com/mer-qa/crash-reporter
+BuildRequires: qt5-qtconcurrent-devel
 BuildRequires: qt5-qtdbus-devel
 BuildRequires: qt5-qtdeclarative-devel
 BuildRequires: qt5-qtgui-devel
@@ -13,6 +14,8 @@ BuildRequires: pkgconfig(dbus-1)
 BuildRequires: pkgconfig(libiphb)
 BuildRequires: pkgconfig(libudev)
 BuildRequires: pkgconfig(libsystemd)
+BuildRequires: pkgconfig(liblzma)
+BuildRequires: pkgconfig(lzo2)
 BuildRequires: pkgconfig(mce)
 BuildRequires: pkgconfig(qt5-boostable)
 BuildRequires: pkgconfig(nemonotifications-qt5)
@@ -20,16 +23,15 @@ BuildRequires: pkgconfig(systemsettings)
 BuildRequires: pkgconfig(usb-moded-qt5)
 BuildRequires: pkgconfig(systemd)
 BuildRequires: oneshot
+# Reference implementation for the unit tests of the LZO writer.
+BuildRequires: lzop
 Requires: gawk
-Requires: lzop
 Requires: sp-rich-core >= 1.71.2
 Requires: sp-endurance
 Requires: oneshot
 Requires: sailfishsilica-qt5 >= 0.27.0
 Requires: ssu
 Requires: ssu-sysinfo
-Requires: tar
-Requires: xz
 Conflicts: quick-feedback < 0.0.18
 %{_oneshot_requires_post}
 Source0: %{name}-%{version}.tar.gz
@@ -102,7 +104,7 @@ fi
 
 %postun
 if [ "$1" = 0 ]; then
-  rm -rf /var/cache/core-dumps/uploadlog /var/cache/core-dumps/endurance-enabled-mark /var/cache/core-dumps/endurance
+  rm -rf /var/cache/core-dumps/uploadlog /var/cache/core-dumps/core-index /var/cache/core-dumps/upload-journal /var/cache/core-dumps/upload-digests /var/cache/core-dumps/crash-signatures /var/cache/core-dumps/duplicates /var/cache/core-dumps/endurance-enabled-mark /var/cache/core-dumps/endurance
 fi
 
 %post -n libcrash-reporter0 -p /sbin/ldconfig
@@ -118,6 +120,7 @@ fi
 %attr(0755,root,root) /usr/libexec/crash-reporter-journalspy
 %attr(0755,root,root) /usr/libexec/crash-reporter-storagemon
 %attr(0755,root,root) /usr/libexec/endurance-collect*
+%attr(0755,root,root) /usr/libexec/endurance-pack
 %attr(4755,root,root) /usr/libexec/rich-core-helper
 %attr(4750,root,privileged) /usr/libexec/crashreporter-servicehelper
 %{_datadir}/%{name}
@@ -40,6 +40,7 @@ TEMPLATE = app
 TARGET = crash-reporter-autouploader
 
 INCLUDEPATH += ../libs/serviceif \
+               ../libs/coredir \
                ../libs/settings \
                ../libs/logger \
                ../libs/httpclient \
@@ -25,25 +25,43 @@
  *
  */
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDBusConnection>
+#include <QFile>
+#include <QSet>
+#include <QTimer>
 
 #include <notification.h>
 
+#include "creporterapplicationsettings.h"
 #include "creporterautouploader.h"
+#include "creporterconnectionpool.h"
+#include "creportercoreregistry.h"
 #include "creporternamespace.h"
 #include "creporternwsessionmgr.h"
 #include "creportersavedstate.h"
 #include "creporteruploadqueue.h"
 #include "creporteruploaditem.h"
 #include "creporteruploadengine.h"
+#include "creporteruploadjournal.h"
 #include "creporterutils.h"
 #include "creporterprivacysettingsmodel.h"
+#include "creporterretrypolicy.h"
 
 #include "autouploader_adaptor.h" // generated
 
 using CReporter::LoggingCategory::cr;
 
+namespace {
+/* Retries due within this time (ms) are done in the current session,
+ * instead of waking up again for them. */
+const qint64 RetryCoalesceWindow = 60 * 1000;
+/* Reports that have used all their attempts get a new set of attempts
+ * after this time (ms). */
+const qint64 GiveUpPeriod = 24 * 60 * 60 * 1000;
+} // namespace
+
 /*! @class CReporterAutoUploaderPrivate
   * @brief Private CReporterAutoUploaderPrivate class.
   *
@@ -56,10 +74,12 @@ public:
     CReporterUploadEngine *engine;
     //! @arg Upload queue.
     CReporterUploadQueue queue;
+    //! @arg Persistent state of the queued files.
+    CReporterUploadJournal *journal;
     //! @arg Is the service active.
     bool activated;
     //! @arg files that have been added to upload queue during this auto uploader session
-    QStringList addedFiles;
+    QSet<QString> addedFiles;
     /*! Notification object giving user a notice that upload is in progress.*/
     Notification *progressNotification;
     /*! Notification object giving user a notice of successful uploads.*/
@@ -74,6 +94,18 @@ CReporterAutoUploader::CReporterAutoUploader()
 {
     d_ptr->engine = 0;
     d_ptr->activated = false;
+    QString journalFile(CReporterUploadJournal::defaultJournalFile());
+    if (journalFile.isEmpty()) {
+        qCWarning(cr) << "No core dump directories, upload state isn't kept after exit.";
+    }
+    d_ptr->journal = new CReporterUploadJournal(journalFile);
+    qCDebug(cr) << d_ptr->journal->count() << "files pending in upload journal.";
+
+    connect(&d_ptr->queue, SIGNAL(itemAdded(CReporterUploadItem *)),
+            SLOT(itemQueued(CReporterUploadItem *)));
+    connect(&d_ptr->queue, SIGNAL(nextItem(CReporterUploadItem *)),
+            SLOT(itemStarted(CReporterUploadItem *)));
+
     d_ptr->progressNotification = new Notification(this);
     d_ptr->successNotification = new Notification(this);
     d_ptr->successNotification->setReplacesId(CReporterSavedState::instance()->uploadSuccessNotificationId());
@@ -95,6 +127,7 @@ CReporterAutoUploader::CReporterAutoUploader()
 CReporterAutoUploader::~CReporterAutoUploader()
 {
     quit();
+    delete d_ptr->journal;
     delete d_ptr;
     d_ptr = 0;
 
@@ -106,15 +139,12 @@ CReporterAutoUploader::~CReporterAutoUploader()
 bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
                                         bool obeyResourcesRestrictions)
 {
-    qCDebug(cr) << "Received a list of files to upload.";
+    qCDebug(cr) << "Received a list of" << fileList.count() << "files to upload.";
 
-    if (fileList.isEmpty())
-        return false;
-
-    if (!d_ptr->activated) {
-        d_ptr->engine = new CReporterUploadEngine(&d_ptr->queue);
-        d_ptr->activated = true;
-        connect(d_ptr->engine, SIGNAL(finished(int, int, int)), SLOT(engineFinished(int, int, int)));
+    // An empty list still makes the files in the journal to be picked up.
+    // Journal the files first, so that they are retried if upload can't be done now.
+    foreach (const QString &filename, fileList) {
+        d_ptr->journal->add(filename);
     }
 
     if (obeyResourcesRestrictions &&
@@ -131,12 +161,62 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
         return false;
     }
 
-    foreach (QString filename, fileList) {
+    QStringList files;
+    QSet<QString> listed;
+    qint64 due = QDateTime::currentMSecsSinceEpoch() + RetryCoalesceWindow;
+    foreach (const QString &filename, fileList) {
+        // Automatic uploads wait for the retry delay, explicit requests don't.
+        if (obeyResourcesRestrictions && d_ptr->journal->entry(filename).nextEligible > due) {
+            qCDebug(cr) << "Not retrying" << filename << "yet.";
+            continue;
+        }
+        files << filename;
+        listed.insert(filename);
+    }
+
+    // Pick up files left pending by earlier sessions without rescanning core directories.
+    foreach (const CReporterUploadJournal::Entry &entry, d_ptr->journal->entries()) {
+        if (!QFile::exists(entry.filePath)) {
+            qCDebug(cr) << "Dropping removed file from upload journal:" << entry.filePath;
+            d_ptr->journal->remove(entry.filePath);
+            if (listed.remove(entry.filePath)) {
+                files.removeOne(entry.filePath);
+            }
+        } else if (entry.nextEligible <= due && !listed.contains(entry.filePath)) {
+            files << entry.filePath;
+            listed.insert(entry.filePath);
+        }
+    }
+
+    if (files.isEmpty()) {
+        /* Nothing is due. The daemon sends a new request when the
+         * earliest failed upload is due for retry. */
+        if (!d_ptr->activated) {
+            QTimer::singleShot(0, this, SLOT(quit()));
+        }
+        return false;
+    }
+
+    if (!d_ptr->activated) {
+        d_ptr->engine = new CReporterUploadEngine(&d_ptr->queue);
+        d_ptr->queue.setMaxActiveItems(
+                CReporterApplicationSettings::instance()->maxParallelUploads());
+        d_ptr->queue.setBatchLimits(CReporterApplicationSettings::instance()->batchSizeLimit(),
+                                    CReporterApplicationSettings::instance()->batchMaxFiles());
+        d_ptr->queue.setOrder(CReporterApplicationSettings::instance()->uploadOrder() == "fifo"
+                              ? CReporterUploadQueue::Fifo : CReporterUploadQueue::Priority);
+        d_ptr->queue.setAgingInterval(
+                CReporterApplicationSettings::instance()->uploadAgingInterval() * 1000);
+        d_ptr->activated = true;
+        connect(d_ptr->engine, SIGNAL(finished(int, int, int)), SLOT(engineFinished(int, int, int)));
+    }
+
+    foreach (QString filename, files) {
         if (!d_ptr->addedFiles.contains(filename)) {
             qCDebug(cr) << "Adding to upload queue: " << filename;
             // CReporterUploadQueue class will own the CReporterUploadItem instance.
             d_ptr->queue.enqueue(new CReporterUploadItem(filename));
-            d_ptr->addedFiles << filename;
+            d_ptr->addedFiles.insert(filename);
         } else {
             qCDebug(cr) << filename << "was not added to queue because it had already been added before";
         }
@@ -146,7 +226,7 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
         //% "Uploading reports"
         QString summary = qtTrId("crash_reporter-notify-uploading_reports");
         //% "%n report(s) to upload"
-        QString body = qtTrId("crash_reporter-notify-num_to_upload", fileList.count());
+        QString body = qtTrId("crash_reporter-notify-num_to_upload", files.count());
         d_ptr->progressNotification->setSummary(summary);
         d_ptr->progressNotification->setBody(body);
         d_ptr->progressNotification->publish();
@@ -158,6 +238,12 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
 void CReporterAutoUploader::quit()
 {
     qCDebug(cr) << "Quit auto uploader.";
+    releaseEngine();
+    qApp->quit();
+}
+
+void CReporterAutoUploader::releaseEngine()
+{
     if (d_ptr->engine) {
         if (d_ptr->activated) {
             qCDebug(cr) << "Engine active -> cancelling";
@@ -169,13 +255,18 @@ void CReporterAutoUploader::quit()
         d_ptr->engine->deleteLater();
         d_ptr->engine = 0;
     }
-    qApp->quit();
 }
 
 void CReporterAutoUploader::engineFinished(int error, int sent, int total)
 {
     QString message;
 
+    CReporterConnectionPool *pool = CReporterConnectionPool::instance();
+    qCDebug(cr) << "Uploads finished. Requests:" << pool->requestCount()
+                << "TLS handshakes:" << pool->handshakeCount()
+                << "reused connections:" << pool->reusedConnectionCount()
+                << "HTTP/2:" << pool->http2Count();
+
     // Construct message.
     switch (error) {
     case CReporterUploadEngine::NoError:
@@ -259,7 +350,81 @@ void CReporterAutoUploader::engineFinished(int error, int sent, int total)
     qCDebug(cr) << "Message: " << message;
 
     d_ptr->activated = false;
+    releaseEngine();
+    d_ptr->addedFiles.clear();
+
+    // The daemon asks for the next retry once the journal says it's due.
     quit();
 }
 
+void CReporterAutoUploader::itemQueued(CReporterUploadItem *item)
+{
+    connect(item, SIGNAL(uploadFinished()), SLOT(itemFinished()));
+    connect(item, SIGNAL(uploadStateChanged(QString, CReporterCoreIndex::UploadState)),
+            SLOT(itemStateChanged(QString, CReporterCoreIndex::UploadState)));
+}
+
+void CReporterAutoUploader::itemStarted(CReporterUploadItem *item)
+{
+    d_ptr->journal->setState(item->filePath(), CReporterUploadJournal::Uploading);
+}
+
+void CReporterAutoUploader::itemFinished()
+{
+    CReporterUploadItem *item = qobject_cast<CReporterUploadItem *>(sender());
+    if (!item) {
+        return;
+    }
+
+    switch (item->status()) {
+    case CReporterUploadItem::Finished:
+        d_ptr->journal->remove(item->filePath());
+        break;
+    case CReporterUploadItem::Error:
+        d_ptr->journal->setState(item->filePath(), CReporterUploadJournal::Failed,
+                                 item->errorString());
+        postponeRetry(item->filePath(), item->retryAfter());
+        break;
+    default:
+        d_ptr->journal->setState(item->filePath(), CReporterUploadJournal::Pending);
+        if (d_ptr->activated) {
+            // Cancelled by the engine after losing the network, not by quit().
+            postponeRetry(item->filePath(), -1);
+        }
+        break;
+    }
+}
+
+void CReporterAutoUploader::itemStateChanged(const QString &file,
+                                             CReporterCoreIndex::UploadState state)
+{
+    CReporterCoreIndex *index = CReporterCoreRegistry::instance()->coreIndex();
+    if (state == CReporterCoreIndex::Uploaded && !QFile::exists(file)) {
+        // Removed after sending.
+        index->remove(file);
+    } else {
+        index->setUploadState(file, state);
+    }
+}
+
+void CReporterAutoUploader::postponeRetry(const QString &filePath, int retryAfter)
+{
+    CReporterRetryPolicy policy(CReporterRetryPolicy::fromSettings());
+    int attempts = d_ptr->journal->entry(filePath).attempts;
+
+    if (!policy.canRetry(attempts)) {
+        qCWarning(cr) << "Giving up uploading" << filePath << "after" << attempts << "attempts.";
+        // Start over with a new entry, so that the attempts are counted again.
+        d_ptr->journal->remove(filePath);
+        d_ptr->journal->add(filePath);
+        d_ptr->journal->setNextEligible(filePath,
+                                        QDateTime::currentMSecsSinceEpoch() + GiveUpPeriod);
+        return;
+    }
+
+    qint64 delay = policy.retryDelay(attempts, retryAfter);
+    qCDebug(cr) << "Retrying upload of" << filePath << "in" << delay / 1000 << "seconds.";
+    d_ptr->journal->setNextEligible(filePath, QDateTime::currentMSecsSinceEpoch() + delay);
+}
+
 #include "moc_autouploader_adaptor.cpp"
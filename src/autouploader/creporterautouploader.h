@@ -30,7 +30,10 @@
 #include <QDBusError>
 #include <QStringList>
 
+#include "creportercoreindex.h"
+
 class CReporterAutoUploaderPrivate;
+class CReporterUploadItem;
 
 /*!
   * @class CReporterAutoUploader
@@ -76,7 +79,43 @@ private Q_SLOTS:
       */
     void engineFinished(int error, int sent, int total);
 
+    /*!
+      * @brief Called, when @a item is added to upload queue.
+      */
+    void itemQueued(CReporterUploadItem *item);
+
+    /*!
+      * @brief Called, when upload of @a item starts.
+      */
+    void itemStarted(CReporterUploadItem *item);
+
+    /*!
+      * @brief Called, when upload of an item has finished, failed or was
+      * cancelled.
+      */
+    void itemFinished();
+
+    /*!
+      * @brief Stores upload state of @a file into the core index.
+      */
+    void itemStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
+
 private:
+    /*!
+      * @brief Cancels uploads and deletes the upload engine.
+      */
+    void releaseEngine();
+
+    /*!
+      * @brief Sets time for the next upload attempt of @a filePath after a
+      * failure. If it has been tried too many times, it isn't tried again
+      * before a long pause.
+      *
+      * @param filePath Path of the file.
+      * @param retryAfter Delay in seconds requested by the server, or -1.
+      */
+    void postponeRetry(const QString &filePath, int retryAfter);
+
     Q_DECLARE_PRIVATE(CReporterAutoUploader)
 
     CReporterAutoUploaderPrivate *d_ptr;
@@ -26,11 +26,13 @@
  */
 
 #include <QCoreApplication>
+#include <QEventLoop>
 #include <QTranslator>
 #include <QLocale>
 #include <QDebug>
 
 #include "creporterautouploader.h"
+#include "creporterdeviceidentity.h"
 #include "creporternamespace.h"
 #include "creporterutils.h"
 #include "creporterapplicationsettings.h"
@@ -55,10 +57,20 @@ int main(int argc, char **argv)
     qCDebug(cr) << CReporter::AutoUploaderBinaryName << "[" << app.applicationPid() << "]" << "started.";
     qCDebug(cr) << "Crash Reporter version is " << QString(CREPORTERVERSION);
 
+    /* Reports are sent with the device UID from SSU. The upload request is
+     * taken once SSU has answered, D-Bus holds it meanwhile. */
+    CReporterDeviceIdentity *identity = CReporterDeviceIdentity::instance();
+    if (!identity->isResolved()) {
+        QEventLoop loop;
+        QObject::connect(identity, SIGNAL(resolved()), &loop, SLOT(quit()));
+        loop.exec();
+    }
+
     CReporterAutoUploader uploader;
 
     int retVal = app.exec();
 
+    CReporterDeviceIdentity::freeSingleton();
     CReporterApplicationSettings::instance()->freeSingleton();
     qCDebug(cr) << "Shutting down Auto Uploader process.";
     return retVal;
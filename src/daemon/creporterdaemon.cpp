@@ -25,6 +25,11 @@
  *
  */
 
+#include <QDBusServiceWatcher>
+#include <QDateTime>
+
+#include <limits>
+
 #include <notification.h>
 
 #include "creporterdaemon.h"
@@ -32,8 +37,11 @@
 #include "creporterdaemonadaptor.h"
 #include "creporterdaemonmonitor.h"
 #include "creporternwsessionmgr.h"
+#include "creporterpowerstate.h"
 #include "creportersavedstate.h"
 #include "creportercoreregistry.h"
+#include "creporteruploadjournal.h"
+#include "creporteruploadnotifier.h"
 #include "creporterutils.h"
 #include "creporternamespace.h"
 #include "creporterprivacysettingsmodel.h"
@@ -41,6 +49,16 @@
 
 using CReporter::LoggingCategory::cr;
 
+namespace {
+/* Time (ms) to wait for further connectivity changes before deciding whether
+ * the pending reports can be uploaded. Connecting to a network produces a
+ * burst of configuration changes. */
+const int ConnectivitySettleDelay = 3000;
+/* Minimum time (ms) before a retry. Keeps an entry that the auto uploader
+ * leaves due from waking it up in a loop. */
+const int MinRetryDelay = 10000;
+} // namespace
+
 CReporterDaemon::CReporterDaemon()
     : d_ptr(new CReporterDaemonPrivate(this))
 {
@@ -59,6 +77,10 @@ CReporterDaemon::~CReporterDaemon()
 
     CReporterPrivacySettingsModel::instance()->freeSingleton();
     CReporterSavedState::freeSingleton();
+    CReporterUploadNotifier::freeSingleton();
+#ifndef CREPORTER_UNIT_TEST
+    CReporterPowerState::freeSingleton();
+#endif
 }
 
 void CReporterDaemon::setDelayedStartup(int timeout)
@@ -73,6 +95,8 @@ void CReporterDaemon::setDelayedStartup(int timeout)
 
 bool CReporterDaemon::initiateDaemon()
 {
+    Q_D(CReporterDaemon);
+
     qCDebug(cr) << "Starting daemon...";
 
     if (!CReporterPrivacySettingsModel::instance()->isValid()) {
@@ -88,6 +112,9 @@ bool CReporterDaemon::initiateDaemon()
         return false;
     }
 
+    // Owning the service name makes this the only daemon updating the core index.
+    CReporterCoreRegistry::instance()->reconcileIndex();
+
     if (CReporterPrivacySettingsModel::instance()->notificationsEnabled()
             || CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()) {
         // Read from settings file, if monitor should be started.
@@ -104,11 +131,8 @@ bool CReporterDaemon::initiateDaemon()
     if (CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()) {
         QStringList files = collectAllCoreFiles();
 
-        if (!files.isEmpty() &&
-                CReporterNwSessionMgr::canUseNetworkConnection() &&
-                !CReporterUtils::shouldSavePower() &&
-                !CReporterUtils::notifyAutoUploader(files)) {
-            qCDebug(cr) << "Failed to add files to the queue.";
+        if (d->checkCanUpload() && !files.isEmpty()) {
+            CReporterUtils::notifyAutoUploader(files);
         }
     } else if (CReporterPrivacySettingsModel::instance()->notificationsEnabled()) {
         QStringList files = collectAllCoreFiles();
@@ -224,13 +248,64 @@ void CReporterDaemon::stopService()
 }
 
 CReporterDaemonPrivate::CReporterDaemonPrivate(CReporterDaemon *parent)
-    : monitor(0), timerId(0), q_ptr(parent)
+    : monitor(0), timerId(0), networkWatcher(0), canUpload(false), uploaderWatcher(0),
+      q_ptr(parent)
 {
     Q_Q(CReporterDaemon);
 
     QObject::connect(CReporterPrivacySettingsModel::instance(),
                      SIGNAL(notificationsEnabledChanged()),
                      q, SLOT(onNotificationsSettingChanged()));
+
+    networkWatcher = new CReporterNwSessionMgr(q);
+    QObject::connect(networkWatcher, SIGNAL(connectivityChanged()),
+                     q, SLOT(onConnectivityChanged()));
+#ifndef CREPORTER_UNIT_TEST
+    // Reports held back on low battery are uploaded once charging allows.
+    QObject::connect(CReporterPowerState::instance(), SIGNAL(restrictionLifted()),
+                     q, SLOT(onConnectivityChanged()));
+#endif
+
+    connectivityTimer.setSingleShot(true);
+    connectivityTimer.setInterval(ConnectivitySettleDelay);
+    QObject::connect(&connectivityTimer, SIGNAL(timeout()),
+                     q, SLOT(onConnectivitySettled()));
+
+    retryTimer.setSingleShot(true);
+    retryTimer.setTimerType(Qt::VeryCoarseTimer);
+    QObject::connect(&retryTimer, SIGNAL(timeout()), q, SLOT(onRetryDue()));
+
+    // The auto uploader exits when idle, its journal has the next retry then.
+    uploaderWatcher = new QDBusServiceWatcher(CReporter::AutoUploaderServiceName,
+            QDBusConnection::sessionBus(), QDBusServiceWatcher::WatchForUnregistration, q);
+    QObject::connect(uploaderWatcher, SIGNAL(serviceUnregistered(QString)),
+                     q, SLOT(scheduleRetry()));
+
+    scheduleRetry();
+}
+
+bool CReporterDaemonPrivate::checkCanUpload()
+{
+    canUpload = CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()
+                && CReporterNwSessionMgr::canUseNetworkConnection()
+                && !CReporterUtils::shouldSavePower();
+    return canUpload;
+}
+
+void CReporterDaemonPrivate::scheduleRetry()
+{
+    qint64 next = CReporterUploadJournal::earliestEligible(
+            CReporterUploadJournal::defaultJournalFile());
+    if (next < 0) {
+        retryTimer.stop();
+        return;
+    }
+
+    qint64 delay = qMax(next - QDateTime::currentMSecsSinceEpoch(), qint64(MinRetryDelay));
+    delay = qMin(delay, qint64(std::numeric_limits<int>::max()));
+
+    qCDebug(cr) << "Retrying uploads in" << delay / 1000 << "seconds.";
+    retryTimer.start(static_cast<int>(delay));
 }
 
 void CReporterDaemonPrivate::onNotificationsSettingChanged()
@@ -247,4 +322,44 @@ void CReporterDaemonPrivate::onNotificationsSettingChanged()
     }
 }
 
+void CReporterDaemonPrivate::onConnectivityChanged()
+{
+    // Restarting coalesces a burst of changes into a single check.
+    connectivityTimer.start();
+}
+
+void CReporterDaemonPrivate::onConnectivitySettled()
+{
+    Q_Q(CReporterDaemon);
+
+    bool couldUpload = canUpload;
+    if (!checkCanUpload() || couldUpload) {
+        // Backlog was already handed over when uploading became possible.
+        return;
+    }
+
+    QStringList files = q->collectAllCoreFiles();
+    if (files.isEmpty()) {
+        return;
+    }
+
+    qCDebug(cr) << "Usable network connection appeared, uploading"
+                << files.count() << "pending reports.";
+    // Files sent before are in the journal of the auto uploader.
+    CReporterUploadNotifier::instance()->submit(files);
+    CReporterUploadNotifier::instance()->retry();
+}
+
+void CReporterDaemonPrivate::onRetryDue()
+{
+    if (!checkCanUpload()) {
+        // Retried once uploading is possible, see onConnectivitySettled().
+        qCDebug(cr) << "Uploads are due for retry, but can't upload now.";
+        return;
+    }
+
+    qCDebug(cr) << "Asking auto uploader to retry failed uploads.";
+    CReporterUploadNotifier::instance()->retry();
+}
+
 #include "moc_creporterdaemon.cpp"
@@ -111,6 +111,10 @@ private:
     QScopedPointer<CReporterDaemonPrivate> d_ptr;
 
     Q_PRIVATE_SLOT(d_func(), void onNotificationsSettingChanged())
+    Q_PRIVATE_SLOT(d_func(), void onConnectivityChanged())
+    Q_PRIVATE_SLOT(d_func(), void onConnectivitySettled())
+    Q_PRIVATE_SLOT(d_func(), void scheduleRetry())
+    Q_PRIVATE_SLOT(d_func(), void onRetryDue())
 
 #ifdef CREPORTER_UNIT_TEST
     friend class Ut_CReporterDaemon;
@@ -25,7 +25,11 @@
 #ifndef CREPORTERDAEMON_P_H
 #define CREPORTERDAEMON_P_H
 
+#include <QTimer>
+
 class CReporterDaemonMonitor;
+class CReporterNwSessionMgr;
+class QDBusServiceWatcher;
 
 /*!
  * \class CReporterDaemonPrivate
@@ -41,8 +45,35 @@ public:
     CReporterDaemonMonitor *monitor;
     //! @arg Startup delay timer Id.
     int timerId;
+    //! @arg Source of connectivity change notifications.
+    CReporterNwSessionMgr *networkWatcher;
+    //! @arg Lets connectivity and power state settle before they are checked.
+    QTimer connectivityTimer;
+    //! @arg Result of the latest check whether uploading was allowed.
+    bool canUpload;
+    //! @arg Wakes up the auto uploader when failed uploads are due for retry.
+    QTimer retryTimer;
+    //! @arg Tells when the auto uploader exits, leaving its journal up to date.
+    QDBusServiceWatcher *uploaderWatcher;
+
+    /*!
+     * @brief Checks whether reports may be uploaded now.
+     *
+     * @return True if automatic sending is enabled, the network connection
+     * may be used and power doesn't need to be saved.
+     */
+    bool checkCanUpload();
+
+    /*!
+     * @brief Sets the retry timer to the earliest retry in the upload journal.
+     */
+    void scheduleRetry();
+
 private:
     void onNotificationsSettingChanged();
+    void onConnectivityChanged();
+    void onConnectivitySettled();
+    void onRetryDue();
 
     Q_DECLARE_PUBLIC(CReporterDaemon);
     CReporterDaemon *q_ptr;
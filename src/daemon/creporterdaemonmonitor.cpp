@@ -31,7 +31,9 @@
 #include <QStringList>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QSet>
 #include <QDBusReply>
 
 #include <notification.h>
@@ -39,8 +41,13 @@
 #include "creporterdaemonmonitor.h"
 #include "creporterdaemonmonitor_p.h"
 #include "creportercoreregistry.h"
+#include "creportercrashinfo.h"
+#include "creporterduplicatesummary.h"
 #include "creporternwsessionmgr.h"
 #include "creportersavedstate.h"
+#include "creportersignatureindex.h"
+#include "creporterstackfingerprint.h"
+#include "creporterstormdetector.h"
 #include "creporterutils.h"
 #include "creporternamespace.h"
 #include "creporterprivacysettingsmodel.h"
@@ -48,33 +55,11 @@
 
 using CReporter::LoggingCategory::cr;
 
-CReporterHandledRichCore::CReporterHandledRichCore(const QString &filePath)
-    : lastCountReset(QDateTime::currentDateTimeUtc())
-{
-    // Parse needed info for file path.
-    QStringList rCoreInfo = CReporterUtils::parseCrashInfoFromFilename(filePath);
-
-    binaryName = rCoreInfo[0];
-    signalNumber = rCoreInfo[2].toInt();
-
-    count = 0;
-
-    qCDebug(cr) << "Name:" << binaryName << ", Signal:" << signalNumber;
-}
-
-CReporterHandledRichCore::~CReporterHandledRichCore()
-{
-}
-
-bool CReporterHandledRichCore::operator==(const CReporterHandledRichCore &other) const
-{
-    return (binaryName == other.binaryName) &&
-           (signalNumber == other.signalNumber);
-}
-
-
 CReporterDaemonMonitorPrivate::CReporterDaemonMonitorPrivate()
-    : autoDeleteMaxSimilarCores(0),
+    : signatures(new CReporterSignatureIndex(CReporterSignatureIndex::defaultIndexFile(), this)),
+      duplicates(new CReporterDuplicateSummary(CReporterDuplicateSummary::defaultDirectory(), this)),
+      storm(new CReporterStormDetector(this)),
+      autoDeleteMaxSimilarCores(0),
       crashNotification(new Notification(this)),
       crashCount(0)
 {
@@ -87,14 +72,15 @@ CReporterDaemonMonitorPrivate::CReporterDaemonMonitorPrivate()
     connect(CReporterPrivacySettingsModel::instance(),
             &CReporterPrivacySettingsModel::automaticSendingEnabledChanged,
             this, &CReporterDaemonMonitorPrivate::onSetAutoUploadChanged);
+
+    connect(storm, &CReporterStormDetector::stormEnded,
+            this, &CReporterDaemonMonitorPrivate::handleStormEnded);
 }
 
 CReporterDaemonMonitorPrivate::~CReporterDaemonMonitorPrivate()
 {
     CReporterSavedState *state = CReporterSavedState::instance();
     state->setCrashNotificationId(crashNotification->replacesId());
-
-    qDeleteAll(handledRichCores);
 }
 
 void CReporterDaemonMonitorPrivate::addDirectoryWatcher()
@@ -102,22 +88,27 @@ void CReporterDaemonMonitorPrivate::addDirectoryWatcher()
     qCDebug(cr) << "Adding core directory watcher...";
 
     // Subscribe to receive signals for changed directories.
-    connect(&watcher, SIGNAL(directoryChanged(const QString &)),
-            this, SLOT(handleDirectoryChanged(const QString &)));
+    connect(&watcher, SIGNAL(coreFilesAdded(QStringList)),
+            this, SLOT(handleCoreFilesAdded(QStringList)), Qt::UniqueConnection);
+    connect(&watcher, SIGNAL(coreFilesRemoved(QStringList)),
+            this, SLOT(handleCoreFilesRemoved(QStringList)), Qt::UniqueConnection);
+    connect(&watcher, SIGNAL(directoryRemoved(QString)),
+            this, SLOT(handleDirectoryRemoved(QString)), Qt::UniqueConnection);
+    connect(&watcher, SIGNAL(overflowed()),
+            this, SLOT(rescanDirectories()), Qt::UniqueConnection);
 
     CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
 
     // Subscribe to receive signals for changes in core registry.
     connect(registry, SIGNAL(coreLocationsUpdated()),
-            this, SLOT(addDirectoryWatcher()));
+            this, SLOT(addDirectoryWatcher()), Qt::UniqueConnection);
 
     QStringList corePaths(registry->getCoreLocationPaths());
 
     if (!corePaths.isEmpty()) {
-        registry->refreshRegistry();
-        // Add monitored directories to QFileSystemWatcher. Paths are not added
-        // if they do not exist, or if they are already being monitored by the file system watcher.
+        // Paths that are already being monitored are skipped.
         watcher.addPaths(corePaths);
+        registry->refreshRegistry();
     }
 }
 
@@ -129,118 +120,211 @@ void CReporterDaemonMonitorPrivate::removeDirectoryWatcher()
     watcher.removePaths(watcher.directories());
 }
 
-void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
+void CReporterDaemonMonitorPrivate::handleCoreFilesAdded(const QStringList &filePaths)
 {
-    qCDebug(cr) << "Directory:" << path << "has changed.";
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    QStringList upload;
+
+    foreach (const QString &filePath, filePaths) {
+        if (registry->registerCoreFile(filePath)) {
+            // New core found.
+            qCDebug(cr) << "New rich-core file found: " << filePath;
+            if (handleNewCore(filePath)) {
+                upload << filePath;
+            }
+        }
+    }
 
-    QDir changedDir(path);
-    // QFileSystemWatcher will send signal if monitored directory was removed.
-    if (!changedDir.exists()) {
-        /* Re-add core dirs when the parent dir changes, so that monitoring is
-         * resumed after USB mass storage mode has been disconnected */
-        if (changedDir.cd("../..")) {
-            connect(&parentDirWatcher, SIGNAL(directoryChanged(QString)),
-                    SLOT(handleParentDirectoryChanged()));
-            parentDirWatcher.addPath(changedDir.absolutePath());
-            qCDebug(cr) << "Directory was deleted. Started parent dir monitoring.";
-        } else {
-            qCDebug(cr) << "Directory was deleted. Parent dir does not exist.";
+    if (!upload.isEmpty()) {
+        requestUpload(upload);
+    }
+}
+
+void CReporterDaemonMonitorPrivate::rescanDirectories()
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    QSet<QString> known(registry->collectAllCoreFiles().toSet());
+
+    // Removed files are dropped from the registry by the refresh.
+    foreach (const QString &path, watcher.directories()) {
+        registry->refreshDirectory(path);
+    }
+
+    QStringList upload;
+    foreach (const QString &filePath, registry->collectAllCoreFiles()) {
+        if (!known.contains(filePath)) {
+            qCDebug(cr) << "Missed rich-core file found: " << filePath;
+            if (handleNewCore(filePath)) {
+                upload << filePath;
+            }
         }
+    }
 
-        return;
+    if (!upload.isEmpty()) {
+        requestUpload(upload);
     }
+}
 
-    qCDebug(cr) << "Changed directory exists.";
+void CReporterDaemonMonitorPrivate::requestUpload(const QStringList &filePaths)
+{
+    if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
+        qCDebug(cr) << "WiFi not available, not uploading now.";
+    } else if (CReporterUtils::shouldSavePower()) {
+        qCDebug(cr) << "On low battery, not uploading now.";
+    } else {
+        /* Reports that couldn't be sent earlier are uploaded when the
+         * daemon sees the connection or the battery state improve. */
+        CReporterUtils::notifyAutoUploader(filePaths);
+    }
+}
 
+void CReporterDaemonMonitorPrivate::handleCoreFilesRemoved(const QStringList &filePaths)
+{
     CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
 
-    // Check for new cores in changed directory.
-    QString filePath = registry->checkDirectoryForCores(path);
-
-    if (filePath.isEmpty()) {
-        return;
+    foreach (const QString &filePath, filePaths) {
+        registry->unregisterCoreFile(filePath);
     }
+}
+
+void CReporterDaemonMonitorPrivate::handleDirectoryRemoved(const QString &path)
+{
+    QDir changedDir(path);
 
-    // New core found.
-    qCDebug(cr) << "New rich-core file found: " << filePath;
+    /* Re-add core dirs when the parent dir changes, so that monitoring is
+     * resumed after USB mass storage mode has been disconnected */
+    if (changedDir.cd("../..")) {
+        connect(&parentDirWatcher, SIGNAL(directoryChanged(QString)),
+                SLOT(handleParentDirectoryChanged()), Qt::UniqueConnection);
+        parentDirWatcher.addPath(changedDir.absolutePath());
+        qCDebug(cr) << "Directory was deleted. Started parent dir monitoring.";
+    } else {
+        qCDebug(cr) << "Directory was deleted. Parent dir does not exist.";
+    }
+}
 
-    QStringList details = CReporterUtils::parseCrashInfoFromFilename(filePath);
-    bool isUserTerminated = (details[2].toInt() == SIGQUIT);
-    QString appName = details[0];
+bool CReporterDaemonMonitorPrivate::handleNewCore(const QString &filePath)
+{
+    CReporterCrashInfo info = CReporterCrashInfo::fromFileName(filePath);
+    bool isUserTerminated = (info.signalNumber() == SIGQUIT);
+    QString appName = info.applicationName();
 
     emit q_ptr->richCoreNotify(filePath);
 
-    CReporterPrivacySettingsModel &settings =
-        *CReporterPrivacySettingsModel::instance();
+    /* While an application is crash-looping, its reports are notified and
+     * uploaded together when the storm is over. Duplicates among them are
+     * removed only then, so that reading their stack traces doesn't keep
+     * the daemon busy during the storm. */
+    if (info.includesCrash() && !storm->admit(appName)) {
+        qCDebug(cr) << "Crash storm, deferring" << filePath;
+        stormDeferred << filePath;
+        return false;
+    }
 
-    /* Check for duplicates if auto-deleting is enabled. If Maximum number
-     * of duplicates is exceeded, delete the file. */
-    if (!isUserTerminated && settings.autoDeleteDuplicates() &&
-            checkForDuplicates(filePath)) {
-        if (settings.notificationsEnabled()) {
-            Notification notification;
-            CReporterUtils::applyNotificationStyle(&notification);
-            notification.setIsTransient(true);
-            //% "%1 has crashed again."
-            notification.setSummary(qtTrId("crash_reporter-notify-crashed_again").arg(appName));
-            //% "Duplicate crash report was deleted."
-            notification.setBody(qtTrId("crash_reporter-notify-duplicate_deleted"));
-            notification.publish();
-        }
-        CReporterUtils::removeFile(filePath);
-        return;
+    if (removeDuplicate(filePath, true)) {
+        return false;
     }
 
+    CReporterPrivacySettingsModel &settings =
+        *CReporterPrivacySettingsModel::instance();
+
     if (!settings.automaticSendingEnabled()) {
         /* TODO: Here multiple-choice notification should be displayed
          * with options to send or delete the crash report. So far
          * disabling auto upload is not possible in the UI and we never
          * get here. Standard Sailfish notifications don't support multiple
          * actions so far. */
-    } else {
-        if (settings.notificationsEnabled()) {
-
-            QString body;
-            QString summary;
-
-            if (filePath.contains(CReporter::QuickFeedbackPrefix)) {
-                //% "New feedback message is ready."
-                summary = qtTrId("crash_reporter-notify-quickie_ready");
-            } else if (filePath.contains(CReporter::EndurancePackagePrefix)) {
-                //% "New endurance report is ready."
-                summary = qtTrId("crash_reporter-notify-endurance_ready");
-            } else if (filePath.contains(CReporter::PowerExcessPrefix)) {
-                //% "Power excess detected."
-                summary = qtTrId("crash_reporter-notify-power_excess_detected");
-            } else if (isUserTerminated) {
-                //% "%1 was terminated."
-                summary = qtTrId("crash_reporter-notify-app_terminated").arg(appName);
-            } else {
-                if (++crashCount > 1) {
-                    //% "%n crashes total"
-                    body = qtTrId("crash_reporter-notify-total_crashes", crashCount);
-                }
-                //% "%1 has crashed."
-                summary = qtTrId("crash_reporter-notify-app_crashed").arg(appName);
-            }
+        return false;
+    }
 
-            crashNotification->setSummary(summary);
-            crashNotification->setBody(body);
-            crashNotification->setItemCount(crashCount);
-            crashNotification->publish();
-        }
-        if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
-            qCDebug(cr) << "WiFi not available, not uploading now.";
-        } else if (CReporterUtils::shouldSavePower()) {
-            qCDebug(cr) << "On low battery, not uploading now.";
+    // Summaries of duplicates are sent quietly.
+    if (info.type() == CReporterCrashInfo::DuplicateSummary) {
+        return true;
+    }
+
+    if (settings.notificationsEnabled()) {
+
+        QString body;
+        QString summary;
+
+        if (info.type() == CReporterCrashInfo::QuickFeedback) {
+            //% "New feedback message is ready."
+            summary = qtTrId("crash_reporter-notify-quickie_ready");
+        } else if (info.type() == CReporterCrashInfo::Endurance) {
+            //% "New endurance report is ready."
+            summary = qtTrId("crash_reporter-notify-endurance_ready");
+        } else if (info.type() == CReporterCrashInfo::PowerExcess) {
+            //% "Power excess detected."
+            summary = qtTrId("crash_reporter-notify-power_excess_detected");
+        } else if (isUserTerminated) {
+            //% "%1 was terminated."
+            summary = qtTrId("crash_reporter-notify-app_terminated").arg(appName);
         } else {
-            /* In auto-upload mode try to upload all crash reports each
-             * time a new one appears. */
-            if (!CReporterUtils::notifyAutoUploader(registry->collectAllCoreFiles())) {
-                qCWarning(cr) << "Failed to start Auto Uploader.";
+            if (++crashCount > 1) {
+                //% "%n crashes total"
+                body = qtTrId("crash_reporter-notify-total_crashes", crashCount);
             }
+            //% "%1 has crashed."
+            summary = qtTrId("crash_reporter-notify-app_crashed").arg(appName);
+        }
+
+        crashNotification->setSummary(summary);
+        crashNotification->setBody(body);
+        crashNotification->setItemCount(crashCount);
+        crashNotification->publish();
+    }
+
+    return true;
+}
+
+bool CReporterDaemonMonitorPrivate::removeDuplicate(const QString &filePath, bool notify)
+{
+    CReporterCrashInfo info = CReporterCrashInfo::fromFileName(filePath);
+    CReporterPrivacySettingsModel &settings =
+        *CReporterPrivacySettingsModel::instance();
+
+    /* Check for duplicates if auto-deleting or aggregating is enabled. If
+     * maximum number of duplicates is exceeded, delete the file, keeping
+     * only a record of the crash when aggregating. If the record can't be
+     * written, the file is only deleted when auto-deleting. */
+    quint64 signature = 0;
+    bool duplicate = info.signalNumber() != SIGQUIT
+            && (settings.autoDeleteDuplicates() || settings.aggregateDuplicates())
+            && checkForDuplicates(filePath, &signature);
+    if (!duplicate) {
+        return false;
+    }
+
+    bool aggregated = settings.aggregateDuplicates()
+            && duplicates->record(signature, filePath);
+
+    if (!aggregated && !settings.autoDeleteDuplicates()) {
+        qCWarning(cr) << "Couldn't aggregate duplicate, keeping" << filePath;
+        return false;
+    }
+
+    if (!CReporterUtils::removeFile(filePath)) {
+        qCWarning(cr) << "Couldn't remove duplicate" << filePath;
+    }
+
+    if (notify && settings.notificationsEnabled()) {
+        Notification notification;
+        CReporterUtils::applyNotificationStyle(&notification);
+        notification.setIsTransient(true);
+        //% "%1 has crashed again."
+        notification.setSummary(qtTrId("crash_reporter-notify-crashed_again")
+                                .arg(info.applicationName()));
+        if (aggregated) {
+            //% "Crash was added to the summary of duplicates."
+            notification.setBody(qtTrId("crash_reporter-notify-duplicate_aggregated"));
+        } else {
+            //% "Duplicate crash report was deleted."
+            notification.setBody(qtTrId("crash_reporter-notify-duplicate_deleted"));
         }
+        notification.publish();
     }
+
+    return true;
 }
 
 void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
@@ -253,10 +337,9 @@ void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
     int numWatchPaths = watcher.directories().count();
 
     if (!corePaths.isEmpty()) {
-        registry->refreshRegistry();
-        // Add monitored directories to QFileSystemWatcher. Paths are not added
-        // if they do not exist, or if they are already being monitored by the file system watcher.
+        // Paths that are already being monitored are skipped.
         watcher.addPaths(corePaths);
+        registry->refreshRegistry();
     }
 
     if (watcher.directories().count() > numWatchPaths) {
@@ -266,54 +349,37 @@ void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
     }
 }
 
-bool CReporterDaemonMonitorPrivate::checkForDuplicates(const QString &path)
+bool CReporterDaemonMonitorPrivate::checkForDuplicates(const QString &path, quint64 *signature)
 {
+    CReporterCrashInfo info = CReporterCrashInfo::fromFileName(path);
+
     // Ignore reports that don't contain core dumps.
-    if (!CReporterUtils::reportIncludesCrash(path)) {
+    if (!info.includesCrash()) {
         return false;
     }
 
-    qCDebug(cr) << "Checking, if" << path << "has been handled for"
-                << autoDeleteMaxSimilarCores << "times.";
-
-    // Create new entry.
-    CReporterHandledRichCore *rCore = new CReporterHandledRichCore(path);
-
-    foreach (CReporterHandledRichCore *handled, handledRichCores) {
-        // Loop through list to find duplicates.
-        qCDebug(cr) << "Compare to:"
-                    << "Name:" << handled->binaryName << ", Signal:" << handled->signalNumber;
-
-        if (*handled == *rCore) {
-            /* Check if more than a day has passed from last duplicate counter
-             * reset. */
-            QDateTime now(QDateTime::currentDateTimeUtc());
-            if (handled->lastCountReset.addDays(1) < now) {
-                qCDebug(cr) << "More than a day has passed, resetting duplicate counter";
-                handled->count = 0;
-                handled->lastCountReset = now;
-            }
-
-            handled->count++;
-            // Duplicate found. Increment counter.
-            qCDebug(cr) << "Matches. Count is now:" << handled->count;
-
-            if (handled->count > autoDeleteMaxSimilarCores) {
-                // Maximum exeeded.
-                qCDebug(cr) << "Maximum number of duplicates exceeded.";
-                delete rCore;
-                return true;
-            }
-            // Maximum not yet exeeded.
-            delete rCore;
-            return false;
-        }
+    QByteArray fingerprint;
+    bool symbolized = false;
+    if (CReporterPrivacySettingsModel::instance()->includeStackTrace()) {
+        fingerprint = CReporterStackFingerprint::fromFile(
+                path, CReporterStackFingerprint::DefaultFrameCount, &symbolized);
     }
-    // Not found. Add to handled list.
-    rCore->count++;
-    handledRichCores << rCore;
 
-    return false;
+    /* A symbolized stack trace tells crashes apart better than the binary
+     * name, which differs between launchers and wrappers of the same code.
+     * Unresolved frames only name their libraries, so without the binary
+     * name unrelated applications crashing in the same library would be
+     * counted as duplicates of each other. */
+    *signature = CReporterSignatureIndex::signature(
+            symbolized ? QString() : info.applicationName(), info.signalNumber(), fingerprint);
+    int count = signatures->record(*signature);
+
+    qCDebug(cr) << "Name:" << info.applicationName() << ", Signal:" << info.signalNumber()
+                << ", Stack:" << fingerprint.left(4).toHex()
+                << "handled" << count << "times within a day, maximum is"
+                << autoDeleteMaxSimilarCores;
+
+    return count > autoDeleteMaxSimilarCores;
 }
 
 void CReporterDaemonMonitorPrivate::resetCrashCount()
@@ -322,6 +388,49 @@ void CReporterDaemonMonitorPrivate::resetCrashCount()
     qCDebug(cr) << "Crash counter was reset.";
 }
 
+void CReporterDaemonMonitorPrivate::handleStormEnded(const QMap<QString, int> &suppressed,
+                                                     qint64 duration)
+{
+    QString mostFrequent;
+    for (QMap<QString, int>::const_iterator it = suppressed.constBegin();
+            it != suppressed.constEnd(); ++it) {
+        if (mostFrequent.isEmpty() || it.value() > suppressed.value(mostFrequent)) {
+            mostFrequent = it.key();
+        }
+    }
+
+    // Deferred reports weren't checked for duplicates yet.
+    QStringList reports;
+    foreach (const QString &filePath, stormDeferred) {
+        if (QFile::exists(filePath) && !removeDuplicate(filePath, false)) {
+            reports << filePath;
+        }
+    }
+    stormDeferred.clear();
+
+    qCDebug(cr) << "Crash storm of" << duration / 1000 << "s is over," << reports.count()
+                << "reports were kept, suppressed:" << suppressed;
+
+    CReporterPrivacySettingsModel &settings = *CReporterPrivacySettingsModel::instance();
+
+    if (settings.notificationsEnabled()) {
+        Notification notification;
+        CReporterUtils::applyNotificationStyle(&notification);
+        //% "%1 crashed repeatedly."
+        notification.setSummary(qtTrId("crash_reporter-notify-crash_storm").arg(mostFrequent));
+        if (!reports.isEmpty()) {
+            //% "%n more crash reports were collected."
+            notification.setBody(qtTrId("crash_reporter-notify-crash_storm_reports",
+                                        reports.count()));
+        }
+        notification.publish();
+    }
+
+    if (settings.automaticSendingEnabled() && !reports.isEmpty()) {
+        requestUpload(reports);
+    }
+}
+
 void CReporterDaemonMonitorPrivate::onSetAutoUploadChanged()
 {
     if (CReporterPrivacySettingsModel::instance()->automaticSendingEnabled()) {
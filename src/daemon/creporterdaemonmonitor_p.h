@@ -25,47 +25,18 @@
 #ifndef CREPORTERDAEMONMONITOR_P_H
 #define CREPORTERDAEMONMONITOR_P_H
 
-#include <QDateTime>
 #include <QFileSystemWatcher>
+#include <QMap>
+#include <QStringList>
+
+#include "creportercorewatcher.h"
 
 class CReporterDaemonMonitor;
+class CReporterDuplicateSummary;
+class CReporterSignatureIndex;
+class CReporterStormDetector;
 class Notification;
 
-/*!
-  * @class CReporterHandledRichCore
-  * @brief This class represent handled rich-core file.
-  *
-  */
-class CReporterHandledRichCore
-{
-public:
-    /*!
-      * @brief Class constructor.
-      *
-      * @param filePath Rich-core file path.
-      */
-    CReporterHandledRichCore(const QString &filePath);
-
-    ~CReporterHandledRichCore();
-
-    /*!
-      * @brief Returns true, if @a other has similar information than this object.
-      *
-      * @param other CReporterHandledRichCore object.
-      */
-    bool operator==(const CReporterHandledRichCore &other) const;
-
-public:
-    //! @arg Binary file name of the application.
-    QString binaryName;
-    //! @arg Signal number (SIGNUM).
-    int signalNumber;
-    //! @arg Upper file size limit.
-    int count;
-    //! @arg When duplicate counter was last set to zero.
-    QDateTime lastCountReset;
-};
-
 /*!
  * @class CReporterDaemonMonitorPrivate
  * @brief Private CReporterDaemonMonitor class.
@@ -83,25 +54,41 @@ public:
 public Q_SLOTS:
     /*!
      * @brief Adds the "\core-dumps" -directory paths currently present in the file system.
-     *     to the QFileSystemWatcher.
-     *
-     * @sa http://doc.trolltech.com/4.6/qfilesystemwatcher.html.
+     *     to the CReporterCoreWatcher.
      */
     void addDirectoryWatcher();
 
     /*!
-     * @brief Removes monitored directories from the QFileSystemWatcher.
-     *
-     * @sa http://doc.trolltech.com/4.6/qfilesystemwatcher.html.
+     * @brief Removes monitored directories from the CReporterCoreWatcher.
      */
     void removeDirectoryWatcher();
 
     /*!
-     * @brief Called when directoryChanged signal is received.
+     * @brief Called when new core files appear in the monitored directories.
+     *
+     * @param filePaths Paths of the new files.
+     */
+    void handleCoreFilesAdded(const QStringList &filePaths);
+
+    /*!
+     * @brief Called when core files are removed from the monitored directories.
+     *
+     * @param filePaths Paths of the removed files.
+     */
+    void handleCoreFilesRemoved(const QStringList &filePaths);
+
+    /*!
+     * @brief Called when a monitored directory is deleted.
      *
-     * @param Reference to changed directory.
+     * @param path Path of the deleted directory.
+     */
+    void handleDirectoryRemoved(const QString &path);
+
+    /*!
+     * @brief Rescans the monitored directories after file system events
+     *     were lost, handling the core files that were missed.
      */
-    void handleDirectoryChanged(const QString &path);
+    void rescanDirectories();
 
     /*!
      * @brief Re-enables monitoring of core-dump dir when USB mass storage has been disabled and MyDocs is back in use
@@ -114,13 +101,28 @@ public Q_SLOTS:
      */
     void resetCrashCount();
 
+    /**
+     * Removes duplicates of the crash reports received during a crash
+     * storm, publishes a summary of the rest and uploads them.
+     *
+     * @param suppressed Number of reports by application.
+     * @param duration Length of the storm in ms.
+     */
+    void handleStormEnded(const QMap<QString, int> &suppressed, qint64 duration);
+
 public:
     //! @arg For monitoring directories.
-    QFileSystemWatcher watcher;
+    CReporterCoreWatcher watcher;
     //! @arg Watcher for monitoring the return of an unmounted directory for when core-dumps dir has disappeared because of USB mass storage mode
     QFileSystemWatcher parentDirWatcher;
-    //! @arg List of handled rich-cores.
-    QList <CReporterHandledRichCore *> handledRichCores;
+    //! @arg Recent crash counts by crash signature.
+    CReporterSignatureIndex *signatures;
+    //! @arg Records of duplicate crashes that were not kept.
+    CReporterDuplicateSummary *duplicates;
+    //! @arg Throttles handling of crash-looping applications.
+    CReporterStormDetector *storm;
+    //! @arg Reports held back during a crash storm, uploaded when it ends.
+    QStringList stormDeferred;
     //! @arg Number of similar cores to keep when auto-delete is enabled
     int autoDeleteMaxSimilarCores;
 
@@ -138,15 +140,48 @@ private:
     int crashCount;
 
     /**
-     * Checks whether 'similar' rich core was already handled.
+     * Processes a single new rich core.
+     *
+     * @param filePath File path of the rich core.
+     * @return @c true if the report should be uploaded.
+     */
+    bool handleNewCore(const QString &filePath);
+
+    /**
+     * Checks whether 'similar' rich core was already handled too many times
+     * within the last day. Similar cores have the same binary name and
+     * signal number, or the same stack trace.
      *
      * @param path File path of rich core to check.
+     * @param signature Receives the crash signature of the core.
      * @return @c true if duplicate was found, otherwise @c false.
      */
-    bool checkForDuplicates(const QString &path);
+    bool checkForDuplicates(const QString &path, quint64 *signature);
+
+    /**
+     * Removes a rich core that duplicates too many recent ones, recording
+     * it into the summary of duplicates when aggregating.
+     *
+     * @param filePath File path of the rich core.
+     * @param notify Tell the user about the removed duplicate.
+     * @return @c true if the rich core was removed.
+     */
+    bool removeDuplicate(const QString &filePath, bool notify);
+
+    /**
+     * Asks autouploader to send new reports if the connection and battery
+     * allow it.
+     *
+     * @param filePaths Paths of the new reports.
+     */
+    void requestUpload(const QStringList &filePaths);
 
 private slots:
     void onSetAutoUploadChanged();
+
+#ifdef CREPORTER_UNIT_TEST
+    friend class Ut_CReporterDaemonMonitor;
+#endif
 };
 
 #endif // CREPORTERDAEMONMONITOR_P_H
@@ -0,0 +1,418 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <lzma.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "endurancepacker.h"
+#include "creporterlzoreader.h"
+#include "creporterlzowriter.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const QString SnapshotPackSection("endurance-snapshot-pack.tar.xz");
+const QString LzoSuffix(".lzo");
+
+// Same as xz -0, which needs a few MiB of memory per thread.
+const uint32_t XzPreset = 0;
+
+const int TarBlockSize = 512;
+const int ChunkSize = 64 * 1024;
+
+// Octal fields of a ustar header can't describe larger files.
+const qint64 MaxTarFileSize = Q_INT64_C(077777777777);
+
+void setField(char *header, int offset, int size, const QByteArray &value)
+{
+    memcpy(header + offset, value.constData(), qMin(size, value.size()));
+}
+
+void setOctal(char *header, int offset, int size, qint64 value)
+{
+    // Zero padded, terminated by NUL like GNU tar does.
+    setField(header, offset, size - 1,
+             QByteArray::number(value, 8).rightJustified(size - 1, '0'));
+}
+
+/*
+ * Returns a ustar header of a regular file, or empty array if the file
+ * can't be stat()ed or its name doesn't fit into the header.
+ */
+QByteArray ustarHeader(const QString &name, const QFileInfo &info, qint64 size)
+{
+    struct stat st;
+    if (stat(QFile::encodeName(info.filePath()).constData(), &st) != 0) {
+        return QByteArray();
+    }
+
+    QByteArray path(QFile::encodeName(name));
+    QByteArray prefix;
+
+    if (path.size() > 100) {
+        // Longer names are split at a slash into the prefix field.
+        int split = path.lastIndexOf('/', 155);
+        if (split <= 0 || path.size() - split - 1 > 100) {
+            return QByteArray();
+        }
+        prefix = path.left(split);
+        path = path.mid(split + 1);
+    }
+
+    QByteArray header(TarBlockSize, '\0');
+    char *data = header.data();
+
+    setField(data, 0, 100, path);
+    setOctal(data, 100, 8, st.st_mode & 07777);
+    setOctal(data, 108, 8, st.st_uid);
+    setOctal(data, 116, 8, st.st_gid);
+    setOctal(data, 124, 12, size);
+    setOctal(data, 136, 12, st.st_mtime);
+    data[156] = '0';
+    setField(data, 257, 6, QByteArray("ustar", 6));
+    setField(data, 263, 2, "00");
+    setField(data, 265, 32, info.owner().toUtf8());
+    setField(data, 297, 32, info.group().toUtf8());
+    setField(data, 345, 155, prefix);
+
+    // Checksum is calculated with the field itself filled with spaces.
+    memset(data + 148, ' ', 8);
+    unsigned int checksum = 0;
+    for (int i = 0; i < TarBlockSize; ++i) {
+        checksum += static_cast<unsigned char>(data[i]);
+    }
+    setField(data, 148, 7, QByteArray::number(checksum, 8).rightJustified(6, '0') + '\0');
+
+    return header;
+}
+} // namespace
+
+class EndurancePackerPrivate
+{
+public:
+    EndurancePackerPrivate();
+    ~EndurancePackerPrivate();
+
+    bool initEncoder();
+    bool compress(const char *data, size_t size, lzma_action action);
+    bool writeTar(const QByteArray &data);
+    bool writeZeros(qint64 count);
+    bool addDirectory(const QDir &root, const QString &directory);
+    bool addFile(const QDir &root, const QFileInfo &info);
+    bool setError(const QString &message);
+
+    QString filePath;
+    QString tmpPath;
+    QScopedPointer<CReporterLzoWriter> writer;
+    lzma_stream xz;
+    QByteArray xzBuffer;
+    int maxThreads;
+    bool finished;
+    QString error;
+};
+
+EndurancePackerPrivate::EndurancePackerPrivate()
+    : maxThreads(1), finished(false)
+{
+    lzma_stream init = LZMA_STREAM_INIT;
+    xz = init;
+}
+
+EndurancePackerPrivate::~EndurancePackerPrivate()
+{
+    lzma_end(&xz);
+}
+
+bool EndurancePackerPrivate::setError(const QString &message)
+{
+    error = message;
+    return false;
+}
+
+bool EndurancePackerPrivate::initEncoder()
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = qBound(1L, cpus, long(maxThreads));
+
+    lzma_ret result;
+    if (threads == 1) {
+        result = lzma_easy_encoder(&xz, XzPreset, LZMA_CHECK_CRC64);
+    } else {
+        /* The input is split into independently compressed xz blocks, so
+         * that the work can be divided between the threads. */
+        lzma_mt options;
+        memset(&options, 0, sizeof(options));
+        options.threads = threads;
+        options.preset = XzPreset;
+        options.check = LZMA_CHECK_CRC64;
+        result = lzma_stream_encoder_mt(&xz, &options);
+    }
+
+    if (result != LZMA_OK) {
+        return setError(QString("Initializing xz compression failed (%1)").arg(result));
+    }
+
+    qCDebug(cr) << "Compressing snapshots with" << threads << "threads";
+    return true;
+}
+
+bool EndurancePackerPrivate::compress(const char *data, size_t size, lzma_action action)
+{
+    xz.next_in = reinterpret_cast<const uint8_t *>(data);
+    xz.avail_in = size;
+
+    forever {
+        xz.next_out = reinterpret_cast<uint8_t *>(xzBuffer.data());
+        xz.avail_out = xzBuffer.size();
+
+        lzma_ret result = lzma_code(&xz, action);
+
+        int length = xzBuffer.size() - xz.avail_out;
+        if (length > 0 && !writer->write(QByteArray::fromRawData(xzBuffer.constData(), length))) {
+            return setError(writer->errorString());
+        }
+
+        if (result == LZMA_STREAM_END) {
+            return true;
+        }
+        if (result != LZMA_OK) {
+            return setError(QString("xz compression failed (%1)").arg(result));
+        }
+        if (action == LZMA_RUN && xz.avail_in == 0) {
+            return true;
+        }
+    }
+}
+
+bool EndurancePackerPrivate::writeTar(const QByteArray &data)
+{
+    return compress(data.constData(), data.size(), LZMA_RUN);
+}
+
+bool EndurancePackerPrivate::writeZeros(qint64 count)
+{
+    static const QByteArray zeros(ChunkSize, '\0');
+
+    for (; count > 0; count -= ChunkSize) {
+        if (!compress(zeros.constData(), qMin<qint64>(count, ChunkSize), LZMA_RUN)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EndurancePackerPrivate::addDirectory(const QDir &root, const QString &directory)
+{
+    // Hidden files are skipped as by the shell glob used before, special files and links too.
+    QFileInfoList entries(QDir(directory).entryInfoList(QDir::Dirs | QDir::Files | QDir::NoSymLinks
+                                                       | QDir::NoDotAndDotDot, QDir::Name));
+    foreach (const QFileInfo &entry, entries) {
+        bool ok = entry.isDir() ? addDirectory(root, entry.filePath()) : addFile(root, entry);
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EndurancePackerPrivate::addFile(const QDir &root, const QFileInfo &info)
+{
+    QString name(root.relativeFilePath(info.filePath()));
+    qint64 size = info.size();
+
+    bool lzo = name.endsWith(LzoSuffix);
+    if (lzo) {
+        size = CReporterLzoReader::decompressedSize(info.filePath());
+        if (size < 0) {
+            qCWarning(cr) << "Can't decompress" << info.filePath() << ", storing it as is";
+            lzo = false;
+            size = info.size();
+        } else {
+            name.chop(LzoSuffix.size());
+        }
+    }
+
+    QByteArray header;
+    if (size <= MaxTarFileSize) {
+        header = ustarHeader(name, info, size);
+    }
+    if (header.isEmpty()) {
+        qCWarning(cr) << "Can't archive" << info.filePath();
+        return true;
+    }
+
+    if (!writeTar(header)) {
+        return false;
+    }
+
+    qint64 written = 0;
+    if (lzo) {
+        CReporterLzoReader reader(info.filePath());
+        QByteArray block;
+        if (reader.open()) {
+            while (written < size && reader.readBlock(&block)) {
+                block.truncate(qMin<qint64>(block.size(), size - written));
+                if (!writeTar(block)) {
+                    return false;
+                }
+                written += block.size();
+                block.clear();
+            }
+        }
+    } else {
+        QFile file(info.filePath());
+        if (file.open(QIODevice::ReadOnly)) {
+            while (written < size) {
+                QByteArray chunk(file.read(qMin<qint64>(ChunkSize, size - written)));
+                if (chunk.isEmpty()) {
+                    break;
+                }
+                if (!writeTar(chunk)) {
+                    return false;
+                }
+                written += chunk.size();
+            }
+        }
+    }
+
+    if (written < size) {
+        // The header promised more, keep the archive readable.
+        qCWarning(cr) << "Couldn't read all of" << info.filePath();
+        if (!writeZeros(size - written)) {
+            return false;
+        }
+    }
+
+    return writeZeros((TarBlockSize - size % TarBlockSize) % TarBlockSize);
+}
+
+EndurancePacker::EndurancePacker(const QString &filePath)
+    : d_ptr(new EndurancePackerPrivate)
+{
+    Q_D(EndurancePacker);
+
+    QFileInfo info(filePath);
+    d->filePath = info.absoluteFilePath();
+    // Hidden files are ignored by the crash reporter daemon until renamed.
+    d->tmpPath = info.absolutePath() + "/." + info.fileName();
+}
+
+EndurancePacker::~EndurancePacker()
+{
+    Q_D(EndurancePacker);
+
+    if (!d->finished) {
+        d->writer.reset();
+        QFile::remove(d->tmpPath);
+    }
+}
+
+bool EndurancePacker::open()
+{
+    Q_D(EndurancePacker);
+
+    QFile::remove(d->tmpPath);
+    d->writer.reset(new CReporterLzoWriter(d->tmpPath));
+    if (!d->writer->open()) {
+        return d->setError(d->writer->errorString());
+    }
+    return true;
+}
+
+void EndurancePacker::setMaxThreads(int count)
+{
+    Q_D(EndurancePacker);
+
+    d->maxThreads = qMax(1, count);
+}
+
+bool EndurancePacker::addSection(const QString &name, const QByteArray &contents)
+{
+    Q_D(EndurancePacker);
+
+    if (!d->writer || !d->writer->write(QString("\n[---rich-core: %1---]\n").arg(name).toUtf8())
+            || !d->writer->write(contents)) {
+        return d->setError(d->writer ? d->writer->errorString() : QString("Not open"));
+    }
+    return true;
+}
+
+bool EndurancePacker::addSnapshotPack(const QString &directory)
+{
+    Q_D(EndurancePacker);
+
+    if (!addSection(SnapshotPackSection, QByteArray())) {
+        return false;
+    }
+
+    if (!d->initEncoder()) {
+        return false;
+    }
+    d->xzBuffer.resize(ChunkSize);
+    // LZO can't shrink xz output, don't waste time trying.
+    d->writer->setStored(true);
+
+    QDir root(directory);
+    QFileInfoList snapshots(root.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name));
+    foreach (const QFileInfo &snapshot, snapshots) {
+        if (!d->addDirectory(root, snapshot.filePath())) {
+            return false;
+        }
+    }
+
+    // End of archive marker.
+    if (!d->writeZeros(2 * TarBlockSize)) {
+        return false;
+    }
+
+    return d->compress(0, 0, LZMA_FINISH);
+}
+
+bool EndurancePacker::finish()
+{
+    Q_D(EndurancePacker);
+
+    if (!d->writer || !d->writer->finish()) {
+        return d->setError(d->writer ? d->writer->errorString() : QString("Not open"));
+    }
+
+    QFile::remove(d->filePath);
+    if (!QFile::rename(d->tmpPath, d->filePath)) {
+        return d->setError(QString("Can't rename %1 to %2").arg(d->tmpPath).arg(d->filePath));
+    }
+
+    d->finished = true;
+    return true;
+}
+
+QString EndurancePacker::errorString() const
+{
+    Q_D(const EndurancePacker);
+
+    return d->error;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef ENDURANCEPACKER_H
+#define ENDURANCEPACKER_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+class EndurancePackerPrivate;
+
+/*!
+ * @class EndurancePacker
+ * @brief Writes endurance snapshots into an Endurance rich core report.
+ *
+ * The report has the same sections as the one earlier assembled by the
+ * endurance-collect script with tar, xz and lzop. Snapshot files are
+ * streamed through a ustar writer, xz and lzop compression in a single
+ * pass, without temporary files and with bounded memory use.
+ */
+class EndurancePacker
+{
+public:
+    /*!
+     * @param filePath Path of the report to create. The report is written
+     * under a hidden name and renamed by finish().
+     */
+    explicit EndurancePacker(const QString &filePath);
+    ~EndurancePacker();
+
+    bool open();
+
+    /*!
+     * @brief Sets the maximum number of xz compression threads.
+     *
+     * One thread per online CPU is used, at most @a count. Defaults to 1.
+     */
+    void setMaxThreads(int count);
+
+    /*!
+     * @brief Adds a rich core section with @a contents.
+     */
+    bool addSection(const QString &name, const QByteArray &contents);
+
+    /*!
+     * @brief Adds the endurance-snapshot-pack.tar.xz section.
+     *
+     * All files under the snapshot subdirectories of @a directory are
+     * archived with names relative to it. lzop compressed files are
+     * stored decompressed, without the .lzo suffix. This must be the last
+     * section of the report.
+     */
+    bool addSnapshotPack(const QString &directory);
+
+    /*!
+     * @brief Completes the report and gives it the final name.
+     */
+    bool finish();
+
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(EndurancePacker)
+    Q_DECLARE_PRIVATE(EndurancePacker)
+    QScopedPointer<EndurancePackerPrivate> d_ptr;
+};
+
+#endif // ENDURANCEPACKER_H
@@ -0,0 +1,73 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "endurancepacker.h"
+#include "creporterapplicationsettings.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Packs endurance snapshots into a rich core report.");
+    parser.addHelpOption();
+    QCommandLineOption deviceUidOption("device-uid", "Device UID to include in the report.", "uid");
+    QCommandLineOption bootTimeOption("boot-time", "Boot time of the snapshot session.", "time");
+    parser.addOption(deviceUidOption);
+    parser.addOption(bootTimeOption);
+    parser.addPositionalArgument("directory", "Directory containing the snapshot directories.");
+    parser.addPositionalArgument("report", "Path of the .rcore.lzo report to create.");
+    parser.process(app);
+
+    if (parser.positionalArguments().count() != 2) {
+        parser.showHelp(1);
+    }
+
+    QString directory(parser.positionalArguments().at(0));
+    QString report(parser.positionalArguments().at(1));
+
+    QByteArray deviceUid(parser.value(deviceUidOption).toUtf8());
+    if (!deviceUid.isEmpty()) {
+        deviceUid += '\n';
+    }
+
+    EndurancePacker packer(report);
+    packer.setMaxThreads(CReporterApplicationSettings::instance()->compressionMaxThreads());
+    CReporterApplicationSettings::freeSingleton();
+
+    if (!packer.open()
+            || !packer.addSection("device-uid", deviceUid)
+            || !packer.addSection("boot-time", parser.value(bootTimeOption).toUtf8() + '\n')
+            || !packer.addSnapshotPack(directory)
+            || !packer.finish()) {
+        qCWarning(cr) << "Creating endurance report" << report << "failed:" << packer.errorString();
+        return 1;
+    }
+
+    qCDebug(cr) << "Created endurance report" << report;
+    return 0;
+}
@@ -80,62 +80,34 @@ void CReporterCoreDir::setMountpoint(const QString &mpoint)
     qCDebug(cr) << "Mountpoint set to:" << d->mountpoint;
 }
 
-void CReporterCoreDir::collectAllCoreFilesAtLocation(QStringList &coreList)
+bool CReporterCoreDir::addCoreFile(const QString &fileName)
 {
     Q_D(CReporterCoreDir);
 
-    qCDebug(cr) << "Collecting cores from:" << d->directory;
-
-    QStringList filters;
-    filters << QString(rcore_file_name_filter) << QString(rcore_lzo_file_name_filter);
-
-    // Construct iterator for core-dumps directory.
-    QDirIterator iter(d->directory, filters, QDir::Files | QDir::NoDotAndDotDot);
+    if (d->coresAtDirectory.contains(fileName)) {
+        return false;
+    }
 
-    while (iter.hasNext()) {
-        QString filePath = iter.next();
+    d->coresAtDirectory << fileName;
+    emit coreFileAdded(d->directory + '/' + fileName);
 
-        if (CReporterUtils::validateCore(filePath)) {
-            coreList << filePath;
-        }
-    }
+    return true;
 }
 
-QString CReporterCoreDir::checkDirectoryForCores()
+void CReporterCoreDir::removeCoreFile(const QString &fileName)
 {
     Q_D(CReporterCoreDir);
 
-    QFileInfo fi;
-    QString coreFilePath;
-
-    QStringList filters;
-    filters << QString(rcore_file_name_filter) << QString(rcore_lzo_file_name_filter);
-
-    // Construct iterator for core-dumps directory.
-    QDirIterator iter(d->directory, filters, QDir::Files | QDir::NoDotAndDotDot);
-
-    // Iterate over files in the core-dumps directory.
-    while (iter.hasNext()) {
-        iter.next();
-        fi = iter.fileInfo();
-
-        if (!d->coresAtDirectory.contains(fi.fileName())
-                && CReporterUtils::validateCore(fi.fileName())) {
-            // This is valid rich core file, which hasn't been processed before.
-            d->coresAtDirectory << fi.fileName();
-            coreFilePath = fi.absoluteFilePath();
-            qCDebug(cr) << "New core file:" << fi.fileName();
-            break;
-        }
+    if (d->coresAtDirectory.remove(fileName)) {
+        emit coreFileRemoved(d->directory + '/' + fileName);
     }
+}
 
-    if (coreFilePath.isEmpty()) {
-        // File was deleted by the user or client from the directory.
-        // Refresh directory list.
-        updateCoreList();
-    }
+void CReporterCoreDir::setCoreFiles(const QStringList &fileNames)
+{
+    Q_D(CReporterCoreDir);
 
-    return coreFilePath;
+    d->coresAtDirectory = fileNames.toSet();
 }
 
 void CReporterCoreDir::createCoreDirectory()
@@ -157,6 +129,9 @@ void CReporterCoreDir::createCoreDirectory()
                 qCWarning(cr) << "Error while creating directory:" << d->directory;
             }
             // Remove old entries from the list.
+            foreach (const QString &fileName, d->coresAtDirectory) {
+                emit coreFileRemoved(d->directory + '/' + fileName);
+            }
             d->coresAtDirectory.clear();
         } else {
             // There was a "core-dumps" directory already. Fetch possible core files.
@@ -175,12 +150,24 @@ void CReporterCoreDir::updateCoreList()
     dir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
     dir.setNameFilters(QStringList() << rcore_file_name_filter << rcore_lzo_file_name_filter);
 
-    // Remove old entries.
-    d->coresAtDirectory.clear();
+    // Diff the directory against the previous snapshot.
+    QSet<QString> previous;
+    previous.swap(d->coresAtDirectory);
+    d->coresAtDirectory.reserve(previous.size());
 
     QDirIterator it(dir);
     while (it.hasNext()) {
         it.next();
-        d->coresAtDirectory.append(it.fileName());
+        QString fileName(it.fileName());
+
+        d->coresAtDirectory.insert(fileName);
+        if (!previous.remove(fileName)) {
+            emit coreFileAdded(d->directory + '/' + fileName);
+        }
+    }
+
+    // Whatever is left in the old snapshot is gone from the directory.
+    foreach (const QString &fileName, previous) {
+        emit coreFileRemoved(d->directory + '/' + fileName);
     }
 }
@@ -83,19 +83,32 @@ public:
     void setMountpoint(const QString &mpoint);
 
     /*!
-     * @brief Collects all valid core files from this directory and appends into lists.
+     * @brief Marks a core file in this directory as seen.
      *
-     * @param coreList Reference to list populated with absolute core file paths.
+     * Used when the file is known to exist, e.g. from a file system
+     * notification, to avoid re-reading the directory.
+     *
+     * @param fileName Name of the core file.
+     * @return true if the file wasn't seen before.
      */
-    void collectAllCoreFilesAtLocation(QStringList &coreList);
+    bool addCoreFile(const QString &fileName);
 
     /*!
-     * @brief Checks directory for new core files.
+     * @brief Forgets a removed core file of this directory.
      *
-     * @return Absolute path to core file. String is NULL, if new valid
-     *  core file was not found.
+     * @param fileName Name of the core file.
      */
-    QString checkDirectoryForCores();
+    void removeCoreFile(const QString &fileName);
+
+    /*!
+     * @brief Sets the known core files of this directory without reading
+     * the directory.
+     *
+     * Used to start from the core index. No signals are sent.
+     *
+     * @param fileNames Names of the core files.
+     */
+    void setCoreFiles(const QStringList &fileNames);
 
 public Q_SLOTS:
     /*!
@@ -107,9 +120,26 @@ public Q_SLOTS:
     /*!
       * @brief This function iterates core-dumps directory for cores and refreshes internal list.
       *
+      * Differences to the previous list are reported with coreFileAdded()
+      * and coreFileRemoved().
       */
     void updateCoreList();
 
+Q_SIGNALS:
+    /*!
+     * @brief Sent when a core file appeared into the directory.
+     *
+     * @param filePath Absolute path to the core file.
+     */
+    void coreFileAdded(const QString &filePath);
+
+    /*!
+     * @brief Sent when a core file disappeared from the directory.
+     *
+     * @param filePath Absolute path to the core file.
+     */
+    void coreFileRemoved(const QString &filePath);
+
 private:
     Q_DECLARE_PRIVATE(CReporterCoreDir)
 
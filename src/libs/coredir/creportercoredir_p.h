@@ -25,7 +25,8 @@
 #ifndef CREPORTERCOREDIR_P_H
 #define CREPORTERCOREDIR_P_H
 
-#include <QStringList>
+#include <QSet>
+#include <QString>
 
 class CReporterCoreDirPrivate
 {
@@ -34,8 +35,8 @@ public:
     QString directory;
     //! @arg Absolute path to the mount point.
     QString mountpoint;
-    //! @arg List of core files currently in the directory.
-    QStringList coresAtDirectory;
+    //! @arg Names of core files currently in the directory.
+    QSet<QString> coresAtDirectory;
 };
 
 #endif // CREPORTERCOREDIR_P_H
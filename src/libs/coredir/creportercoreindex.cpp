@@ -0,0 +1,420 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+#include <QSet>
+#include <QTimer>
+
+#include "creportercoreindex.h"
+#include "creportercrashinfo.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const quint32 IndexMagic = 0x43524958; // "CRIX"
+const quint32 IndexVersion = 1;
+
+// Time to wait (ms) for further modifications before writing the index.
+const int SaveDelay = 2000;
+
+QDataStream &operator<<(QDataStream &stream, const CReporterCoreIndex::Entry &entry)
+{
+    stream << entry.filePath << entry.size << entry.modified
+           << entry.applicationName << entry.hwId
+           << qint32(entry.signalNumber) << qint32(entry.pid)
+           << qint32(entry.uploadState) << entry.uploadStateChanged;
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, CReporterCoreIndex::Entry &entry)
+{
+    qint32 signalNumber, pid, uploadState;
+    stream >> entry.filePath >> entry.size >> entry.modified
+           >> entry.applicationName >> entry.hwId
+           >> signalNumber >> pid
+           >> uploadState >> entry.uploadStateChanged;
+    entry.signalNumber = signalNumber;
+    entry.pid = pid;
+    entry.uploadState = static_cast<CReporterCoreIndex::UploadState>(uploadState);
+    return stream;
+}
+
+typedef QMap<QString, CReporterCoreIndex::Entry> EntryMap;
+
+bool readIndexFile(const QString &path, EntryMap *entries)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, count;
+    stream >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion) {
+        qCWarning(cr) << "Ignoring incompatible core index" << path;
+        return false;
+    }
+
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        CReporterCoreIndex::Entry entry;
+        stream >> entry;
+        entries->insert(entry.filePath, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(cr) << "Core index" << path << "is corrupted";
+        entries->clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool writeIndexFile(const QString &path, const EntryMap &entries)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't write core index" << path << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << IndexMagic << IndexVersion << quint32(entries.count());
+    foreach (const CReporterCoreIndex::Entry &entry, entries) {
+        stream << entry;
+    }
+
+    if (!file.commit()) {
+        qCWarning(cr) << "Couldn't write core index" << path << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+class CReporterCoreIndexPrivate
+{
+public:
+    CReporterCoreIndexPrivate(CReporterCoreIndex *q);
+
+    void load();
+    void scheduleSave();
+    void saveDeferred();
+
+    QString indexFile;
+    EntryMap entries;
+    qint64 totalSize;
+    //! @arg Files not seen yet during reconciliation.
+    QSet<QString> unconfirmed;
+    bool reconciling;
+    bool owner;
+    bool dirty;
+    QTimer saveTimer;
+
+    Q_DECLARE_PUBLIC(CReporterCoreIndex)
+    CReporterCoreIndex *q_ptr;
+};
+
+CReporterCoreIndexPrivate::CReporterCoreIndexPrivate(CReporterCoreIndex *q)
+    : totalSize(0), reconciling(false), owner(false), dirty(false), q_ptr(q)
+{
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(SaveDelay);
+}
+
+void CReporterCoreIndexPrivate::load()
+{
+    entries.clear();
+    totalSize = 0;
+
+    if (!readIndexFile(indexFile, &entries)) {
+        return;
+    }
+
+    foreach (const CReporterCoreIndex::Entry &entry, entries) {
+        totalSize += entry.size;
+    }
+
+    qCDebug(cr) << "Loaded" << entries.count() << "entries from" << indexFile;
+}
+
+void CReporterCoreIndexPrivate::scheduleSave()
+{
+    dirty = true;
+    if (!reconciling) {
+        saveTimer.start();
+    }
+}
+
+void CReporterCoreIndexPrivate::saveDeferred()
+{
+    Q_Q(CReporterCoreIndex);
+
+    if (dirty) {
+        q->save();
+    }
+}
+
+CReporterCoreIndex::CReporterCoreIndex(const QString &indexFile, QObject *parent)
+    : QObject(parent), d_ptr(new CReporterCoreIndexPrivate(this))
+{
+    Q_D(CReporterCoreIndex);
+
+    d->indexFile = indexFile;
+    connect(&d->saveTimer, SIGNAL(timeout()), this, SLOT(saveDeferred()));
+
+    d->load();
+}
+
+CReporterCoreIndex::~CReporterCoreIndex()
+{
+    Q_D(CReporterCoreIndex);
+
+    if (d->dirty) {
+        save();
+    }
+
+    delete d_ptr;
+}
+
+QString CReporterCoreIndex::indexFile() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->indexFile;
+}
+
+QStringList CReporterCoreIndex::filePaths() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->entries.keys();
+}
+
+QList<CReporterCoreIndex::Entry> CReporterCoreIndex::entries() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->entries.values();
+}
+
+CReporterCoreIndex::Entry CReporterCoreIndex::entry(const QString &filePath) const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->entries.value(filePath);
+}
+
+bool CReporterCoreIndex::contains(const QString &filePath) const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->entries.contains(filePath);
+}
+
+int CReporterCoreIndex::count() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->entries.count();
+}
+
+qint64 CReporterCoreIndex::totalSize() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->totalSize;
+}
+
+void CReporterCoreIndex::beginReconcile()
+{
+    Q_D(CReporterCoreIndex);
+
+    d->reconciling = true;
+    d->unconfirmed = d->entries.keys().toSet();
+}
+
+void CReporterCoreIndex::endReconcile()
+{
+    Q_D(CReporterCoreIndex);
+
+    foreach (const QString &filePath, d->unconfirmed) {
+        qCDebug(cr) << "Dropping stale index entry" << filePath;
+        d->totalSize -= d->entries.take(filePath).size;
+        d->dirty = true;
+    }
+
+    d->unconfirmed.clear();
+    d->reconciling = false;
+
+    if (d->dirty) {
+        d->scheduleSave();
+    }
+}
+
+void CReporterCoreIndex::setOwner(bool owner)
+{
+    Q_D(CReporterCoreIndex);
+
+    bool wasOwner = d->owner;
+    d->owner = owner;
+    if (owner && !wasOwner) {
+        // The file may lack records that were only kept in memory so far.
+        d->scheduleSave();
+    }
+}
+
+bool CReporterCoreIndex::isOwner() const
+{
+    Q_D(const CReporterCoreIndex);
+
+    return d->owner;
+}
+
+void CReporterCoreIndex::setUploadState(const QString &filePath, UploadState state)
+{
+    Q_D(CReporterCoreIndex);
+
+    EntryMap::iterator it = d->entries.find(filePath);
+    if (it == d->entries.end() || it->uploadState == state) {
+        return;
+    }
+
+    it->uploadState = state;
+    it->uploadStateChanged = QDateTime::currentMSecsSinceEpoch();
+    d->scheduleSave();
+}
+
+bool CReporterCoreIndex::save()
+{
+    Q_D(CReporterCoreIndex);
+
+    d->saveTimer.stop();
+
+    /* Other crash-reporter processes may have updated upload states in the
+     * meantime. Keep whichever state change is newer. */
+    EntryMap onDisk;
+    if (!readIndexFile(d->indexFile, &onDisk) && !d->owner) {
+        // Nothing to merge into, the owner creates the file.
+        d->dirty = false;
+        return false;
+    }
+
+    for (EntryMap::iterator it = d->entries.begin(); it != d->entries.end(); ++it) {
+        EntryMap::iterator other = onDisk.find(it.key());
+        if (other == onDisk.end()) {
+            continue;
+        }
+        if (other->uploadStateChanged > it->uploadStateChanged) {
+            it->uploadState = other->uploadState;
+            it->uploadStateChanged = other->uploadStateChanged;
+        } else {
+            other->uploadState = it->uploadState;
+            other->uploadStateChanged = it->uploadStateChanged;
+        }
+    }
+
+    // Only the owner decides which files are indexed.
+    if (!writeIndexFile(d->indexFile, d->owner ? d->entries : onDisk)) {
+        return false;
+    }
+
+    d->dirty = false;
+    return true;
+}
+
+void CReporterCoreIndex::add(const QString &filePath)
+{
+    Q_D(CReporterCoreIndex);
+
+    if (!CReporterUtils::validateCore(filePath)) {
+        return;
+    }
+
+    QFileInfo fi(filePath);
+    if (!fi.exists()) {
+        remove(filePath);
+        return;
+    }
+
+    d->unconfirmed.remove(filePath);
+
+    qint64 modified = fi.lastModified().toMSecsSinceEpoch();
+
+    EntryMap::iterator it = d->entries.find(filePath);
+    if (it != d->entries.end()) {
+        if (it->size == fi.size() && it->modified == modified) {
+            return;
+        }
+        d->totalSize -= it->size;
+    } else {
+        Entry entry;
+        entry.filePath = filePath;
+
+        CReporterCrashInfo info = CReporterCrashInfo::fromFileName(filePath);
+        entry.applicationName = info.applicationName();
+        entry.hwId = info.hwId();
+        entry.signalNumber = info.signalNumber();
+        entry.pid = info.pid();
+
+        it = d->entries.insert(filePath, entry);
+    }
+
+    it->size = fi.size();
+    it->modified = modified;
+    d->totalSize += it->size;
+
+    if (d->owner) {
+        d->scheduleSave();
+    }
+}
+
+void CReporterCoreIndex::remove(const QString &filePath)
+{
+    Q_D(CReporterCoreIndex);
+
+    EntryMap::iterator it = d->entries.find(filePath);
+    if (it == d->entries.end()) {
+        return;
+    }
+
+    d->totalSize -= it->size;
+    d->entries.erase(it);
+    d->unconfirmed.remove(filePath);
+
+    if (d->owner) {
+        d->scheduleSave();
+    }
+}
+
+#include "moc_creportercoreindex.cpp"
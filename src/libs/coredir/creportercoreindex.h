@@ -0,0 +1,198 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCOREINDEX_H
+#define CREPORTERCOREINDEX_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "creporterexport.h"
+
+class CReporterCoreIndexPrivate;
+
+/*!
+ * @class CReporterCoreIndex
+ * @brief Persistent index of the rich core files in all core locations.
+ *
+ * The index is owned by CReporterCoreRegistry. The daemon populates it
+ * once from the file system at startup and after that keeps it up to
+ * date from the add/remove notifications of CReporterCoreDir instances, so
+ * that listing the pending reports doesn't require touching the disk.
+ *
+ * Modifications are written back to the index file lazily. The index is
+ * only a cache; the file system is authoritative at startup.
+ *
+ * The file is shared by all crash-reporter processes, but only its owner,
+ * the daemon, writes which files are in the index. Other processes only
+ * merge their upload state changes into the file.
+ *
+ * @sa CReporterCoreRegistry
+ */
+class CREPORTER_EXPORT CReporterCoreIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Upload state of an indexed report.
+    enum UploadState {
+        //! Report hasn't been sent yet.
+        NotUploaded = 0,
+        //! Report is being sent.
+        Uploading,
+        //! Last attempt to send the report failed.
+        UploadFailed,
+        //! Report was sent, but kept on the device.
+        Uploaded
+    };
+
+    //! Index record of a single rich core file.
+    struct Entry {
+        Entry() : size(0), modified(0), signalNumber(0), pid(0),
+            uploadState(NotUploaded), uploadStateChanged(0) {}
+
+        //! Absolute path of the file.
+        QString filePath;
+        //! File size in bytes.
+        qint64 size;
+        //! Last modification time, msecs since epoch.
+        qint64 modified;
+        //! Crashed application name parsed from the file name.
+        QString applicationName;
+        //! Hardware id parsed from the file name.
+        QString hwId;
+        //! Signal number parsed from the file name.
+        int signalNumber;
+        //! Process id parsed from the file name.
+        int pid;
+        //! Upload state of the report.
+        UploadState uploadState;
+        //! Time of the last upload state change, msecs since epoch.
+        qint64 uploadStateChanged;
+    };
+
+    /*!
+     * @brief Class constructor.
+     *
+     * @param indexFile Path of the file the index is persisted to.
+     * @param parent Owner of this object.
+     */
+    explicit CReporterCoreIndex(const QString &indexFile, QObject *parent = 0);
+
+    ~CReporterCoreIndex();
+
+    /*!
+     * @brief Returns path of the file the index is persisted to.
+     */
+    QString indexFile() const;
+
+    /*!
+     * @brief Returns absolute paths of all indexed files, sorted.
+     */
+    QStringList filePaths() const;
+
+    /*!
+     * @brief Returns all index records, sorted by file path.
+     */
+    QList<Entry> entries() const;
+
+    /*!
+     * @brief Returns index record of @a filePath.
+     *
+     * Default constructed Entry is returned if the file isn't indexed.
+     */
+    Entry entry(const QString &filePath) const;
+
+    bool contains(const QString &filePath) const;
+
+    int count() const;
+
+    /*!
+     * @brief Returns combined size of all indexed files in bytes.
+     */
+    qint64 totalSize() const;
+
+    /*!
+     * @brief Starts reconciliation of the index with the file system.
+     *
+     * Records of files that aren't add()ed again before endReconcile()
+     * are dropped from the index.
+     */
+    void beginReconcile();
+
+    /*!
+     * @brief Finishes reconciliation started with beginReconcile().
+     */
+    void endReconcile();
+
+    /*!
+     * @brief Makes this index the owner of the index file.
+     *
+     * The owner writes its own list of files. Other instances keep the
+     * list in the file and only update upload states of its records.
+     */
+    void setOwner(bool owner);
+
+    bool isOwner() const;
+
+    /*!
+     * @brief Sets upload state of an indexed file.
+     *
+     * @param filePath Absolute path of the file.
+     * @param state New upload state.
+     */
+    void setUploadState(const QString &filePath, UploadState state);
+
+    /*!
+     * @brief Writes the index into its file immediately.
+     *
+     * Upload states are merged with the file, newer state change wins.
+     *
+     * @return true on success.
+     */
+    bool save();
+
+public Q_SLOTS:
+    /*!
+     * @brief Adds @a filePath into the index or refreshes its record.
+     *
+     * Existing record is reused when size and modification time of the
+     * file didn't change.
+     */
+    void add(const QString &filePath);
+
+    /*!
+     * @brief Removes @a filePath from the index.
+     */
+    void remove(const QString &filePath);
+
+private:
+    Q_DECLARE_PRIVATE(CReporterCoreIndex)
+    CReporterCoreIndexPrivate *d_ptr;
+    Q_PRIVATE_SLOT(d_func(), void saveDeferred())
+
+#ifdef CREPORTER_UNIT_TEST
+    friend class Ut_CReporterCoreRegistry;
+#endif
+};
+
+Q_DECLARE_METATYPE(CReporterCoreIndex::UploadState)
+
+#endif // CREPORTERCOREINDEX_H
@@ -31,11 +31,15 @@
 #include <QTimer>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
 #include <QSignalMapper>
 
 #include "creportercoreregistry.h"
 #include "creportercoreregistry_p.h"
 #include "creportercoredir.h"
+#include "creportercoreindex.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -67,9 +71,13 @@ mountpoint_static[NUM_STATIC_MOUNTPOINTS][MAX_MOUNTPOINT_NAMELEN] = {
 #endif // CREPORTER_UNIT_TEST
 
 const char core_dumps_suffix[] = "/core-dumps";
+const char core_index_file[] = "/core-index";
+const char upload_offset_file_filter[] = ".*.upload";
+const int upload_offset_suffix_length = 7; // ".upload"
 
 
 CReporterCoreRegistryPrivate::CReporterCoreRegistryPrivate()
+    : index(0)
 {
     mapper = new QSignalMapper();
 }
@@ -104,14 +112,14 @@ QStringList CReporterCoreRegistry::collectAllCoreFiles() const
 {
     Q_D(const CReporterCoreRegistry);
 
-    QStringList out;
-    QListIterator<CReporterCoreDir *> iter(d->coreDirs);
+    return d->index->filePaths();
+}
 
-    while (iter.hasNext()) {
-        CReporterCoreDir *dir = (CReporterCoreDir *) iter.next();
-        dir->collectAllCoreFilesAtLocation(out);
-    }
-    return out;
+CReporterCoreIndex *CReporterCoreRegistry::coreIndex() const
+{
+    Q_D(const CReporterCoreRegistry);
+
+    return d->index;
 }
 
 QStringList CReporterCoreRegistry::getCoreLocationPaths()
@@ -138,21 +146,48 @@ QStringList CReporterCoreRegistry::getCoreLocationPaths()
     return paths;
 }
 
-QString CReporterCoreRegistry::checkDirectoryForCores(const QString &path)
+bool CReporterCoreRegistry::registerCoreFile(const QString &filePath)
 {
     Q_D(CReporterCoreRegistry);
 
-    QString coreFilePath;
-    QListIterator<CReporterCoreDir *> iter(d->coreDirs);
+    QFileInfo fi(filePath);
 
-    while (iter.hasNext()) {
-        CReporterCoreDir *pCoreDir =  (CReporterCoreDir *) iter.next();
-        // Find the correct location.
-        if (pCoreDir->getDirectory() == path) {
-            coreFilePath = pCoreDir->checkDirectoryForCores();
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        if (dir->getDirectory() == fi.path()) {
+            if (dir->addCoreFile(fi.fileName())) {
+                return true;
+            }
+            // Already known, but the file may have been appended to.
+            d->index->add(filePath);
+            break;
+        }
+    }
+
+    return false;
+}
+
+void CReporterCoreRegistry::unregisterCoreFile(const QString &filePath)
+{
+    Q_D(CReporterCoreRegistry);
+
+    QFileInfo fi(filePath);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        if (dir->getDirectory() == fi.path()) {
+            dir->removeCoreFile(fi.fileName());
+        }
+    }
+}
+
+void CReporterCoreRegistry::refreshDirectory(const QString &path)
+{
+    Q_D(CReporterCoreRegistry);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        if (dir->getDirectory() == path) {
+            dir->updateCoreList();
         }
     }
-    return coreFilePath;
 }
 
 void CReporterCoreRegistry::refreshRegistry()
@@ -216,8 +251,74 @@ void CReporterCoreRegistry::createCoreLocationRegistry()
         dir->setDirectory(tmp);
     }
 
-    // Emit this signal to create directories for core dumps.
+    // The index lives in the first core location, next to the upload log.
+    d->index = new CReporterCoreIndex(d->coreDirs.first()->getDirectory() + core_index_file,
+                                      this);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        connect(dir, SIGNAL(coreFileAdded(QString)), d->index, SLOT(add(QString)));
+        connect(dir, SIGNAL(coreFileRemoved(QString)), d->index, SLOT(remove(QString)));
+        connect(dir, SIGNAL(coreFileRemoved(QString)), SLOT(removeUploadOffset(QString)));
+    }
+
+    if (d->index->count() == 0) {
+        /* No index yet, the daemon hasn't run. Emit this signal to create
+         * directories for core dumps and to find the core files. */
+        emit coreLocationsUpdated();
+    } else {
+        // Start from the index kept by the daemon, without reading the directories.
+        QHash<QString, QStringList> fileNames;
+        foreach (const QString &filePath, d->index->filePaths()) {
+            QFileInfo fi(filePath);
+            fileNames[fi.path()] << fi.fileName();
+        }
+        foreach (CReporterCoreDir *dir, d->coreDirs) {
+            dir->setCoreFiles(fileNames.value(dir->getDirectory()));
+        }
+    }
+}
+
+void CReporterCoreRegistry::reconcileIndex()
+{
+    Q_D(CReporterCoreRegistry);
+
+    qCDebug(cr) << "Reconciling core index with the core directories.";
+
+    /* Emit this signal to create directories for core dumps. Every core file
+     * found is reported to the index, entries of files that are gone get
+     * dropped. */
+    d->index->setOwner(true);
+    d->index->beginReconcile();
     emit coreLocationsUpdated();
+    d->index->endReconcile();
+
+    removeOrphanedUploadOffsets();
+}
+
+void CReporterCoreRegistry::removeUploadOffset(const QString &filePath)
+{
+    QFile::remove(CReporterUtils::uploadOffsetFile(filePath));
+}
+
+void CReporterCoreRegistry::removeOrphanedUploadOffsets()
+{
+    Q_D(CReporterCoreRegistry);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        QDir coreDir(dir->getDirectory());
+        QStringList offsetFiles(coreDir.entryList(QStringList() << upload_offset_file_filter,
+                                                  QDir::Files | QDir::Hidden));
+
+        foreach (const QString &offsetFile, offsetFiles) {
+            // ".<name>.upload" belongs to "<name>".
+            QString filePath(coreDir.absoluteFilePath(
+                    offsetFile.mid(1, offsetFile.length() - 1 - upload_offset_suffix_length)));
+            if (!d->index->contains(filePath)) {
+                qCDebug(cr) << "Removing orphaned upload offset" << offsetFile;
+                coreDir.remove(offsetFile);
+            }
+        }
+    }
 }
 
 CReporterCoreRegistry *CReporterCoreRegistry::instance()
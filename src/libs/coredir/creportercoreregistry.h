@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QStringList>
 
+class CReporterCoreIndex;
 class CReporterCoreRegistryPrivate;
 
 /*!
@@ -46,14 +47,22 @@ public:
     ~CReporterCoreRegistry();
 
     /*!
-    * @brief This function searches for core dump files from directories and appends
-    * the file paths into list.
+    * @brief Returns paths of all rich core files in the core directories.
     *
-    * @return List to be populated with rich core file paths.
+    * The list is served from the core index and doesn't access the disk.
+    *
+    * @return List of rich core file paths.
     *
     */
     QStringList collectAllCoreFiles() const;
 
+    /*!
+     * @brief Returns the index of rich core files in all core locations.
+     *
+     * @return Core index owned by the registry.
+     */
+    CReporterCoreIndex *coreIndex() const;
+
     /*!
      * @brief This function returns a list of core directory paths.
      *
@@ -62,14 +71,36 @@ public:
     QStringList getCoreLocationPaths();
 
     /*!
-     * @brief Checks directory for new core files.
+     * @brief Registers a core file reported by a file system notification.
+     *
+     * @param filePath Absolute path to the core file.
+     * @return true if the file wasn't known before.
+     */
+    bool registerCoreFile(const QString &filePath);
+
+    /*!
+     * @brief Unregisters a core file that was removed.
      *
-     * @param path Reference to directory to be checked.
+     * @param filePath Absolute path to the core file.
+     */
+    void unregisterCoreFile(const QString &filePath);
+
+    /*!
+     * @brief Refreshes the core list of a single directory after its
+     * contents have changed.
      *
-     * @return Absolute path to core file. String is NULL, if new valid
-     *  core file was not found.
+     * @param path Core directory path.
      */
-    QString checkDirectoryForCores(const QString &path);
+    void refreshDirectory(const QString &path);
+
+    /*!
+     * @brief Takes ownership of the core index and reconciles it with the
+     * core directories.
+     *
+     * Called once by the daemon at startup. Other processes use the index
+     * as the daemon wrote it, and don't change which files it lists.
+     */
+    void reconcileIndex();
 
 public Q_SLOTS:
     /*!
@@ -104,6 +135,13 @@ private Q_SLOTS:
      */
     void mmcStateChanged(const QString &key);
 
+    /*!
+     * @brief Removes the saved upload offset of a core file that is gone.
+     *
+     * @param filePath Absolute path to the removed core file.
+     */
+    void removeUploadOffset(const QString &filePath);
+
 private:
     /**
      * Creates new core registry.
@@ -119,6 +157,12 @@ private:
       */
     void createCoreLocationRegistry();
 
+    /*!
+      * @brief Removes upload offsets left behind by core files that were
+      * removed while nobody was watching the directories.
+      */
+    void removeOrphanedUploadOffsets();
+
 private:
     Q_DECLARE_PRIVATE(CReporterCoreRegistry)
 
@@ -28,6 +28,7 @@
 #include <QList>
 
 class CReporterCoreDir;
+class CReporterCoreIndex;
 class QSignalMapper;
 
 /*!
@@ -47,6 +48,8 @@ public:
     QSignalMapper *mapper;
     //! @arg List of CReporterCoreDir instances.
     QList<CReporterCoreDir *> coreDirs;
+    //! @arg Index of core files in all locations.
+    CReporterCoreIndex *index;
 };
 
 #endif // CREPORTERCOREREGISTRY_P_H
@@ -0,0 +1,261 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QSocketNotifier>
+
+#include "creportercorewatcher.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+/* IN_CLOSE_WRITE is used instead of IN_CREATE so that a core file is
+ * reported only after rich-core-dumper has finished writing it. */
+const uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM |
+                           IN_MOVE_SELF | IN_ONLYDIR;
+
+bool isCoreFileName(const char *name)
+{
+    // Hidden files are partial writes, same as in CReporterCoreDir.
+    return name[0] != '.' && CReporterUtils::validateCore(QString::fromLocal8Bit(name));
+}
+} // namespace
+
+class CReporterCoreWatcherPrivate
+{
+public:
+    CReporterCoreWatcherPrivate(CReporterCoreWatcher *q);
+    ~CReporterCoreWatcherPrivate();
+
+    void readEvents();
+
+    int fd;
+    QSocketNotifier *notifier;
+    //! @arg Watched directory paths by watch descriptor.
+    QHash<int, QString> directories;
+    //! @arg Watch descriptors by directory path.
+    QHash<QString, int> watches;
+
+    Q_DECLARE_PUBLIC(CReporterCoreWatcher)
+    CReporterCoreWatcher *q_ptr;
+};
+
+CReporterCoreWatcherPrivate::CReporterCoreWatcherPrivate(CReporterCoreWatcher *q)
+    : fd(-1), notifier(0), q_ptr(q)
+{
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1) {
+        qCWarning(cr) << "inotify_init1() failed:" << strerror(errno);
+        return;
+    }
+
+    notifier = new QSocketNotifier(fd, QSocketNotifier::Read, q);
+    QObject::connect(notifier, SIGNAL(activated(int)), q, SLOT(readEvents()));
+}
+
+CReporterCoreWatcherPrivate::~CReporterCoreWatcherPrivate()
+{
+    if (fd != -1) {
+        close(fd);
+    }
+}
+
+void CReporterCoreWatcherPrivate::readEvents()
+{
+    Q_Q(CReporterCoreWatcher);
+
+    // Sets keep the work per event constant during a burst of cores.
+    QSet<QString> added;
+    // Order of arrival of the added files, may contain removed ones.
+    QStringList addedOrder;
+    QSet<QString> removed;
+    QSet<QString> removedDirectories;
+    bool overflowed = false;
+
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    // Drain everything that is pending so that bursts come out as one batch.
+    forever {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length == -1 && errno == EINTR) {
+                continue;
+            }
+            if (length == -1 && errno != EAGAIN) {
+                qCWarning(cr) << "Reading inotify events failed:" << strerror(errno);
+            }
+            break;
+        }
+
+        for (char *ptr = buffer; ptr < buffer + length;) {
+            const struct inotify_event *event =
+                reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                continue;
+            }
+
+            QHash<int, QString>::const_iterator dir = directories.constFind(event->wd);
+            if (dir == directories.constEnd()) {
+                continue;
+            }
+
+            // The kernel drops the watch with IN_IGNORED on deletion and unmount.
+            if (event->mask & (IN_IGNORED | IN_MOVE_SELF)) {
+                removedDirectories.insert(*dir);
+                if (event->mask & IN_MOVE_SELF) {
+                    inotify_rm_watch(fd, event->wd);
+                }
+                watches.remove(*dir);
+                directories.remove(event->wd);
+                continue;
+            }
+
+            if (event->len == 0 || !isCoreFileName(event->name)) {
+                continue;
+            }
+
+            QString filePath = *dir + '/' + QString::fromLocal8Bit(event->name);
+
+            if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                // A file may be closed after writing several times.
+                if (!added.contains(filePath)) {
+                    added.insert(filePath);
+                    addedOrder << filePath;
+                }
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                if (!added.remove(filePath)) {
+                    removed.insert(filePath);
+                }
+            }
+        }
+    }
+
+    if (!removed.isEmpty()) {
+        emit q->coreFilesRemoved(removed.toList());
+    }
+    if (!added.isEmpty()) {
+        QStringList filePaths;
+        foreach (const QString &filePath, addedOrder) {
+            // Taken out of the set so that a re-added file is listed once.
+            if (added.remove(filePath)) {
+                filePaths << filePath;
+            }
+        }
+        emit q->coreFilesAdded(filePaths);
+    }
+    foreach (const QString &path, removedDirectories) {
+        qCDebug(cr) << "Watched directory" << path << "was removed.";
+        emit q->directoryRemoved(path);
+    }
+    if (overflowed) {
+        qCWarning(cr) << "inotify event queue overflowed, rescanning watched directories.";
+        emit q->overflowed();
+    }
+}
+
+CReporterCoreWatcher::CReporterCoreWatcher(QObject *parent)
+    : QObject(parent), d_ptr(new CReporterCoreWatcherPrivate(this))
+{
+}
+
+CReporterCoreWatcher::~CReporterCoreWatcher()
+{
+}
+
+bool CReporterCoreWatcher::addPath(const QString &path)
+{
+    Q_D(CReporterCoreWatcher);
+
+    if (d->fd == -1) {
+        return false;
+    }
+
+    QString dirPath(QDir(path).absolutePath());
+    if (d->watches.contains(dirPath)) {
+        return true;
+    }
+
+    int wd = inotify_add_watch(d->fd, QFile::encodeName(dirPath).constData(), WatchMask);
+    if (wd == -1) {
+        qCWarning(cr) << "Can't watch" << dirPath << ":" << strerror(errno);
+        return false;
+    }
+
+    qCDebug(cr) << "Watching" << dirPath;
+    d->directories.insert(wd, dirPath);
+    d->watches.insert(dirPath, wd);
+
+    return true;
+}
+
+QStringList CReporterCoreWatcher::addPaths(const QStringList &paths)
+{
+    QStringList failed;
+
+    foreach (const QString &path, paths) {
+        if (!addPath(path)) {
+            failed << path;
+        }
+    }
+
+    return failed;
+}
+
+void CReporterCoreWatcher::removePath(const QString &path)
+{
+    Q_D(CReporterCoreWatcher);
+
+    QString dirPath(QDir(path).absolutePath());
+    QHash<QString, int>::iterator it = d->watches.find(dirPath);
+    if (it != d->watches.end()) {
+        inotify_rm_watch(d->fd, *it);
+        d->directories.remove(*it);
+        d->watches.erase(it);
+    }
+}
+
+void CReporterCoreWatcher::removePaths(const QStringList &paths)
+{
+    foreach (const QString &path, paths) {
+        removePath(path);
+    }
+}
+
+QStringList CReporterCoreWatcher::directories() const
+{
+    Q_D(const CReporterCoreWatcher);
+
+    return d->directories.values();
+}
+
+#include "moc_creportercorewatcher.cpp"
@@ -0,0 +1,118 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCOREWATCHER_H
+#define CREPORTERCOREWATCHER_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "creporterexport.h"
+
+class CReporterCoreWatcherPrivate;
+
+/*!
+ * @class CReporterCoreWatcher
+ * @brief inotify based watcher for rich core directories.
+ *
+ * Unlike QFileSystemWatcher, which only tells that something in a directory
+ * has changed, this class reports the exact core files that were completely
+ * written into (or moved to) and removed from watched directories. Events
+ * that are pending at once are delivered as a batch, so a burst of crash
+ * reports is handled without re-reading the directories.
+ */
+class CREPORTER_EXPORT CReporterCoreWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CReporterCoreWatcher(QObject *parent = 0);
+    ~CReporterCoreWatcher();
+
+    /*!
+     * @brief Starts watching @a path.
+     *
+     * @return true on success or if the path is already watched.
+     */
+    bool addPath(const QString &path);
+
+    /*!
+     * @brief Starts watching all @a paths.
+     *
+     * @return Paths that couldn't be watched.
+     */
+    QStringList addPaths(const QStringList &paths);
+
+    /*!
+     * @brief Stops watching @a path.
+     */
+    void removePath(const QString &path);
+
+    /*!
+     * @brief Stops watching all @a paths.
+     */
+    void removePaths(const QStringList &paths);
+
+    /*!
+     * @brief Returns list of watched directories.
+     */
+    QStringList directories() const;
+
+Q_SIGNALS:
+    /*!
+     * @brief Sent when new core files are ready in watched directories.
+     *
+     * @param filePaths Absolute paths of the files, in order of arrival.
+     */
+    void coreFilesAdded(const QStringList &filePaths);
+
+    /*!
+     * @brief Sent when core files were removed from watched directories.
+     *
+     * @param filePaths Absolute paths of the removed files.
+     */
+    void coreFilesRemoved(const QStringList &filePaths);
+
+    /*!
+     * @brief Sent when a watched directory was deleted or moved away.
+     *
+     * The directory is no longer watched after this.
+     *
+     * @param path Path of the directory.
+     */
+    void directoryRemoved(const QString &path);
+
+    /*!
+     * @brief Sent when the kernel dropped events that weren't read in time.
+     *
+     * Core files may have been added or removed without being reported, so
+     * the watched directories need to be rescanned.
+     */
+    void overflowed();
+
+private:
+    Q_DISABLE_COPY(CReporterCoreWatcher)
+    Q_DECLARE_PRIVATE(CReporterCoreWatcher)
+    QScopedPointer<CReporterCoreWatcherPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void readEvents())
+};
+
+#endif // CREPORTERCOREWATCHER_H
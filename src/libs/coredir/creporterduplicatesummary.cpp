@@ -0,0 +1,326 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <limits.h>
+#include <time.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QTimer>
+
+#include "creportercoreregistry.h"
+#include "creportercrashinfo.h"
+#include "creporterduplicatesummary.h"
+#include "creporternamespace.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const QString SummaryDirectory("duplicates");
+const QString SummarySuffix(".tsv");
+const QString RecordHeader("time\tpid\tuptime\tsignal");
+
+const int DefaultPublishInterval = 24 * 60 * 60 * 1000;
+const int DefaultMaxRecords = 256;
+
+qint64 uptimeAt(qint64 time)
+{
+    struct timespec now;
+    if (clock_gettime(CLOCK_BOOTTIME, &now) != 0) {
+        return -1;
+    }
+
+    qint64 elapsed = (QDateTime::currentMSecsSinceEpoch() - time) / 1000;
+    return qMax(qint64(0), qint64(now.tv_sec) - elapsed);
+}
+
+//! Reads all lines of a summary. First line is the header.
+QStringList readSummary(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QStringList();
+    }
+
+    return QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+}
+} // namespace
+
+class CReporterDuplicateSummaryPrivate
+{
+public:
+    CReporterDuplicateSummaryPrivate();
+
+    QString summaryPath(quint64 signature) const;
+    void load();
+    void trim(const QString &filePath);
+    void schedulePublish();
+    void publishDue();
+
+    QString directory;
+    QString summaryDirectory;
+    int publishInterval;
+    int maxRecords;
+    //! @arg Number of records by summary file.
+    QHash<QString, int> records;
+    //! @arg Time of the oldest unpublished record, or -1.
+    qint64 oldestRecord;
+    QTimer publishTimer;
+
+    Q_DECLARE_PUBLIC(CReporterDuplicateSummary)
+    CReporterDuplicateSummary *q_ptr;
+};
+
+CReporterDuplicateSummaryPrivate::CReporterDuplicateSummaryPrivate()
+    : publishInterval(DefaultPublishInterval), maxRecords(DefaultMaxRecords),
+      oldestRecord(-1), q_ptr(0)
+{
+    publishTimer.setSingleShot(true);
+}
+
+QString CReporterDuplicateSummaryPrivate::summaryPath(quint64 signature) const
+{
+    return QString("%1/%2%3").arg(summaryDirectory)
+            .arg(signature, 16, 16, QLatin1Char('0')).arg(SummarySuffix);
+}
+
+void CReporterDuplicateSummaryPrivate::load()
+{
+    records.clear();
+    oldestRecord = -1;
+
+    QDir dir(summaryDirectory);
+    foreach (const QString &name, dir.entryList(QStringList("*" + SummarySuffix), QDir::Files)) {
+        QString filePath(dir.filePath(name));
+        QStringList lines(readSummary(filePath));
+        if (lines.count() < 2) {
+            continue;
+        }
+
+        records.insert(filePath, lines.count() - 1);
+
+        qint64 first = lines.at(1).section('\t', 0, 0).toLongLong() * 1000;
+        if (oldestRecord < 0 || first < oldestRecord) {
+            oldestRecord = first;
+        }
+    }
+}
+
+void CReporterDuplicateSummaryPrivate::trim(const QString &filePath)
+{
+    QStringList lines(readSummary(filePath));
+    if (lines.count() - 1 <= maxRecords) {
+        return;
+    }
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return;
+    }
+
+    QStringList kept(lines.mid(lines.count() - maxRecords));
+    file.write(lines.first().toUtf8() + '\n');
+    file.write(kept.join('\n').toUtf8() + '\n');
+    if (file.commit()) {
+        records.insert(filePath, kept.count());
+    }
+}
+
+void CReporterDuplicateSummaryPrivate::schedulePublish()
+{
+    if (oldestRecord < 0) {
+        publishTimer.stop();
+        return;
+    }
+
+    qint64 delay = oldestRecord + publishInterval - QDateTime::currentMSecsSinceEpoch();
+    publishTimer.start(static_cast<int>(qBound(qint64(0), delay, qint64(publishInterval))));
+}
+
+void CReporterDuplicateSummaryPrivate::publishDue()
+{
+    Q_Q(CReporterDuplicateSummary);
+
+    if (q->publish().isEmpty() && !records.isEmpty()) {
+        // Try again later rather than keep failing.
+        publishTimer.start(publishInterval);
+    }
+}
+
+CReporterDuplicateSummary::CReporterDuplicateSummary(const QString &directory, QObject *parent)
+    : QObject(parent), d_ptr(new CReporterDuplicateSummaryPrivate)
+{
+    Q_D(CReporterDuplicateSummary);
+
+    d->q_ptr = this;
+    d->directory = directory;
+    d->summaryDirectory = directory + '/' + SummaryDirectory;
+    connect(&d->publishTimer, SIGNAL(timeout()), this, SLOT(publishDue()));
+
+    d->load();
+    d->schedulePublish();
+}
+
+CReporterDuplicateSummary::~CReporterDuplicateSummary()
+{
+}
+
+QString CReporterDuplicateSummary::defaultDirectory()
+{
+    QStringList paths = CReporterCoreRegistry::instance()->getCoreLocationPaths();
+    return paths.isEmpty() ? QString() : paths.first();
+}
+
+void CReporterDuplicateSummary::setPublishInterval(int msecs)
+{
+    Q_D(CReporterDuplicateSummary);
+
+    d->publishInterval = qMax(0, msecs);
+    d->schedulePublish();
+}
+
+void CReporterDuplicateSummary::setMaxRecords(int count)
+{
+    Q_D(CReporterDuplicateSummary);
+
+    d->maxRecords = qMax(1, count);
+}
+
+bool CReporterDuplicateSummary::record(quint64 signature, const QString &filePath)
+{
+    Q_D(CReporterDuplicateSummary);
+
+    if (d->directory.isEmpty() || !QDir().mkpath(d->summaryDirectory)) {
+        return false;
+    }
+
+    CReporterCrashInfo info(CReporterCrashInfo::fromFileName(filePath));
+    QFileInfo fileInfo(filePath);
+    qint64 time = fileInfo.exists() ? fileInfo.lastModified().toMSecsSinceEpoch()
+                                    : QDateTime::currentMSecsSinceEpoch();
+
+    QString summaryPath(d->summaryPath(signature));
+    QFile file(summaryPath);
+    bool created = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qCWarning(cr) << "Can't write duplicate summary" << summaryPath << file.errorString();
+        return false;
+    }
+
+    QTextStream stream(&file);
+    if (created) {
+        stream << info.applicationName() << '\t' << info.hwId() << '\n';
+    }
+    stream << time / 1000 << '\t' << info.pid() << '\t' << uptimeAt(time) << '\t'
+           << info.signalNumber() << '\n';
+    stream.flush();
+    file.close();
+
+    int &count = d->records[summaryPath];
+    if (++count > d->maxRecords + d->maxRecords / 4) {
+        // Trimmed in chunks so that the file isn't rewritten every time.
+        d->trim(summaryPath);
+    }
+
+    if (d->oldestRecord < 0 || time < d->oldestRecord) {
+        d->oldestRecord = time;
+        d->schedulePublish();
+    }
+
+    return true;
+}
+
+int CReporterDuplicateSummary::pendingRecords() const
+{
+    Q_D(const CReporterDuplicateSummary);
+
+    int count = 0;
+    foreach (int records, d->records) {
+        count += records;
+    }
+    return count;
+}
+
+QString CReporterDuplicateSummary::publish()
+{
+    Q_D(CReporterDuplicateSummary);
+
+    if (d->records.isEmpty()) {
+        return QString();
+    }
+
+    QString text;
+    QString hwId;
+    foreach (const QString &summaryPath, d->records.keys()) {
+        QStringList lines(readSummary(summaryPath));
+        if (lines.count() < 2) {
+            continue;
+        }
+
+        QString application(lines.first().section('\t', 0, 0));
+        if (hwId.isEmpty()) {
+            hwId = lines.first().section('\t', 1, 1);
+        }
+
+        text += QString("\n[---rich-core: duplicates %1---]\n").arg(QFileInfo(summaryPath).baseName());
+        text += "application: " + application + '\n';
+        text += QString("count: %1\n").arg(lines.count() - 1);
+        text += RecordHeader + '\n';
+        text += lines.mid(1).join('\n') + '\n';
+    }
+
+    if (text.isEmpty()) {
+        return QString();
+    }
+
+    // The "pid" of the report just makes the name unique.
+    QString name = QString("%1-%2-0-%3.rcore.lzo").arg(CReporter::DuplicateSummaryPrefix)
+            .arg(hwId.isEmpty() ? QString("unknown") : hwId)
+            .arg(QDateTime::currentMSecsSinceEpoch() / 1000 % INT_MAX);
+    // Written under a hidden name, so the report appears only when complete.
+    QString tmpPath(d->directory + "/." + name);
+    QString reportPath(d->directory + '/' + name);
+
+    if (!CReporterUtils::appendToLzo(text, tmpPath) || QFileInfo(tmpPath).size() == 0
+            || !QFile::rename(tmpPath, reportPath)) {
+        qCWarning(cr) << "Couldn't write duplicate summary report" << reportPath;
+        QFile::remove(tmpPath);
+        return QString();
+    }
+
+    foreach (const QString &summaryPath, d->records.keys()) {
+        QFile::remove(summaryPath);
+    }
+    d->records.clear();
+    d->oldestRecord = -1;
+    d->schedulePublish();
+
+    qCDebug(cr) << "Published duplicate summary" << reportPath;
+    return reportPath;
+}
+
+#include "moc_creporterduplicatesummary.cpp"
@@ -0,0 +1,105 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERDUPLICATESUMMARY_H
+#define CREPORTERDUPLICATESUMMARY_H
+
+#include <QObject>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterDuplicateSummaryPrivate;
+
+/*!
+ * @class CReporterDuplicateSummary
+ * @brief Compact records of duplicate crashes.
+ *
+ * Instead of keeping a full rich core, an occurrence of an already reported
+ * crash is stored as a line with its time, PID, uptime and signal. Records
+ * are kept in a file per crash signature under the duplicates subdirectory
+ * of the core directory, and only the newest records of each signature
+ * are retained. Once a day the records are published as a single small
+ * DuplicateSummary report in the core directory, where it is picked up for
+ * uploading like any other report.
+ */
+class CREPORTER_EXPORT CReporterDuplicateSummary : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates summaries for the core directory @a directory.
+     *
+     * @param directory Directory where the reports are published.
+     */
+    explicit CReporterDuplicateSummary(const QString &directory, QObject *parent = 0);
+    ~CReporterDuplicateSummary();
+
+    /*!
+     * @brief Returns the first core directory, or empty string if there are
+     * no core directories.
+     */
+    static QString defaultDirectory();
+
+    /*!
+     * @brief Sets time from the first record to publishing the summary.
+     *
+     * Default is one day.
+     */
+    void setPublishInterval(int msecs);
+
+    /*!
+     * @brief Sets number of records kept per signature. Default is 256.
+     */
+    void setMaxRecords(int count);
+
+    /*!
+     * @brief Records an occurrence of the crash in rich core @a filePath.
+     *
+     * The rich core itself isn't needed afterwards.
+     *
+     * @param signature Signature of the crash, see CReporterSignatureIndex.
+     * @return true on success.
+     */
+    bool record(quint64 signature, const QString &filePath);
+
+    /*!
+     * @brief Returns number of records waiting to be published.
+     */
+    int pendingRecords() const;
+
+    /*!
+     * @brief Writes all records into a summary report and clears them.
+     *
+     * @return Path of the report, or empty string if there was nothing to
+     * publish or writing failed.
+     */
+    QString publish();
+
+private:
+    Q_DISABLE_COPY(CReporterDuplicateSummary)
+    Q_DECLARE_PRIVATE(CReporterDuplicateSummary)
+    QScopedPointer<CReporterDuplicateSummaryPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void publishDue())
+};
+
+#endif // CREPORTERDUPLICATESUMMARY_H
@@ -0,0 +1,350 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QTimer>
+
+#include "creportercoreregistry.h"
+#include "creportersignatureindex.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const quint32 IndexMagic = 0x43525349; // "CRSI"
+const quint32 IndexVersion = 1;
+
+// Number of time slots the window is divided into.
+const int Slots = 24;
+const qint64 DefaultWindow = 24 * 60 * 60 * 1000;
+const int DefaultCapacity = 512;
+
+// Time to wait (ms) for further occurrences before writing the index.
+const int SaveDelay = 10 * 1000;
+
+struct Entry {
+    //! Number of the newest time slot counted in.
+    qint64 lastSlot;
+    //! Time of the latest occurrence.
+    qint64 lastSeen;
+    //! Occurrences per time slot, indexed by slot number modulo Slots.
+    quint16 counts[Slots];
+};
+
+typedef QHash<quint64, Entry> EntryHash;
+
+qint64 currentTime(qint64 time)
+{
+    return time < 0 ? QDateTime::currentMSecsSinceEpoch() : time;
+}
+} // namespace
+
+class CReporterSignatureIndexPrivate
+{
+public:
+    CReporterSignatureIndexPrivate();
+
+    void load();
+    //! @arg Drops slots that have fallen out of the window ending at @a slot.
+    void advance(Entry *entry, qint64 slot) const;
+    void evictLeastRecent();
+    void scheduleSave();
+
+    QString indexFile;
+    EntryHash entries;
+    //! @arg Length of a time slot in ms.
+    qint64 slotLength;
+    int capacity;
+    bool dirty;
+    QTimer saveTimer;
+};
+
+CReporterSignatureIndexPrivate::CReporterSignatureIndexPrivate()
+    : slotLength(DefaultWindow / Slots), capacity(DefaultCapacity), dirty(false)
+{
+    saveTimer.setSingleShot(true);
+    saveTimer.setInterval(SaveDelay);
+}
+
+void CReporterSignatureIndexPrivate::load()
+{
+    entries.clear();
+
+    QFile file(indexFile);
+    if (indexFile.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, count;
+    qint64 storedSlotLength;
+    stream >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion) {
+        qCWarning(cr) << "Ignoring incompatible signature index" << indexFile;
+        return;
+    }
+
+    stream >> storedSlotLength >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        quint64 signature;
+        Entry entry;
+        stream >> signature >> entry.lastSlot >> entry.lastSeen;
+        for (int slot = 0; slot < Slots; ++slot) {
+            stream >> entry.counts[slot];
+        }
+        entries.insert(signature, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(cr) << "Signature index" << indexFile << "is corrupted";
+        entries.clear();
+        return;
+    }
+
+    if (storedSlotLength != slotLength) {
+        // Counts can't be mapped to different slots.
+        entries.clear();
+        return;
+    }
+
+    qCDebug(cr) << "Loaded" << entries.count() << "crash signatures from" << indexFile;
+}
+
+void CReporterSignatureIndexPrivate::advance(Entry *entry, qint64 slot) const
+{
+    if (slot <= entry->lastSlot) {
+        // Also if the clock was turned back, then the newest slot is used.
+        return;
+    }
+
+    if (slot - entry->lastSlot >= Slots) {
+        memset(entry->counts, 0, sizeof(entry->counts));
+    } else {
+        for (qint64 s = entry->lastSlot + 1; s <= slot; ++s) {
+            entry->counts[s % Slots] = 0;
+        }
+    }
+    entry->lastSlot = slot;
+}
+
+void CReporterSignatureIndexPrivate::evictLeastRecent()
+{
+    EntryHash::iterator oldest = entries.end();
+    for (EntryHash::iterator it = entries.begin(); it != entries.end(); ++it) {
+        if (oldest == entries.end() || it->lastSeen < oldest->lastSeen) {
+            oldest = it;
+        }
+    }
+
+    if (oldest != entries.end()) {
+        entries.erase(oldest);
+    }
+}
+
+void CReporterSignatureIndexPrivate::scheduleSave()
+{
+    dirty = true;
+    if (!indexFile.isEmpty() && !saveTimer.isActive()) {
+        saveTimer.start();
+    }
+}
+
+CReporterSignatureIndex::CReporterSignatureIndex(const QString &indexFile, QObject *parent)
+    : QObject(parent), d_ptr(new CReporterSignatureIndexPrivate)
+{
+    Q_D(CReporterSignatureIndex);
+
+    d->indexFile = indexFile;
+    connect(&d->saveTimer, &QTimer::timeout, this, &CReporterSignatureIndex::save);
+
+    d->load();
+}
+
+CReporterSignatureIndex::~CReporterSignatureIndex()
+{
+    Q_D(CReporterSignatureIndex);
+
+    if (d->dirty) {
+        save();
+    }
+}
+
+QString CReporterSignatureIndex::defaultIndexFile()
+{
+    QStringList paths = CReporterCoreRegistry::instance()->getCoreLocationPaths();
+    return paths.isEmpty() ? QString() : paths.first() + "/crash-signatures";
+}
+
+quint64 CReporterSignatureIndex::signature(const QString &binaryName, int signalNumber,
+                                           const QByteArray &fingerprint)
+{
+    // Stable across processes unlike qHash(), which is randomly seeded.
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(binaryName.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(QByteArray::number(signalNumber));
+    hash.addData("\0", 1);
+    hash.addData(fingerprint);
+
+    quint64 signature = 0;
+    QByteArray result = hash.result();
+    for (int i = 0; i < 8; ++i) {
+        signature = (signature << 8) | static_cast<quint8>(result.at(i));
+    }
+    return signature;
+}
+
+void CReporterSignatureIndex::setWindow(qint64 msecs)
+{
+    Q_D(CReporterSignatureIndex);
+
+    qint64 slotLength = qMax(qint64(1), msecs / Slots);
+    if (slotLength != d->slotLength) {
+        d->slotLength = slotLength;
+        d->entries.clear();
+        d->scheduleSave();
+    }
+}
+
+qint64 CReporterSignatureIndex::window() const
+{
+    Q_D(const CReporterSignatureIndex);
+
+    return d->slotLength * Slots;
+}
+
+void CReporterSignatureIndex::setCapacity(int capacity)
+{
+    Q_D(CReporterSignatureIndex);
+
+    d->capacity = qMax(1, capacity);
+    while (d->entries.count() > d->capacity) {
+        d->evictLeastRecent();
+        d->scheduleSave();
+    }
+}
+
+int CReporterSignatureIndex::record(quint64 signature, qint64 time)
+{
+    Q_D(CReporterSignatureIndex);
+
+    time = currentTime(time);
+    qint64 slot = time / d->slotLength;
+
+    EntryHash::iterator it = d->entries.find(signature);
+    if (it == d->entries.end()) {
+        if (d->entries.count() >= d->capacity) {
+            d->evictLeastRecent();
+        }
+        Entry entry;
+        entry.lastSlot = slot;
+        entry.lastSeen = time;
+        memset(entry.counts, 0, sizeof(entry.counts));
+        it = d->entries.insert(signature, entry);
+    }
+
+    d->advance(&*it, slot);
+    it->lastSeen = qMax(it->lastSeen, time);
+    quint16 &current = it->counts[it->lastSlot % Slots];
+    if (current < 0xffff) {
+        ++current;
+    }
+
+    d->scheduleSave();
+
+    int total = 0;
+    for (int i = 0; i < Slots; ++i) {
+        total += it->counts[i];
+    }
+    return total;
+}
+
+int CReporterSignatureIndex::occurrences(quint64 signature, qint64 time) const
+{
+    Q_D(const CReporterSignatureIndex);
+
+    EntryHash::const_iterator it = d->entries.constFind(signature);
+    if (it == d->entries.constEnd()) {
+        return 0;
+    }
+
+    Entry entry = *it;
+    d->advance(&entry, currentTime(time) / d->slotLength);
+
+    int total = 0;
+    for (int i = 0; i < Slots; ++i) {
+        total += entry.counts[i];
+    }
+    return total;
+}
+
+int CReporterSignatureIndex::count() const
+{
+    Q_D(const CReporterSignatureIndex);
+
+    return d->entries.count();
+}
+
+bool CReporterSignatureIndex::save()
+{
+    Q_D(CReporterSignatureIndex);
+
+    d->saveTimer.stop();
+
+    if (d->indexFile.isEmpty()) {
+        return false;
+    }
+
+    QSaveFile file(d->indexFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't write signature index" << d->indexFile << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << IndexMagic << IndexVersion << d->slotLength << quint32(d->entries.count());
+    for (EntryHash::const_iterator it = d->entries.constBegin(); it != d->entries.constEnd(); ++it) {
+        stream << it.key() << it->lastSlot << it->lastSeen;
+        for (int slot = 0; slot < Slots; ++slot) {
+            stream << it->counts[slot];
+        }
+    }
+
+    if (!file.commit()) {
+        qCWarning(cr) << "Couldn't write signature index" << d->indexFile << file.errorString();
+        return false;
+    }
+
+    d->dirty = false;
+    return true;
+}
+
+#include "moc_creportersignatureindex.cpp"
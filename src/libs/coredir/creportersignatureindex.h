@@ -0,0 +1,125 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSIGNATUREINDEX_H
+#define CREPORTERSIGNATUREINDEX_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterSignatureIndexPrivate;
+
+/*!
+ * @class CReporterSignatureIndex
+ * @brief Persistent counts of crashes by crash signature.
+ *
+ * A signature identifies similar crashes, see signature(). The index counts
+ * how many times each signature has been seen within a sliding window. The
+ * window is divided into a fixed number of time slots, so each signature
+ * takes constant memory, and only the most recently seen signatures are
+ * kept. Changes are written to disk shortly after they are made, so the
+ * counts survive restarts of the process.
+ */
+class CREPORTER_EXPORT CReporterSignatureIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Opens index stored in @a indexFile.
+     *
+     * @param indexFile Path of the index. If empty, the index isn't saved.
+     */
+    explicit CReporterSignatureIndex(const QString &indexFile, QObject *parent = 0);
+
+    /*!
+     * @brief Saves pending changes.
+     */
+    ~CReporterSignatureIndex();
+
+    /*!
+     * @brief Returns the index in the core dump directory.
+     *
+     * @return Path of the index, or empty string if there are no core
+     * dump directories.
+     */
+    static QString defaultIndexFile();
+
+    /*!
+     * @brief Returns crash signature for the given crash details.
+     *
+     * @param binaryName Name of the crashed binary.
+     * @param signalNumber Signal that terminated the process.
+     * @param fingerprint Optional fingerprint of the stack trace, which
+     * distinguishes different crashes of the same binary.
+     */
+    static quint64 signature(const QString &binaryName, int signalNumber,
+                             const QByteArray &fingerprint = QByteArray());
+
+    /*!
+     * @brief Sets length of the sliding window.
+     *
+     * Counts are dropped if the window length changes. Default is one day.
+     */
+    void setWindow(qint64 msecs);
+    qint64 window() const;
+
+    /*!
+     * @brief Sets maximum number of signatures kept. Default is 512.
+     */
+    void setCapacity(int capacity);
+
+    /*!
+     * @brief Records an occurrence of @a signature.
+     *
+     * @param time Time of the occurrence in ms since epoch, current time if negative.
+     * @return Number of occurrences within the window, including this one.
+     */
+    int record(quint64 signature, qint64 time = -1);
+
+    /*!
+     * @brief Returns number of occurrences of @a signature within the window.
+     *
+     * @param time End of the window in ms since epoch, current time if negative.
+     */
+    int occurrences(quint64 signature, qint64 time = -1) const;
+
+    /*!
+     * @brief Returns number of signatures in the index.
+     */
+    int count() const;
+
+    /*!
+     * @brief Writes the index to disk right away.
+     *
+     * @return True on success.
+     */
+    bool save();
+
+private:
+    Q_DISABLE_COPY(CReporterSignatureIndex)
+    Q_DECLARE_PRIVATE(CReporterSignatureIndex)
+    QScopedPointer<CReporterSignatureIndexPrivate> d_ptr;
+};
+
+#endif // CREPORTERSIGNATUREINDEX_H
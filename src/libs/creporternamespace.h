@@ -119,6 +119,9 @@ const QString OverheatShutdownPrefix = "OverheatShutdown";
 /// Prefix for system log packages created by journal spy.
 const QString JournalSpyPrefix = QStringLiteral("JournalSpy");
 
+/// Prefix for summaries of duplicate crashes that weren't uploaded in full.
+const QString DuplicateSummaryPrefix = QStringLiteral("DuplicateSummary");
+
 // Prefixes for HW reboot logs.
 const QString HWrebootPrefix = "HWreboot";
 const QString HWSMPLPrefix = "HWSMPL";
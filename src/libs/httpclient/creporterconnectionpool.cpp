@@ -0,0 +1,181 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDebug>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSet>
+
+#include "creporterconnectionpool.h"
+#include "creportertokenbucket.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+class CReporterConnectionPoolPrivate
+{
+public:
+    CReporterConnectionPoolPrivate(CReporterConnectionPool *q);
+
+    void handleEncrypted(QNetworkReply *reply);
+    void handleReplyFinished();
+
+    QNetworkAccessManager *manager;
+    CReporterTokenBucket uploadBucket;
+    //! @arg Tracked replies that went through a TLS handshake.
+    QSet<QNetworkReply *> handshaked;
+    int requests;
+    int handshakes;
+    int reused;
+    int http2;
+
+    Q_DECLARE_PUBLIC(CReporterConnectionPool)
+    CReporterConnectionPool *q_ptr;
+};
+
+CReporterConnectionPoolPrivate::CReporterConnectionPoolPrivate(CReporterConnectionPool *q)
+    : manager(new QNetworkAccessManager(q)), requests(0), handshakes(0), reused(0), http2(0),
+      q_ptr(q)
+{
+    QObject::connect(manager, SIGNAL(encrypted(QNetworkReply *)),
+                     q, SLOT(handleEncrypted(QNetworkReply *)));
+}
+
+void CReporterConnectionPoolPrivate::handleEncrypted(QNetworkReply *reply)
+{
+    // Emitted only when a new connection completes its handshake.
+    handshakes++;
+    handshaked.insert(reply);
+}
+
+void CReporterConnectionPoolPrivate::handleReplyFinished()
+{
+    Q_Q(CReporterConnectionPool);
+
+    QNetworkReply *reply = qobject_cast<QNetworkReply *>(q->sender());
+    if (!reply) {
+        return;
+    }
+
+    requests++;
+
+    bool newConnection = handshaked.remove(reply);
+    if (!newConnection && reply->error() == QNetworkReply::NoError
+            && reply->url().scheme() == QLatin1String("https")) {
+        reused++;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    if (reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool()) {
+        http2++;
+    }
+#endif
+
+    qCDebug(cr) << "Requests:" << requests << "TLS handshakes:" << handshakes
+                << "reused connections:" << reused << "HTTP/2:" << http2;
+}
+
+CReporterConnectionPool *CReporterConnectionPool::sm_Instance = 0;
+
+CReporterConnectionPool *CReporterConnectionPool::instance()
+{
+    if (sm_Instance == 0) {
+        sm_Instance = new CReporterConnectionPool();
+    }
+    return sm_Instance;
+}
+
+void CReporterConnectionPool::freeSingleton()
+{
+    if (sm_Instance != 0) {
+        delete sm_Instance;
+        sm_Instance = 0;
+    }
+}
+
+CReporterConnectionPool::CReporterConnectionPool()
+    : d_ptr(new CReporterConnectionPoolPrivate(this))
+{
+}
+
+CReporterConnectionPool::~CReporterConnectionPool()
+{
+}
+
+QNetworkAccessManager *CReporterConnectionPool::manager() const
+{
+    Q_D(const CReporterConnectionPool);
+
+    return d->manager;
+}
+
+CReporterTokenBucket *CReporterConnectionPool::uploadBucket()
+{
+    Q_D(CReporterConnectionPool);
+
+    return &d->uploadBucket;
+}
+
+void CReporterConnectionPool::prepareRequest(QNetworkRequest &request) const
+{
+    // HTTP/1.1 connections are kept alive by default.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    // Negotiated with ALPN, falls back to HTTP/1.1 if the server can't do it.
+    request.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, true);
+#else
+    Q_UNUSED(request);
+#endif
+}
+
+void CReporterConnectionPool::trackReply(QNetworkReply *reply)
+{
+    connect(reply, SIGNAL(finished()), this, SLOT(handleReplyFinished()));
+}
+
+int CReporterConnectionPool::requestCount() const
+{
+    Q_D(const CReporterConnectionPool);
+
+    return d->requests;
+}
+
+int CReporterConnectionPool::handshakeCount() const
+{
+    Q_D(const CReporterConnectionPool);
+
+    return d->handshakes;
+}
+
+int CReporterConnectionPool::reusedConnectionCount() const
+{
+    Q_D(const CReporterConnectionPool);
+
+    return d->reused;
+}
+
+int CReporterConnectionPool::http2Count() const
+{
+    Q_D(const CReporterConnectionPool);
+
+    return d->http2;
+}
+
+#include "moc_creporterconnectionpool.cpp"
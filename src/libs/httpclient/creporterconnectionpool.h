@@ -0,0 +1,117 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCONNECTIONPOOL_H
+#define CREPORTERCONNECTIONPOOL_H
+
+#include <QObject>
+
+#include "creporterexport.h"
+
+class CReporterConnectionPoolPrivate;
+class CReporterTokenBucket;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QNetworkRequest;
+
+/*!
+ * @class CReporterConnectionPool
+ * @brief Process wide QNetworkAccessManager shared by all HTTP clients.
+ *
+ * QNetworkAccessManager keeps finished connections open and reuses them for
+ * later requests to the same server, but only for requests made through the
+ * same manager instance. Sharing one manager lets consecutive and parallel
+ * uploads skip the TCP and TLS handshakes. HTTP/2 is enabled for the
+ * requests when Qt supports it, so one connection can carry several
+ * uploads at once.
+ */
+class CREPORTER_EXPORT CReporterConnectionPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates the pool on first call and returns it.
+     */
+    static CReporterConnectionPool *instance();
+
+    /*!
+     * @brief Destroys the pool, closing all idle connections.
+     */
+    static void freeSingleton();
+
+    ~CReporterConnectionPool();
+
+    /*!
+     * @brief Returns the shared network access manager.
+     */
+    QNetworkAccessManager *manager() const;
+
+    /*!
+     * @brief Returns token bucket that limits the rate of all uploads.
+     */
+    CReporterTokenBucket *uploadBucket();
+
+    /*!
+     * @brief Sets attributes that allow connection reuse on @a request.
+     */
+    void prepareRequest(QNetworkRequest &request) const;
+
+    /*!
+     * @brief Starts collecting connection statistics of @a reply.
+     */
+    void trackReply(QNetworkReply *reply);
+
+    /*!
+     * @brief Number of requests finished through the pool.
+     */
+    int requestCount() const;
+
+    /*!
+     * @brief Number of TLS handshakes, i.e. new encrypted connections.
+     */
+    int handshakeCount() const;
+
+    /*!
+     * @brief Number of encrypted requests that used an already open
+     * connection.
+     */
+    int reusedConnectionCount() const;
+
+    /*!
+     * @brief Number of requests that were sent using HTTP/2.
+     */
+    int http2Count() const;
+
+protected:
+    CReporterConnectionPool();
+
+private:
+    Q_DISABLE_COPY(CReporterConnectionPool)
+    Q_DECLARE_PRIVATE(CReporterConnectionPool)
+    QScopedPointer<CReporterConnectionPoolPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void handleEncrypted(QNetworkReply *))
+    Q_PRIVATE_SLOT(d_func(), void handleReplyFinished())
+
+    static CReporterConnectionPool *sm_Instance;
+};
+
+#endif // CREPORTERCONNECTIONPOOL_H
@@ -0,0 +1,196 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "creportercoreregistry.h"
+#include "creporterdigestindex.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const quint32 IndexMagic = 0x43524449; // "CRDI"
+const quint32 IndexVersion = 1;
+
+struct Entry {
+    QByteArray digest;
+    qint64 size;
+    QString submission;
+    //! Upload time, msecs since epoch.
+    qint64 uploaded;
+};
+} // namespace
+
+class CReporterDigestIndexPrivate
+{
+public:
+    void load();
+
+    QString indexFile;
+    int capacity;
+    //! @arg Entries, oldest first.
+    QList<Entry> entries;
+};
+
+void CReporterDigestIndexPrivate::load()
+{
+    entries.clear();
+
+    QFile file(indexFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, count;
+    stream >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion) {
+        qCWarning(cr) << "Ignoring incompatible digest index" << indexFile;
+        return;
+    }
+
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        stream >> entry.digest >> entry.size >> entry.submission >> entry.uploaded;
+        entries << entry;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(cr) << "Digest index" << indexFile << "is corrupted";
+        entries.clear();
+    }
+}
+
+CReporterDigestIndex::CReporterDigestIndex(const QString &indexFile, int capacity)
+    : d_ptr(new CReporterDigestIndexPrivate)
+{
+    Q_D(CReporterDigestIndex);
+
+    d->indexFile = indexFile;
+    d->capacity = qMax(1, capacity);
+    d->load();
+}
+
+CReporterDigestIndex::~CReporterDigestIndex()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+QString CReporterDigestIndex::defaultIndexFile()
+{
+    QStringList paths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    if (paths.isEmpty()) {
+        return QString();
+    }
+
+    return paths.first() + "/upload-digests";
+}
+
+bool CReporterDigestIndex::containsSize(qint64 size) const
+{
+    Q_D(const CReporterDigestIndex);
+
+    foreach (const Entry &entry, d->entries) {
+        if (entry.size == size) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CReporterDigestIndex::contains(const QByteArray &digest, qint64 size,
+                                    QString *submission) const
+{
+    Q_D(const CReporterDigestIndex);
+
+    foreach (const Entry &entry, d->entries) {
+        if (entry.size == size && entry.digest == digest) {
+            if (submission) {
+                *submission = entry.submission;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CReporterDigestIndex::insert(const QByteArray &digest, qint64 size,
+                                  const QString &submission)
+{
+    Q_D(CReporterDigestIndex);
+
+    // Another process may have uploaded something in the meantime.
+    d->load();
+
+    if (contains(digest, size)) {
+        return true;
+    }
+
+    Entry entry;
+    entry.digest = digest;
+    entry.size = size;
+    entry.submission = submission;
+    entry.uploaded = QDateTime::currentMSecsSinceEpoch();
+    d->entries << entry;
+
+    while (d->entries.count() > d->capacity) {
+        d->entries.removeFirst();
+    }
+
+    QSaveFile file(d->indexFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't write digest index" << d->indexFile << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << IndexMagic << IndexVersion << quint32(d->entries.count());
+    foreach (const Entry &e, d->entries) {
+        stream << e.digest << e.size << e.submission << e.uploaded;
+    }
+
+    if (!file.commit()) {
+        qCWarning(cr) << "Couldn't write digest index" << d->indexFile << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+int CReporterDigestIndex::count() const
+{
+    Q_D(const CReporterDigestIndex);
+
+    return d->entries.count();
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERDIGESTINDEX_H
+#define CREPORTERDIGESTINDEX_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterDigestIndexPrivate;
+
+/*!
+ * @class CReporterDigestIndex
+ * @brief Persistent index of content digests of uploaded reports.
+ *
+ * The server has already accepted a report whose digest is found in the
+ * index, so uploading the same content again can be skipped. The index
+ * keeps only the most recent uploads, older entries are dropped once its
+ * capacity is reached.
+ */
+class CREPORTER_EXPORT CReporterDigestIndex
+{
+public:
+    /*!
+     * @brief Opens index stored in @a indexFile.
+     *
+     * @param capacity Maximum number of digests kept.
+     */
+    explicit CReporterDigestIndex(const QString &indexFile, int capacity = 1024);
+    ~CReporterDigestIndex();
+
+    /*!
+     * @brief Returns the index in the core dump directory.
+     *
+     * @return Path of the index, or empty string if there are no core
+     * dump directories.
+     */
+    static QString defaultIndexFile();
+
+    /*!
+     * @brief Returns true if a file of @a size bytes has been uploaded.
+     *
+     * Lets the caller skip computing the digest when the content can't be
+     * a duplicate.
+     */
+    bool containsSize(qint64 size) const;
+
+    /*!
+     * @brief Returns true if content with @a digest has been uploaded.
+     *
+     * @param submission Set to the submission URL of the upload, if any.
+     */
+    bool contains(const QByteArray &digest, qint64 size, QString *submission = 0) const;
+
+    /*!
+     * @brief Records uploaded content and saves the index.
+     *
+     * @param submission Submission URL the server gave for the upload.
+     */
+    bool insert(const QByteArray &digest, qint64 size, const QString &submission);
+
+    int count() const;
+
+private:
+    Q_DISABLE_COPY(CReporterDigestIndex)
+    Q_DECLARE_PRIVATE(CReporterDigestIndex)
+    CReporterDigestIndexPrivate *d_ptr;
+};
+
+#endif // CREPORTERDIGESTINDEX_H
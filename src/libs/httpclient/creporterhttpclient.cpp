@@ -26,8 +26,13 @@
  */
 
 #include <QAuthenticator>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QLocale>
 #include <QNetworkReply>
 #include <QDebug>
 #include <QFile>
@@ -35,23 +40,285 @@
 #include <QDir>
 #include <QSslConfiguration>
 #include <QNetworkProxy>
+#include <QSaveFile>
 #include <QTime>
+#include <QUuid>
 
+#include <algorithm>
+
+#include "creporterconnectionpool.h"
+#include "creportercoreindex.h"
 #include "creportercoreregistry.h"
+#include "creporterdigestindex.h"
 #include "creporterhttpclient.h"
 #include "creporterhttpclient_p.h"
 #include "creporterapplicationsettings.h"
+#include "creportertokenbucket.h"
 #include "creporterutils.h"
+#ifdef CREPORTER_LIBBEARER_ENABLED
+#include "creporternwsessionmgr.h"
+#endif // CREPORTER_LIBBEARER_ENABLED
 
 using CReporter::LoggingCategory::cr;
 
 static const char *clientstate_string[] = {"None", "Init", "Connecting", "Sending", "Aborting"};
 static const int CONNECTION_TIMEOUT_MS = 2 * 60 * 1000;
+// Server response to a chunk or offset query when more data is expected.
+static const int HTTP_RESUME_INCOMPLETE = 308;
+// Minimum time between throughput updates.
+static const int THROUGHPUT_INTERVAL_MS = 1000;
+
+namespace {
+/*
+ * Read-only view to a byte range of an open file. Used as the body of a
+ * chunk PUT, QNetworkAccessManager would otherwise send the file to its end.
+ *
+ * Data is read only as fast as tokens are available in the bucket. When
+ * the bucket is empty, no data is returned and readyRead() is emitted once
+ * it has been refilled, which makes QNetworkAccessManager read again.
+ *
+ * Data read the first time is added to the digest of the file, so that
+ * the file needn't be read again for computing it. Bytes are added only in
+ * order, resent data and ranges that were skipped are ignored.
+ */
+class FileRangeDevice : public QIODevice
+{
+public:
+    FileRangeDevice(QFile *file, qint64 start, qint64 length, CReporterTokenBucket *bucket,
+                    QCryptographicHash *digest, qint64 *digested, QObject *parent)
+        : QIODevice(parent), m_file(file), m_start(start), m_length(length), m_bucket(bucket),
+          m_digest(digest), m_digested(digested)
+    {
+        m_wakeup.setSingleShot(true);
+        connect(&m_wakeup, &QTimer::timeout, this, &QIODevice::readyRead);
+    }
+
+    bool isSequential() const
+    {
+        return false;
+    }
+
+    qint64 size() const
+    {
+        return m_length;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize)
+    {
+        qint64 left = m_length - pos();
+        if (left <= 0) {
+            return 0;
+        }
+
+        qint64 length = m_bucket->take(qMin(maxSize, left));
+        if (length == 0) {
+            if (!m_wakeup.isActive()) {
+                m_wakeup.start(m_bucket->msecsUntilAvailable());
+            }
+            return 0;
+        }
+
+        qint64 offset = m_start + pos();
+        if (!m_file->seek(offset)) {
+            return -1;
+        }
+
+        length = m_file->read(data, length);
+        if (length > 0 && offset <= *m_digested && *m_digested < offset + length) {
+            qint64 skip = *m_digested - offset;
+            m_digest->addData(data + skip, length - skip);
+            *m_digested = offset + length;
+        }
+        return length;
+    }
+
+    qint64 writeData(const char *data, qint64 maxSize)
+    {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+private:
+    QFile *m_file;
+    qint64 m_start;
+    qint64 m_length;
+    CReporterTokenBucket *m_bucket;
+    QCryptographicHash *m_digest;
+    qint64 *m_digested;
+    QTimer m_wakeup;
+};
+
+/*
+ * Read-only concatenation of devices. Used as multipart/form-data body of
+ * a batch upload, made of the part headers and a FileRangeDevice for each
+ * file. QHttpMultiPart can't be used, as it doesn't expect a part to return
+ * no data while the upload rate is limited.
+ */
+class ConcatDevice : public QIODevice
+{
+public:
+    explicit ConcatDevice(QObject *parent)
+        : QIODevice(parent), m_size(0)
+    {
+    }
+
+    // Takes ownership of the open @a device.
+    void append(QIODevice *device)
+    {
+        device->setParent(this);
+        connect(device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+        m_offsets << m_size;
+        m_devices << device;
+        m_size += device->size();
+    }
+
+    // Appends @a data as is.
+    void append(const QByteArray &data)
+    {
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(data);
+        buffer->open(QIODevice::ReadOnly);
+        append(buffer);
+    }
+
+    bool isSequential() const
+    {
+        return false;
+    }
+
+    qint64 size() const
+    {
+        return m_size;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize)
+    {
+        qint64 total = 0;
+        int index = std::upper_bound(m_offsets.constBegin(), m_offsets.constEnd(), pos())
+                    - m_offsets.constBegin() - 1;
+
+        while (total < maxSize && index >= 0 && index < m_devices.count()) {
+            QIODevice *device = m_devices.at(index);
+            qint64 offset = pos() + total - m_offsets.at(index);
+            if (offset >= device->size()) {
+                index++;
+                continue;
+            }
+
+            if (!device->seek(offset)) {
+                return -1;
+            }
+            qint64 length = device->read(data + total, qMin(maxSize - total,
+                                                            device->size() - offset));
+            if (length < 0) {
+                return -1;
+            }
+            if (length == 0) {
+                // Rate limited, the device sends readyRead() when it can continue.
+                break;
+            }
+            total += length;
+        }
+
+        return total;
+    }
+
+    qint64 writeData(const char *data, qint64 maxSize)
+    {
+        Q_UNUSED(data);
+        Q_UNUSED(maxSize);
+        return -1;
+    }
+
+private:
+    QList<QIODevice *> m_devices;
+    QList<qint64> m_offsets;
+    qint64 m_size;
+};
+
+// Computes digest of a file by reading it in small blocks.
+QByteArray fileDigest(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash digest(QCryptographicHash::Sha256);
+    if (!digest.addData(&file)) {
+        return QByteArray();
+    }
+    return digest.result();
+}
+
+/*
+ * Parses Retry-After header, which is either a delay in seconds or an
+ * HTTP date. Returns the delay in seconds, or -1 if the value isn't valid.
+ */
+int parseRetryAfter(const QByteArray &value)
+{
+    bool ok;
+    int seconds = value.trimmed().toInt(&ok);
+    if (ok) {
+        return seconds >= 0 ? seconds : -1;
+    }
+
+    QDateTime date = QLocale::c().toDateTime(QString::fromLatin1(value.trimmed()),
+                                             "ddd, dd MMM yyyy HH:mm:ss 'GMT'");
+    if (!date.isValid()) {
+        return -1;
+    }
+    date.setTimeSpec(Qt::UTC);
+
+    return static_cast<int>(qMax(qint64(0), QDateTime::currentDateTimeUtc().secsTo(date)));
+}
+
+// Returns upload rate limit of the current network connection in bytes per second.
+qint64 uploadRateLimit()
+{
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+    int rate = settings->wlanUploadRate();
+
+#ifdef CREPORTER_LIBBEARER_ENABLED
+    switch (CReporterNwSessionMgr::bearerType()) {
+    case CReporterNwSessionMgr::EthernetBearer:
+        rate = settings->ethernetUploadRate();
+        break;
+    case CReporterNwSessionMgr::MobileBearer:
+        rate = settings->mobileUploadRate();
+        break;
+    case CReporterNwSessionMgr::UsbBearer:
+        rate = settings->usbUploadRate();
+        break;
+    default:
+        // WLAN, or unknown which is most likely WLAN as well.
+        break;
+    }
+#endif // CREPORTER_LIBBEARER_ENABLED
+
+    return qint64(rate) * 1024;
+}
+} // namespace
 
 CReporterHttpClientPrivate::CReporterHttpClientPrivate(CReporterHttpClient *parent)
     : QObject(parent),
       m_manager(0),
       m_reply(0),
+      m_uploadFile(0),
+      m_chunkDevice(0),
+      m_resumable(false),
+      m_chunkSize(0),
+      m_chunkStart(0),
+      m_digestIndex(0),
+      m_digest(QCryptographicHash::Sha256),
+      m_digested(0),
+      m_duplicate(false),
+      m_batch(false),
+      m_retryAfter(-1),
+      m_throughputBytes(0),
       m_connectionTimeout(this),
       q_ptr(parent)
 {
@@ -70,14 +337,34 @@ CReporterHttpClientPrivate::~CReporterHttpClientPrivate()
         m_reply = 0;
     }
 
-    delete m_manager;
+    // Shared by all clients, owned by the pool.
     m_manager = 0;
+
+    closeUploadFile();
+    qDeleteAll(m_batchDigests);
+    m_batchDigests.clear();
+
+    delete m_digestIndex;
+    m_digestIndex = 0;
 }
 
 void CReporterHttpClientPrivate::init(bool deleteAfterSending)
 {
     qCDebug(cr) << "Initiating HTTP session.";
     m_deleteFileFlag = deleteAfterSending;
+    m_resumable = CReporterApplicationSettings::instance()->resumableUploads();
+    m_chunkSize = CReporterApplicationSettings::instance()->uploadChunkSize();
+
+    qint64 rate = uploadRateLimit();
+    qCDebug(cr) << "Upload rate limit:" << rate / 1024 << "KiB/s";
+    CReporterConnectionPool::instance()->uploadBucket()->setRate(rate);
+
+    delete m_digestIndex;
+    m_digestIndex = 0;
+    QString digestIndexFile(CReporterDigestIndex::defaultIndexFile());
+    if (!digestIndexFile.isEmpty()) {
+        m_digestIndex = new CReporterDigestIndex(digestIndexFile);
+    }
 
     if (CReporterApplicationSettings::instance()->useProxy()) {
         qCDebug(cr) << "Network proxy defined.";
@@ -90,8 +377,7 @@ void CReporterHttpClientPrivate::init(bool deleteAfterSending)
     }
 
     if (m_manager == 0) {
-        m_manager = new QNetworkAccessManager(q_ptr);
-        Q_CHECK_PTR(m_manager);
+        m_manager = CReporterConnectionPool::instance()->manager();
 
         connect(m_manager, SIGNAL(authenticationRequired(QNetworkReply *, QAuthenticator *)),
                 this, SLOT(handleAuthenticationRequired(QNetworkReply *, QAuthenticator *)));
@@ -108,8 +394,174 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
         return false;
     }
 
+    // Set file to be the current.
+    m_currentFile.setFile(file);
+    m_retryAfter = -1;
+    qCDebug(cr) << "File to upload:" << m_currentFile.absoluteFilePath();
+    qCDebug(cr) << "File size:" << m_currentFile.size() / 1024 << "kB's";
+
+    m_digest.reset();
+    m_digested = 0;
+    m_duplicate = false;
+
+    // Hash the file up front only if an uploaded file has the same size.
+    if (m_digestIndex && m_digestIndex->containsSize(m_currentFile.size())) {
+        QByteArray digest = fileDigest(m_currentFile.absoluteFilePath());
+        if (!digest.isEmpty() && m_digestIndex->contains(digest, m_currentFile.size(),
+                                                         &m_duplicateOf)) {
+            qCDebug(cr) << "Content of" << m_currentFile.fileName() << "has already been uploaded.";
+            m_duplicate = true;
+            // Finish asynchronously like a real request.
+            QTimer::singleShot(0, this, SLOT(finishDuplicate()));
+            stateChange(CReporterHttpClient::Connecting);
+            return true;
+        }
+    }
+
+    // For PUT, we need to append file name to the path.
+    QNetworkRequest request(newRequest(CReporterApplicationSettings::instance()->serverPath() +
+                                       "/" + m_currentFile.fileName()));
+
+    if (!createPutRequest(request)) {
+        qCWarning(cr) << "Failed to create network request.";
+        return false;
+    }
+    m_request = request;
+
+    bool sent;
+    if (m_resumable && m_uploadFile->size() > 0) {
+        // Confirm the offset with the server only when resuming.
+        if (loadUploadOffset() > 0) {
+            sent = sendOffsetQuery();
+        } else {
+            sent = sendChunk(0);
+        }
+    } else {
+        /* QNetworkAccessManager reads random-access devices in small chunks
+         * as the data is sent, so the file is never loaded into memory as a
+         * whole. */
+        m_chunkStart = 0;
+        m_chunkDevice = new FileRangeDevice(m_uploadFile, 0, m_uploadFile->size(),
+                                            CReporterConnectionPool::instance()->uploadBucket(),
+                                            &m_digest, &m_digested, this);
+        m_chunkDevice->open(QIODevice::ReadOnly);
+        sent = startReply(m_manager->put(request, m_chunkDevice));
+    }
+
+    if (!sent) {
+        closeUploadFile();
+        return false;
+    }
+
+    emit q_ptr->uploadStateChanged(m_currentFile.absoluteFilePath(),
+                                   CReporterCoreIndex::Uploading);
+
+    stateChange(CReporterHttpClient::Connecting);
+    return true;
+}
+
+bool CReporterHttpClientPrivate::createBatchRequest(const QStringList &files)
+{
+    Q_ASSERT(m_manager != NULL);
+    qCDebug(cr) << "Create new batch request of" << files.count() << "files.";
+
+    if (m_clientState != CReporterHttpClient::Init || files.isEmpty()) {
+        return false;
+    }
+
+    m_batch = true;
+    m_batchFiles = files;
+    m_batchDuplicates.clear();
+    m_batchErrors.clear();
+    m_batchError.clear();
+    m_retryAfter = -1;
+
+    QByteArray boundary("crash-reporter-" + QUuid::createUuid().toRfc4122().toHex());
+    ConcatDevice *body = new ConcatDevice(this);
+    QStringList sentFiles;
+
+    for (int i = 0; i < files.count(); ++i) {
+        const QString &filePath = files.at(i);
+        QFileInfo fi(filePath);
+        CReporterStreamDigest *digest = new CReporterStreamDigest;
+
+        if (m_digestIndex && m_digestIndex->containsSize(fi.size())) {
+            digest->known = fileDigest(filePath);
+            QString submission;
+            if (!digest->known.isEmpty()
+                    && m_digestIndex->contains(digest->known, fi.size(), &submission)) {
+                qCDebug(cr) << "Content of" << fi.fileName() << "has already been uploaded.";
+                m_batchDuplicates.insert(filePath, submission);
+                delete digest;
+                continue;
+            }
+            // Already known, don't digest again while sending.
+            digest->digested = fi.size();
+        }
+
+        QFile *file = new QFile(filePath, body);
+        if (!file->open(QIODevice::ReadOnly)) {
+            qCWarning(cr) << "Couldn't open" << filePath << file->errorString();
+            m_batchErrors.insert(filePath, file->errorString());
+            delete file;
+            delete digest;
+            continue;
+        }
+        m_batchDigests.insert(filePath, digest);
+
+        /* Files are read as the request is sent, at the same rate as single
+         * uploads, and digested on the way. */
+        FileRangeDevice *content = new FileRangeDevice(
+                file, 0, file->size(), CReporterConnectionPool::instance()->uploadBucket(),
+                &digest->hash, &digest->digested, 0);
+        content->open(QIODevice::ReadOnly);
+
+        /* Reports in different directories may have the same file name,
+         * so each part is named by its index in the batch. */
+        body->append("--" + boundary + "\r\n"
+                     "Content-Type: application/octet-stream\r\n"
+                     "Content-Disposition: form-data; name=\"" + batchPartName(i).toLatin1()
+                     + "\"; filename=\"" + QFile::encodeName(fi.fileName()) + "\"\r\n\r\n");
+        body->append(content);
+        body->append("\r\n");
+        sentFiles << filePath;
+    }
+    body->append("--" + boundary + "--\r\n");
+    body->open(QIODevice::ReadOnly);
+
+    if (sentFiles.isEmpty()) {
+        delete body;
+        // Nothing to send, finish asynchronously like a real request.
+        QTimer::singleShot(0, this, SLOT(finishBatch()));
+        stateChange(CReporterHttpClient::Connecting);
+        return true;
+    }
+
+    QNetworkRequest request(newRequest(CReporterApplicationSettings::instance()->serverPath()));
+    request.setHeader(QNetworkRequest::ContentTypeHeader,
+                      "multipart/form-data; boundary=\"" + boundary + "\"");
+    request.setHeader(QNetworkRequest::ContentLengthHeader, body->size());
+    if (!startReply(m_manager->post(request, body))) {
+        delete body;
+        m_batch = false;
+        m_batchFiles.clear();
+        qDeleteAll(m_batchDigests);
+        m_batchDigests.clear();
+        return false;
+    }
+    body->setParent(m_reply);
+
+    foreach (const QString &filePath, sentFiles) {
+        emit q_ptr->uploadStateChanged(filePath, CReporterCoreIndex::Uploading);
+    }
+
+    stateChange(CReporterHttpClient::Connecting);
+    return true;
+}
+
+QNetworkRequest CReporterHttpClientPrivate::newRequest(const QString &path) const
+{
     QNetworkRequest request;
-    QByteArray dataToSend;
 
     // Set server URL and port.
     QUrl url(CReporterApplicationSettings::instance()->serverUrl());
@@ -123,16 +575,7 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
         request.setSslConfiguration(ssl);
     }
 
-    // Set file to be the current.
-    m_currentFile.setFile(file);
-    qCDebug(cr) << "File to upload:" << m_currentFile.absoluteFilePath();
-    qCDebug(cr) << "File size:" << m_currentFile.size() / 1024 << "kB's";
-
-    // For PUT, we need to append file name to the path.
-    QString serverPath = CReporterApplicationSettings::instance()->serverPath() +
-                         "/" + m_currentFile.fileName();
-
-    url.setPath(serverPath);
+    url.setPath(path);
 
     url.setQuery("uuid=" + CReporterUtils::deviceUid() +
                  "&model=" + CReporterUtils::deviceModel());
@@ -140,18 +583,36 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
     request.setUrl(url);
     qCDebug(cr) << "Upload URL:" << url.toString();
 
-    if (!createPutRequest(request, dataToSend)) {
-        qCWarning(cr) << "Failed to create network request.";
-        return false;
+    request.setRawHeader("User-Agent", "crash-reporter");
+    request.setRawHeader("Accept", "*/*");
+
+    CReporterConnectionPool::instance()->prepareRequest(request);
+
+    return request;
+}
+
+QStringList CReporterHttpClientPrivate::requestFiles() const
+{
+    if (m_batch) {
+        return m_batchFiles;
     }
 
-    // Send request and connect signal/ slots.
-    m_reply = m_manager->put(request, dataToSend);
+    return QStringList(m_currentFile.absoluteFilePath());
+}
+
+bool CReporterHttpClientPrivate::startReply(QNetworkReply *reply)
+{
+    m_reply = reply;
 
     if (m_reply == 0) {
         return false;
     }
 
+    /* The manager outlives this client, so the replies need to be deleted
+     * explicitly. Aborted replies emit finished() too. */
+    connect(m_reply, SIGNAL(finished()), m_reply, SLOT(deleteLater()));
+    CReporterConnectionPool::instance()->trackReply(m_reply);
+
     // Connect QNetworkReply signals.
     connect(m_reply, SIGNAL(sslErrors(QList<QSslError>)),
             this, SLOT(handleSslErrors(QList<QSslError>)));
@@ -162,10 +623,114 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
             this, &CReporterHttpClientPrivate::handleUploadProgress);
     m_connectionTimeout.start();
 
-    stateChange(CReporterHttpClient::Connecting);
+    m_throughputTimer.start();
+    m_throughputBytes = 0;
+
     return true;
 }
 
+bool CReporterHttpClientPrivate::sendOffsetQuery()
+{
+    qCDebug(cr) << "Querying upload offset of" << m_currentFile.fileName();
+
+    QNetworkRequest request(m_request);
+    request.setHeader(QNetworkRequest::ContentLengthHeader, 0);
+    request.setRawHeader("Content-Range", "bytes */" + QByteArray::number(m_uploadFile->size()));
+
+    m_chunkStart = 0;
+    return startReply(m_manager->put(request, QByteArray()));
+}
+
+bool CReporterHttpClientPrivate::sendChunk(qint64 offset)
+{
+    qint64 total = m_uploadFile->size();
+    qint64 length = qMin(m_chunkSize, total - offset);
+    if (length <= 0) {
+        return false;
+    }
+
+    qCDebug(cr) << "Sending" << m_currentFile.fileName() << "bytes" << offset
+                << "-" << offset + length - 1 << "of" << total;
+
+    if (m_chunkDevice) {
+        // Finished reply may still hold a reference until it's deleted.
+        m_chunkDevice->deleteLater();
+    }
+    m_chunkDevice = new FileRangeDevice(m_uploadFile, offset, length,
+                                        CReporterConnectionPool::instance()->uploadBucket(),
+                                        &m_digest, &m_digested, this);
+    m_chunkDevice->open(QIODevice::ReadOnly);
+
+    QNetworkRequest request(m_request);
+    request.setHeader(QNetworkRequest::ContentLengthHeader, length);
+    request.setRawHeader("Content-Range", QString("bytes %1-%2/%3")
+                         .arg(offset).arg(offset + length - 1).arg(total).toLatin1());
+
+    m_chunkStart = offset;
+    return startReply(m_manager->put(request, m_chunkDevice));
+}
+
+bool CReporterHttpClientPrivate::continueUpload()
+{
+    // Server replies to a chunk with the range it has received so far.
+    qint64 offset = 0;
+    QByteArray range = m_reply->rawHeader("Range");
+    if (range.startsWith("bytes=0-")) {
+        bool ok;
+        offset = range.mid(8).toLongLong(&ok) + 1;
+        if (!ok) {
+            offset = 0;
+        }
+    }
+
+    qCDebug(cr) << "Server has received" << offset << "bytes of" << m_currentFile.fileName();
+
+    if (offset >= m_uploadFile->size()) {
+        qCWarning(cr) << "Server didn't complete upload of" << m_currentFile.fileName();
+        return false;
+    }
+
+    saveUploadOffset(offset);
+    return sendChunk(offset);
+}
+
+QString CReporterHttpClientPrivate::uploadOffsetFile() const
+{
+    return CReporterUtils::uploadOffsetFile(m_currentFile.absoluteFilePath());
+}
+
+qint64 CReporterHttpClientPrivate::loadUploadOffset() const
+{
+    QFile file(uploadOffsetFile());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    // Offset, file size and modification time of the file.
+    QList<QByteArray> fields = file.readLine().trimmed().split(' ');
+    if (fields.count() != 3
+            || fields.at(1).toLongLong() != m_currentFile.size()
+            || fields.at(2).toLongLong() != m_currentFile.lastModified().toMSecsSinceEpoch()) {
+        qCDebug(cr) << "Ignoring outdated upload offset of" << m_currentFile.fileName();
+        return 0;
+    }
+
+    return fields.at(0).toLongLong();
+}
+
+void CReporterHttpClientPrivate::saveUploadOffset(qint64 offset) const
+{
+    QSaveFile file(uploadOffsetFile());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't save upload offset:" << file.errorString();
+        return;
+    }
+
+    file.write(QString("%1 %2 %3\n").arg(offset).arg(m_currentFile.size())
+               .arg(m_currentFile.lastModified().toMSecsSinceEpoch()).toLatin1());
+    file.commit();
+}
+
 void CReporterHttpClientPrivate::cancel()
 {
     stateChange(CReporterHttpClient::Aborting);
@@ -175,6 +740,10 @@ void CReporterHttpClientPrivate::cancel()
         // Abort ongoing transactions.
         m_reply->abort();
         m_reply = 0;
+
+        foreach (const QString &filePath, requestFiles()) {
+            emit q_ptr->uploadStateChanged(filePath, CReporterCoreIndex::NotUploaded);
+        }
     }
     // Clean up.
     handleFinished();
@@ -183,7 +752,10 @@ void CReporterHttpClientPrivate::cancel()
 void CReporterHttpClientPrivate::handleAuthenticationRequired(QNetworkReply *reply,
         QAuthenticator *authenticator)
 {
-    Q_UNUSED(reply)
+    // The manager is shared, ignore requests of the other clients.
+    if (reply != m_reply) {
+        return;
+    }
 
     qCDebug(cr) << "Fill in the credentials.";
 
@@ -213,42 +785,73 @@ void CReporterHttpClientPrivate::handleError(QNetworkReply::NetworkError error)
         // Finished is emitted by QNetworkReply after this, inidicating that
         // the connection is over.
         QString errorString = m_reply->errorString();
+        int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (m_resumable && status >= 400 && status < 500) {
+            // Server refused the range, start from the beginning next time.
+            QFile::remove(uploadOffsetFile());
+        }
+        if (m_reply->hasRawHeader("Retry-After")) {
+            m_retryAfter = parseRetryAfter(m_reply->rawHeader("Retry-After"));
+        }
         m_reply = 0;
         qCWarning(cr) << "Upload failed. Error code:" << error << "," << errorString;
-        emit uploadError(m_currentFile.fileName(), errorString);
+        foreach (const QString &filePath, requestFiles()) {
+            emit q_ptr->uploadStateChanged(filePath, CReporterCoreIndex::UploadFailed);
+        }
+        if (m_batch) {
+            m_batchError = errorString;
+            emit uploadError(QString(), errorString);
+        } else {
+            emit uploadError(m_currentFile.fileName(), errorString);
+        }
     }
 }
 
-void CReporterHttpClientPrivate::parseReply()
+QJsonObject CReporterHttpClientPrivate::readReply()
 {
     if (!m_reply) {
         qCWarning(cr) << "Server reply is NULL";
-        return;
+        return QJsonObject();
     }
 
     if (!m_reply->open(QIODevice::ReadOnly)) {
         qCWarning(cr) << "Couldn't open server reply for reading.";
-        return;
+        return QJsonObject();
     }
 
     QJsonDocument reply = QJsonDocument::fromJson(m_reply->readAll());
     if (reply.isNull() || !reply.isObject()) {
         qCWarning(cr) << "Error parsing JSON server reply.";
-        return;
+        return QJsonObject();
     }
 
-    QJsonObject json = reply.object();
+    return reply.object();
+}
+
+QString CReporterHttpClientPrivate::submissionUrl(const QJsonObject &json) const
+{
     int submissionId = static_cast<int>(json.value("submission_id").toDouble(0));
     if (submissionId == 0) {
         qCWarning(cr) << "Failed to parse submission id from JSON.";
-        return;
+        return QString();
     }
 
-    QUrl submissionUrl(CReporterApplicationSettings::instance()->serverUrl());
-    submissionUrl.setPort(CReporterApplicationSettings::instance()->serverPort());
-    submissionUrl.setPath("/");
-    submissionUrl.setFragment(QString("submissions/%1").arg(submissionId));
+    QUrl url(CReporterApplicationSettings::instance()->serverUrl());
+    url.setPort(CReporterApplicationSettings::instance()->serverPort());
+    url.setPath("/");
+    url.setFragment(QString("submissions/%1").arg(submissionId));
+
+    return url.toString();
+}
+
+QString CReporterHttpClientPrivate::batchPartName(int index)
+{
+    return QString("file%1").arg(index);
+}
 
+void CReporterHttpClientPrivate::appendUploadLog(const QString &fileName,
+                                                 const QString &submission, const QString &note)
+{
     QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
     QFile uploadlog(corePath + "/uploadlog");
     if (!uploadlog.open(QIODevice::WriteOnly | QIODevice::Append)) {
@@ -257,7 +860,11 @@ void CReporterHttpClientPrivate::parseReply()
     }
 
     QTextStream stream(&uploadlog);
-    stream << m_currentFile.fileName() << ' ' << submissionUrl.toString() << '\n';
+    stream << fileName << ' ' << submission;
+    if (!note.isEmpty()) {
+        stream << ' ' << note;
+    }
+    stream << '\n';
 
     uploadlog.close();
 }
@@ -268,23 +875,159 @@ void CReporterHttpClientPrivate::handleFinished()
 
     m_connectionTimeout.stop();
 
+    if (m_batch) {
+        finishBatch();
+        return;
+    }
+
+    if (m_reply && m_resumable && m_clientState != CReporterHttpClient::Aborting
+            && m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()
+               == HTTP_RESUME_INCOMPLETE) {
+        if (continueUpload()) {
+            return;
+        }
+
+        emit q_ptr->uploadStateChanged(m_currentFile.absoluteFilePath(),
+                                       CReporterCoreIndex::UploadFailed);
+        emit uploadError(m_currentFile.fileName(), "Resuming upload failed");
+        m_reply = 0;
+    }
+
+    // The reply doesn't need the data any longer, release the file.
+    closeUploadFile();
+
     if (m_reply) {
         // Upload was successful.
-        parseReply();
+        QString submission = submissionUrl(readReply());
+        if (!submission.isEmpty()) {
+            appendUploadLog(m_currentFile.fileName(), submission);
+        }
+        QFile::remove(uploadOffsetFile());
 
-        if (m_deleteFileFlag) {
-            // Remove file if delete was requested.
-            CReporterUtils::removeFile(m_currentFile.absoluteFilePath());
+        // Part of the file was sent in an earlier session when resuming.
+        QByteArray digest = m_digested == m_currentFile.size()
+                            ? m_digest.result() : fileDigest(m_currentFile.absoluteFilePath());
+        if (m_digestIndex && !digest.isEmpty()) {
+            m_digestIndex->insert(digest, m_currentFile.size(), submission);
         }
+
+        completeUpload(m_currentFile.absoluteFilePath());
     }
 
-    // QNetworkreply objects are owned by QNetworkAccessManager and deleted along with it.
+    // Reply deletes itself after finished().
     m_reply = 0;
+    m_duplicate = false;
+
+    stateChange(CReporterHttpClient::Init);
+    emit finished();
+}
+
+void CReporterHttpClientPrivate::finishDuplicate()
+{
+    // Cancelled meanwhile.
+    if (m_clientState != CReporterHttpClient::Connecting || !m_duplicate) {
+        return;
+    }
+
+    appendUploadLog(m_currentFile.fileName(), m_duplicateOf, "(duplicate)");
+    m_duplicate = false;
+    emit q_ptr->updateProgress(100);
+
+    completeUpload(m_currentFile.absoluteFilePath());
 
     stateChange(CReporterHttpClient::Init);
     emit finished();
 }
 
+void CReporterHttpClientPrivate::finishBatch()
+{
+    // Cancelled meanwhile.
+    if (!m_batch) {
+        return;
+    }
+
+    // Reply is cleared on errors.
+    bool sent = m_reply != 0;
+    QString requestError = m_batchError;
+    if (requestError.isEmpty()) {
+        requestError = m_clientState == CReporterHttpClient::Aborting
+                       ? "Upload cancelled" : "Upload failed";
+    }
+
+    /* Server replies with the result of each file:
+     * {"files": [{"name": <part name>, "submission_id": <id>},
+     *            {"name": <part name>, "error": <reason>}, ...]} */
+    QHash<QString, QJsonObject> results;
+    if (sent) {
+        foreach (const QJsonValue &value, readReply().value("files").toArray()) {
+            QJsonObject result = value.toObject();
+            results.insert(result.value("name").toString(), result);
+        }
+    }
+
+    QStringList files = m_batchFiles;
+    m_batch = false;
+    m_batchFiles.clear();
+    // Reply deletes itself after finished().
+    m_reply = 0;
+
+    for (int i = 0; i < files.count(); ++i) {
+        const QString &filePath = files.at(i);
+        QFileInfo fi(filePath);
+        QString part(batchPartName(i));
+        QString error;
+
+        if (m_batchDuplicates.contains(filePath)) {
+            appendUploadLog(fi.fileName(), m_batchDuplicates.value(filePath), "(duplicate)");
+            completeUpload(filePath);
+        } else if (m_batchErrors.contains(filePath)) {
+            error = m_batchErrors.value(filePath);
+        } else if (!sent) {
+            error = requestError;
+        } else if (!results.contains(part)) {
+            error = "Missing from server reply";
+        } else if (results.value(part).contains("error")) {
+            error = results.value(part).value("error").toString("Rejected by server");
+        } else {
+            QString submission = submissionUrl(results.value(part));
+            if (!submission.isEmpty()) {
+                appendUploadLog(fi.fileName(), submission);
+            }
+            CReporterStreamDigest *digest = m_batchDigests.value(filePath);
+            QByteArray result = digest ? digest->result(fi.size()) : QByteArray();
+            if (m_digestIndex && !result.isEmpty()) {
+                m_digestIndex->insert(result, fi.size(), submission);
+            }
+            completeUpload(filePath);
+        }
+
+        if (!error.isEmpty()) {
+            qCWarning(cr) << "Upload of" << fi.fileName() << "failed:" << error;
+            if (sent) {
+                emit q_ptr->uploadStateChanged(filePath, CReporterCoreIndex::UploadFailed);
+            }
+        }
+        emit q_ptr->fileFinished(filePath, error.isEmpty(), error);
+    }
+
+    m_batchDuplicates.clear();
+    m_batchErrors.clear();
+    qDeleteAll(m_batchDigests);
+    m_batchDigests.clear();
+
+    stateChange(CReporterHttpClient::Init);
+    emit finished();
+}
+
+void CReporterHttpClientPrivate::completeUpload(const QString &filePath)
+{
+    if (m_deleteFileFlag) {
+        // Remove file if delete was requested.
+        CReporterUtils::removeFile(filePath);
+    }
+    emit q_ptr->uploadStateChanged(filePath, CReporterCoreIndex::Uploaded);
+}
+
 void CReporterHttpClientPrivate::handleUploadProgress(qint64 bytesSent, qint64 bytesTotal)
 {
     qCDebug(cr) << "Sent:" << bytesSent << "Total:" << bytesTotal;
@@ -301,11 +1044,26 @@ void CReporterHttpClientPrivate::handleUploadProgress(qint64 bytesSent, qint64 b
         stateChange(CReporterHttpClient::Sending);
     }
 
+    // Chunks report progress within the chunk.
+    if (m_resumable) {
+        bytesSent += m_chunkStart;
+        bytesTotal = m_currentFile.size();
+    }
+
     if (bytesTotal != 0) {
         int done = (int)((bytesSent * 100) / bytesTotal);
         qCDebug(cr) << "Done:" << done << "%";
         emit q_ptr->updateProgress(done);
     }
+
+    qint64 elapsed = m_throughputTimer.elapsed();
+    if (elapsed >= THROUGHPUT_INTERVAL_MS) {
+        qint64 throughput = (bytesSent - m_chunkStart - m_throughputBytes) * 1000 / elapsed;
+        qCDebug(cr) << "Throughput:" << throughput / 1024 << "KiB/s";
+        emit q_ptr->updateThroughput(throughput);
+        m_throughputTimer.restart();
+        m_throughputBytes = bytesSent - m_chunkStart;
+    }
 }
 
 void CReporterHttpClientPrivate::stateChange(CReporterHttpClient::State nextState)
@@ -316,26 +1074,39 @@ void CReporterHttpClientPrivate::stateChange(CReporterHttpClient::State nextStat
     emit stateChanged(m_clientState);
 }
 
-bool CReporterHttpClientPrivate::createPutRequest(QNetworkRequest &request, QByteArray &dataToSend)
+bool CReporterHttpClientPrivate::createPutRequest(QNetworkRequest &request)
 {
-    QFile file(m_currentFile.absoluteFilePath());
+    closeUploadFile();
+
+    m_uploadFile = new QFile(m_currentFile.absoluteFilePath(), this);
     // Abort, if file doesn't exist or IO error.
-    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+    if (!m_uploadFile->exists() || !m_uploadFile->open(QIODevice::ReadOnly)) {
+        closeUploadFile();
         return false;
     }
 
-    // Append file.
-    dataToSend += file.readAll();
-    file.close();
-
     // Construct HTTP Headers.
-    request.setRawHeader("User-Agent", "crash-reporter");
-    request.setRawHeader("Accept", "*/*");
-    request.setHeader(QNetworkRequest::ContentLengthHeader, dataToSend.size());
+    request.setHeader(QNetworkRequest::ContentLengthHeader, m_uploadFile->size());
 
     return true;
 }
 
+void CReporterHttpClientPrivate::closeUploadFile()
+{
+    if (m_chunkDevice) {
+        m_chunkDevice->close();
+        m_chunkDevice->deleteLater();
+        m_chunkDevice = 0;
+    }
+
+    if (m_uploadFile) {
+        m_uploadFile->close();
+        // May still be referenced by the reply from within its signal emission.
+        m_uploadFile->deleteLater();
+        m_uploadFile = 0;
+    }
+}
+
 CReporterHttpClient::CReporterHttpClient(QObject *parent)
     : QObject(parent),
       d_ptr(new CReporterHttpClientPrivate(this))
@@ -364,6 +1135,11 @@ CReporterHttpClient::State CReporterHttpClient::state() const
     return d_ptr->m_clientState;
 }
 
+int CReporterHttpClient::retryAfter() const
+{
+    return d_ptr->m_retryAfter;
+}
+
 QString CReporterHttpClient::stateToString(CReporterHttpClient::State state) const
 {
     return  QString(clientstate_string[state]);
@@ -377,6 +1153,14 @@ bool CReporterHttpClient::upload(const QString &file)
     return d->createRequest(file);
 }
 
+bool CReporterHttpClient::uploadBatch(const QStringList &files)
+{
+    Q_D(CReporterHttpClient);
+    qCDebug(cr) << "Batch upload requested.";
+
+    return d->createBatchRequest(files);
+}
+
 void CReporterHttpClient::cancel()
 {
     Q_D(CReporterHttpClient);
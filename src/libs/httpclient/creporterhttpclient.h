@@ -26,7 +26,9 @@
 #define CREPORTERHTTPCLIENT_H
 
 #include <QObject>
+#include <QStringList>
 
+#include "creportercoreindex.h"
 #include "creporterexport.h"
 
 class CReporterHttpClientPrivate;
@@ -86,6 +88,15 @@ public:
      */
     State state() const;
 
+    /*!
+     * @brief Returns delay the server asked to wait before retrying a
+     * failed upload.
+     *
+     * @return Delay in seconds from Retry-After header of the last failed
+     *  request, or -1 if the server didn't give one.
+     */
+    int retryAfter() const;
+
     /*! @brief Returns state in string format.
      *
      * @return State as string.
@@ -116,6 +127,36 @@ Q_SIGNALS:
      */
     void updateProgress(int done);
 
+    /*!
+     * @brief Sent about once a second while data is uploaded.
+     *
+     * @param bytesPerSecond Upload speed since the previous update.
+     */
+    void updateThroughput(qint64 bytesPerSecond);
+
+    /*!
+     * @brief Sent for each file of a batch upload, before finished().
+     *
+     * @param file Path to the file.
+     * @param success True, if the server accepted the file.
+     * @param errorString Reason of the failure.
+     *
+     * @sa uploadBatch()
+     */
+    void fileFinished(const QString &file, bool success, const QString &errorString);
+
+    /*!
+     * @brief Sent when upload state of @a file changes.
+     *
+     * The client doesn't persist the state itself; the owner of the core
+     * index is expected to store it. Uploaded is sent also when the file
+     * was removed after sending.
+     *
+     * @param file Path to the file.
+     * @param state New upload state.
+     */
+    void uploadStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
+
     /*!
      * @brief Emitted, when client's internal state changes.
      *
@@ -134,6 +175,17 @@ public Q_SLOTS:
      */
     bool upload(const QString &file);
 
+    /*!
+     * @brief Uploads several files in one multipart/form-data POST request.
+     *
+     * Files are streamed from the disk, and the result of each file is
+     * read from the JSON reply of the server. uploadError() is sent only
+     * if the whole request fails.
+     *
+     * @sa fileFinished()
+     */
+    bool uploadBatch(const QStringList &files);
+
     /*!
      * @brief Cancels ongoing request.
      *
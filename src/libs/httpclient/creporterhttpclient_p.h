@@ -26,18 +26,51 @@
 #define CREPORTERHTTPCLIENT_P_H
 
 #include  <QList>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QJsonObject>
 #include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QTimer>
 
 #include "creporterhttpclient.h"
 
-class CReporterCoreRegistry;
+class CReporterDigestIndex;
+class QFile;
 class QNetworkAccessManager;
 class QAuthenticator;
 class QAuthenticator;
 class QSslError;
 
+/*!
+ * @brief Digest of a file, computed while the file is sent.
+ */
+struct CReporterStreamDigest
+{
+    CReporterStreamDigest() : hash(QCryptographicHash::Sha256), digested(0) {}
+
+    /*!
+     * @brief Returns digest of the file of @a size bytes, or empty if not
+     * all of it was digested.
+     */
+    QByteArray result(qint64 size)
+    {
+        if (!known.isEmpty()) {
+            return known;
+        }
+        return digested == size ? hash.result() : QByteArray();
+    }
+
+    //! @arg Digest of the data sent so far.
+    QCryptographicHash hash;
+    //! @arg Number of bytes from the start of the file added to hash.
+    qint64 digested;
+    //! @arg Digest computed before sending, if the file had to be checked.
+    QByteArray known;
+};
+
 /*!
  * @class CReporterHttpClientPrivate
  * @brief Private CReporterHttpClient class.
@@ -67,6 +100,11 @@ public:
      */
     bool createRequest(const QString &file);
 
+    /*!
+     * @brief Creates a multipart request that uploads all @a files.
+     */
+    bool createBatchRequest(const QStringList &files);
+
     /*!
      * @brief Cancels ongoing request.
      *
@@ -138,6 +176,17 @@ private Q_SLOTS:
      */
     void handleUploadProgress(qint64 bytesSent, qint64 bytesTotal);
 
+    /*!
+     * @brief Completes the request of a file whose content has already been
+     * uploaded, without sending it again.
+     */
+    void finishDuplicate();
+
+    /*!
+     * @brief Reports result of each file of a batch upload.
+     */
+    void finishBatch();
+
 private:
 
     /*!
@@ -147,24 +196,152 @@ private:
      */
     void stateChange(CReporterHttpClient::State nextState);
 
+    /*!
+     * @brief Creates request to @a path on the server, with the headers
+     * common to all uploads.
+     */
+    QNetworkRequest newRequest(const QString &path) const;
+
+    /*!
+     * @brief Returns files of the current request.
+     */
+    QStringList requestFiles() const;
+
     /*!
      * @brief Creates HTTP PUT request.
      *
+     * Opens the current file for streaming it as the request body.
+     *
      * @param request New QNetworkRequest.
-     * @param dataToSend Data array to send.
      */
-    bool createPutRequest(QNetworkRequest &request, QByteArray &dataToSend);
+    bool createPutRequest(QNetworkRequest &request);
+
+    /*!
+     * @brief Closes the file opened by createPutRequest().
+     */
+    void closeUploadFile();
+
+    /*!
+     * @brief Makes @a reply the current one and connects to its signals.
+     *
+     * @return false if @a reply is null.
+     */
+    bool startReply(QNetworkReply *reply);
+
+    /*!
+     * @brief Asks the server how much of the current file it has received.
+     *
+     * Sent as an empty PUT, with "*" as the range in Content-Range header.
+     */
+    bool sendOffsetQuery();
+
+    /*!
+     * @brief Sends a chunk of the current file starting at @a offset.
+     */
+    bool sendChunk(qint64 offset);
+
+    /*!
+     * @brief Sends the next chunk after the server has replied with
+     * "308 Resume Incomplete" and the range it has received.
+     */
+    bool continueUpload();
+
+    /*!
+     * @brief Path of the file that stores the confirmed offset of the
+     * current file, next to it.
+     */
+    QString uploadOffsetFile() const;
+
+    /*!
+     * @brief Returns saved offset of the current file, or 0 if there is no
+     * offset or the file has changed since it was saved.
+     */
+    qint64 loadUploadOffset() const;
+
+    /*!
+     * @brief Saves @a offset confirmed by the server for the current file.
+     */
+    void saveUploadOffset(qint64 offset) const;
+
+    /*!
+     * @brief Reads JSON object from server reply.
+     *
+     * @return The object, or empty object if the reply isn't valid.
+     */
+    QJsonObject readReply();
+
+    /*!
+     * @brief Returns submission URL for "submission_id" in @a json, or
+     * empty string if there is no id.
+     */
+    QString submissionUrl(const QJsonObject &json) const;
+
+    /*!
+     * @brief Returns form field name of the part at @a index of a batch.
+     *
+     * The server refers to the parts by these names in its reply.
+     */
+    static QString batchPartName(int index);
+
+    /*!
+     * @brief Saves submission URL of an uploaded file into a log file.
+     *
+     * @param note Appended to the line, if not empty.
+     */
+    void appendUploadLog(const QString &fileName, const QString &submission,
+                         const QString &note = QString());
 
     /*!
-     * @brief Reads server reply and save submission URL into a log file.
+     * @brief Removes the uploaded file or marks it uploaded, depending on
+     * the session.
      */
-    void parseReply();
+    void completeUpload(const QString &filePath);
 
 public:
-    //! @arg QNetworkAccessManager object.
+    //! @arg QNetworkAccessManager shared through CReporterConnectionPool.
     QNetworkAccessManager *m_manager;
     //! @arg QNetworkReply object.
     QNetworkReply *m_reply;
+    //! @arg Opened file being uploaded, read by QNetworkAccessManager.
+    QFile *m_uploadFile;
+    //! @arg Part of m_uploadFile sent in the current chunk.
+    QIODevice *m_chunkDevice;
+    //! @arg Set to True, if file is uploaded in resumable chunks.
+    bool m_resumable;
+    //! @arg Maximum size of a chunk.
+    qint64 m_chunkSize;
+    //! @arg Offset of the chunk being sent.
+    qint64 m_chunkStart;
+    //! @arg Request with the headers common to all chunks.
+    QNetworkRequest m_request;
+    //! @arg Digests of already uploaded files.
+    CReporterDigestIndex *m_digestIndex;
+    //! @arg Digest of the current file, computed while it is sent.
+    QCryptographicHash m_digest;
+    //! @arg Number of bytes from the start of the file added to m_digest.
+    qint64 m_digested;
+    //! @arg Set to True, if content of the current file has already been uploaded.
+    bool m_duplicate;
+    //! @arg Submission URL of the earlier upload of the content.
+    QString m_duplicateOf;
+    //! @arg Set to True, if the current request is a batch upload.
+    bool m_batch;
+    //! @arg Files of the current batch upload.
+    QStringList m_batchFiles;
+    //! @arg Files of the batch that were uploaded earlier, with their submission URLs.
+    QHash<QString, QString> m_batchDuplicates;
+    //! @arg Digests of the files of the current batch upload.
+    QHash<QString, CReporterStreamDigest *> m_batchDigests;
+    //! @arg Files of the batch that couldn't be sent, with the reasons.
+    QHash<QString, QString> m_batchErrors;
+    //! @arg Reason, if the batch request failed as a whole.
+    QString m_batchError;
+    //! @arg Delay in seconds requested by the server for a retry, or -1.
+    int m_retryAfter;
+    //! @arg Time since the last throughput update.
+    QElapsedTimer m_throughputTimer;
+    //! @arg Bytes of the current request sent at the last throughput update.
+    qint64 m_throughputBytes;
     //! @arg Set to True, if file should be removed after successfull sending.
     bool m_deleteFileFlag;
     //! @arg Current file to process.
@@ -89,6 +89,13 @@ CReporterNwSessionMgr::CReporterNwSessionMgr(QObject *parent)
 {
     Q_D(CReporterNwSessionMgr);
     d->networkSession = 0;
+
+    connect(&d->networkManager(), SIGNAL(onlineStateChanged(bool)),
+            this, SIGNAL(connectivityChanged()));
+    connect(&d->networkManager(), SIGNAL(configurationChanged(QNetworkConfiguration)),
+            this, SIGNAL(connectivityChanged()));
+    connect(&d->usbModed(), SIGNAL(currentModeChanged()),
+            this, SIGNAL(connectivityChanged()));
 }
 
 CReporterNwSessionMgr::~CReporterNwSessionMgr()
@@ -143,6 +150,28 @@ bool CReporterNwSessionMgr::canUseNetworkConnection()
             CReporterNwSessionMgrPrivate::developerModeIsActive());
 }
 
+CReporterNwSessionMgr::BearerType CReporterNwSessionMgr::bearerType()
+{
+    if (!CReporterNwSessionMgrPrivate::connectionIsActive() &&
+            CReporterNwSessionMgrPrivate::developerModeIsActive()) {
+        // Same as in canUseNetworkConnection(), USB network isn't reported as such.
+        return UsbBearer;
+    }
+
+    switch (CReporterNwSessionMgrPrivate::networkManager().defaultConfiguration().bearerType()) {
+    case QNetworkConfiguration::BearerWLAN:
+        return WlanBearer;
+    case QNetworkConfiguration::BearerEthernet:
+        return EthernetBearer;
+    case QNetworkConfiguration::BearerUnknown:
+    case QNetworkConfiguration::BearerBluetooth:
+        return UnknownBearer;
+    default:
+        // The remaining ones are cellular technologies.
+        return MobileBearer;
+    }
+}
+
 bool CReporterNwSessionMgr::open()
 {
     Q_D(CReporterNwSessionMgr);
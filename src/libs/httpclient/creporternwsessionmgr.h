@@ -48,6 +48,23 @@ class CREPORTER_EXPORT CReporterNwSessionMgr : public QObject
     Q_OBJECT
 
 public:
+    /*!
+     * @enum BearerType
+     * @brief Kind of the network connection.
+     */
+    enum BearerType {
+        //! Bearer isn't known.
+        UnknownBearer = 0,
+        //! Wireless LAN.
+        WlanBearer,
+        //! Wired ethernet.
+        EthernetBearer,
+        //! Cellular data connection.
+        MobileBearer,
+        //! USB networking in developer mode.
+        UsbBearer
+    };
+
     CReporterNwSessionMgr(QObject *parent = 0);
     ~CReporterNwSessionMgr();
 
@@ -66,6 +83,11 @@ public:
      */
     static bool canUseNetworkConnection();
 
+    /*!
+     * @return Bearer of the default network connection.
+     */
+    static BearerType bearerType();
+
 Q_SIGNALS:
     /*!
      * @brief This signal is emitted, when the network session has been opened.
@@ -86,6 +108,14 @@ Q_SIGNALS:
      */
     void networkError(const QString &errorString);
 
+    /*!
+     * @brief Sent when network configurations or USB mode have changed.
+     *
+     * The change may or may not affect canUseNetworkConnection(). Several
+     * of these usually arrive in a row while a connection is set up.
+     */
+    void connectivityChanged();
+
 public Q_SLOTS:
     /*!
      * @brief Opens network session.
@@ -0,0 +1,83 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <QDateTime>
+
+#include "creporterapplicationsettings.h"
+#include "creporterretrypolicy.h"
+
+namespace {
+// Server may not postpone retries for longer than this (s).
+const int MaxRetryAfter = 24 * 60 * 60;
+
+/*
+ * Returns a random value in [0, 1). Seeded per process, so that devices
+ * which failed at the same time pick different delays.
+ */
+double jitter()
+{
+    static bool seeded = false;
+    if (!seeded) {
+        qsrand(uint(QDateTime::currentMSecsSinceEpoch()) ^ uint(getpid()));
+        seeded = true;
+    }
+
+    return qrand() / (double(RAND_MAX) + 1);
+}
+} // namespace
+
+CReporterRetryPolicy::CReporterRetryPolicy(int baseDelay, int maxDelay, int maxAttempts)
+    : m_baseDelay(qMax(1, baseDelay)),
+      m_maxDelay(qMax(m_baseDelay, maxDelay)),
+      m_maxAttempts(qMax(1, maxAttempts))
+{
+}
+
+CReporterRetryPolicy CReporterRetryPolicy::fromSettings()
+{
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+
+    return CReporterRetryPolicy(settings->retryBaseDelay(), settings->retryMaxDelay(),
+                                settings->retryMaxAttempts());
+}
+
+bool CReporterRetryPolicy::canRetry(int attempts) const
+{
+    return attempts < m_maxAttempts;
+}
+
+qint64 CReporterRetryPolicy::retryDelay(int attempts, int retryAfter) const
+{
+    // Shift is bounded, the cap is reached long before an overflow.
+    int shift = qBound(0, attempts - 1, 30);
+    qint64 delay = qMin(qint64(m_baseDelay) << shift, qint64(m_maxDelay)) * 1000;
+
+    // Equal jitter: wait at least half of the delay.
+    delay = delay / 2 + qint64(jitter() * (delay / 2));
+
+    if (retryAfter >= 0) {
+        delay = qMax(delay, qint64(qMin(retryAfter, MaxRetryAfter)) * 1000);
+    }
+
+    return delay;
+}
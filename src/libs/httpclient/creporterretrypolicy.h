@@ -0,0 +1,80 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERRETRYPOLICY_H
+#define CREPORTERRETRYPOLICY_H
+
+#include <QtGlobal>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterRetryPolicy
+ * @brief Decides when a failed upload is tried again.
+ *
+ * The delay doubles on each failed attempt, starting from the base delay
+ * and capped to the maximum delay. A random jitter of up to half of the
+ * delay spreads retries of many devices over time, so that they don't hit
+ * the server at the same moment after an outage.
+ */
+class CREPORTER_EXPORT CReporterRetryPolicy
+{
+public:
+    /*!
+     * @brief Creates policy.
+     *
+     * @param baseDelay Delay in seconds after the first failed attempt.
+     * @param maxDelay Maximum delay in seconds.
+     * @param maxAttempts Number of attempts before giving up.
+     */
+    CReporterRetryPolicy(int baseDelay, int maxDelay, int maxAttempts);
+
+    /*!
+     * @brief Creates policy from CReporterApplicationSettings.
+     */
+    static CReporterRetryPolicy fromSettings();
+
+    int baseDelay() const { return m_baseDelay; }
+    int maxDelay() const { return m_maxDelay; }
+    int maxAttempts() const { return m_maxAttempts; }
+
+    /*!
+     * @brief Returns true if upload may be retried after @a attempts
+     * failed attempts.
+     */
+    bool canRetry(int attempts) const;
+
+    /*!
+     * @brief Returns delay before the next attempt.
+     *
+     * @param attempts Number of failed attempts so far, at least 1.
+     * @param retryAfter Delay in seconds requested by the server, or -1.
+     *  It is obeyed even if it's longer than the maximum delay.
+     * @return Delay in milliseconds.
+     */
+    qint64 retryDelay(int attempts, int retryAfter = -1) const;
+
+private:
+    int m_baseDelay;
+    int m_maxDelay;
+    int m_maxAttempts;
+};
+
+#endif // CREPORTERRETRYPOLICY_H
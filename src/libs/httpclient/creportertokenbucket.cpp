@@ -0,0 +1,83 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportertokenbucket.h"
+
+namespace {
+// Don't wake up senders for less data than this (bytes).
+const qint64 MinimumSend = 4096;
+} // namespace
+
+CReporterTokenBucket::CReporterTokenBucket()
+    : m_rate(0), m_capacity(0), m_tokens(0)
+{
+    m_refilled.start();
+}
+
+void CReporterTokenBucket::setRate(qint64 bytesPerSecond)
+{
+    if (bytesPerSecond == m_rate) {
+        return;
+    }
+
+    m_rate = qMax(qint64(0), bytesPerSecond);
+    m_capacity = qMax(m_rate / 4, qMin(m_rate, MinimumSend));
+    m_tokens = m_capacity;
+    m_refilled.restart();
+}
+
+void CReporterTokenBucket::refill()
+{
+    qint64 elapsed = m_refilled.elapsed();
+    qint64 added = elapsed * m_rate / 1000;
+    if (added > 0) {
+        m_tokens = qMin(m_capacity, m_tokens + added);
+        m_refilled.restart();
+    }
+}
+
+qint64 CReporterTokenBucket::take(qint64 bytes)
+{
+    if (m_rate == 0) {
+        return bytes;
+    }
+
+    refill();
+
+    qint64 taken = qMin(bytes, m_tokens);
+    m_tokens -= taken;
+    return taken;
+}
+
+int CReporterTokenBucket::msecsUntilAvailable()
+{
+    if (m_rate == 0) {
+        return 0;
+    }
+
+    refill();
+
+    qint64 missing = qMin(m_capacity, MinimumSend) - m_tokens;
+    if (missing <= 0) {
+        return 0;
+    }
+
+    return static_cast<int>(missing * 1000 / m_rate) + 1;
+}
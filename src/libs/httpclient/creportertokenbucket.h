@@ -0,0 +1,74 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERTOKENBUCKET_H
+#define CREPORTERTOKENBUCKET_H
+
+#include <QElapsedTimer>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterTokenBucket
+ * @brief Token bucket limiting the rate of uploaded data.
+ *
+ * Tokens, one per byte, are added at the configured rate up to a burst of
+ * a quarter of a second. Data may be sent only for the tokens taken from
+ * the bucket. All uploads of the process share one bucket, see
+ * CReporterConnectionPool::uploadBucket(), so parallel uploads don't
+ * multiply the rate.
+ */
+class CREPORTER_EXPORT CReporterTokenBucket
+{
+public:
+    CReporterTokenBucket();
+
+    /*!
+     * @brief Sets rate in bytes per second. 0 means no limit.
+     */
+    void setRate(qint64 bytesPerSecond);
+
+    qint64 rate() const { return m_rate; }
+
+    /*!
+     * @brief Takes up to @a bytes tokens from the bucket.
+     *
+     * @return Number of bytes that may be sent now, may be 0.
+     */
+    qint64 take(qint64 bytes);
+
+    /*!
+     * @brief Returns time until a reasonable amount of tokens is available
+     * again.
+     *
+     * @return Delay in milliseconds.
+     */
+    int msecsUntilAvailable();
+
+private:
+    void refill();
+
+    qint64 m_rate;
+    qint64 m_capacity;
+    qint64 m_tokens;
+    QElapsedTimer m_refilled;
+};
+
+#endif // CREPORTERTOKENBUCKET_H
@@ -0,0 +1,148 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDebug>
+
+#include "creporterhttpclient.h"
+#include "creporteruploadbatch.h"
+#include "creporteruploaditem.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+CReporterUploadBatch::CReporterUploadBatch(QObject *parent)
+    : QObject(parent), m_http(0), m_count(0), m_finished(0), m_done(false)
+{
+}
+
+CReporterUploadBatch::~CReporterUploadBatch()
+{
+}
+
+void CReporterUploadBatch::addItem(CReporterUploadItem *item)
+{
+    m_items << item;
+    m_count++;
+}
+
+void CReporterUploadBatch::itemStarted(CReporterUploadItem *item)
+{
+    m_started.insert(item);
+    startIfReady();
+}
+
+void CReporterUploadBatch::itemCancelled(CReporterUploadItem *item)
+{
+    if (m_http) {
+        // Finishes all the items.
+        m_http->cancel();
+        return;
+    }
+
+    // Not sent yet, the rest of the items may still go.
+    m_items.removeAll(item);
+    m_started.remove(item);
+    finishItem(item, QString());
+    startIfReady();
+}
+
+void CReporterUploadBatch::startIfReady()
+{
+    if (m_http || m_done || m_items.isEmpty()) {
+        return;
+    }
+
+    QStringList files;
+    foreach (CReporterUploadItem *item, m_items) {
+        if (!item || !m_started.contains(item)) {
+            return;
+        }
+        files << item->filePath();
+    }
+
+    qCDebug(cr) << "Uploading batch of" << files.count() << "files.";
+
+    m_http = new CReporterHttpClient(this);
+    connect(m_http, SIGNAL(fileFinished(QString, bool, QString)),
+            this, SLOT(fileFinished(QString, bool, QString)));
+    connect(m_http, SIGNAL(finished()), this, SLOT(uploadFinished()));
+    connect(m_http, SIGNAL(uploadStateChanged(QString, CReporterCoreIndex::UploadState)),
+            this, SLOT(fileStateChanged(QString, CReporterCoreIndex::UploadState)));
+
+    // Progress of the request is the progress of each file.
+    foreach (CReporterUploadItem *item, m_items) {
+        connect(m_http, SIGNAL(updateProgress(int)), item, SIGNAL(updateProgress(int)));
+    }
+    connect(m_http, SIGNAL(updateThroughput(qint64)),
+            m_items.first(), SIGNAL(updateThroughput(qint64)));
+
+    m_http->initSession();
+    if (!m_http->uploadBatch(files)) {
+        qCWarning(cr) << "Couldn't start batch upload.";
+        m_done = true;
+        QList<QPointer<CReporterUploadItem> > items = m_items;
+        foreach (CReporterUploadItem *item, items) {
+            if (item) {
+                finishItem(item, "Couldn't start upload");
+            }
+        }
+    }
+}
+
+void CReporterUploadBatch::fileFinished(const QString &file, bool success,
+                                        const QString &errorString)
+{
+    m_results.insert(file, success ? QString() : errorString);
+}
+
+void CReporterUploadBatch::fileStateChanged(const QString &file,
+                                            CReporterCoreIndex::UploadState state)
+{
+    foreach (CReporterUploadItem *item, m_items) {
+        if (item && item->filePath() == file) {
+            emit item->uploadStateChanged(file, state);
+        }
+    }
+}
+
+void CReporterUploadBatch::uploadFinished()
+{
+    // Cancelling may finish the client more than once.
+    if (m_done) {
+        return;
+    }
+    m_done = true;
+
+    QList<QPointer<CReporterUploadItem> > items = m_items;
+    foreach (CReporterUploadItem *item, items) {
+        if (item) {
+            finishItem(item, m_results.value(item->filePath(), "Upload failed"));
+        }
+    }
+}
+
+void CReporterUploadBatch::finishItem(CReporterUploadItem *item, const QString &errorString)
+{
+    item->batchFinished(errorString, m_http ? m_http->retryAfter() : -1);
+
+    if (++m_finished == m_count) {
+        deleteLater();
+    }
+}
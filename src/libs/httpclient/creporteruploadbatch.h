@@ -0,0 +1,95 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERUPLOADBATCH_H
+#define CREPORTERUPLOADBATCH_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+
+#include "creportercoreindex.h"
+
+class CReporterHttpClient;
+class CReporterUploadItem;
+
+/*!
+ * @class CReporterUploadBatch
+ * @brief Uploads small items of the queue in one request.
+ *
+ * Items of a batch are handed out and finished one by one as usual, but
+ * the files are sent together once all items have been started. Each item
+ * gets the result of its own file.
+ *
+ * @sa CReporterUploadQueue::setBatchLimits()
+ */
+class CReporterUploadBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CReporterUploadBatch(QObject *parent = 0);
+    ~CReporterUploadBatch();
+
+    /*!
+     * @brief Adds @a item to the batch. Called before any item is started.
+     */
+    void addItem(CReporterUploadItem *item);
+
+    /*!
+     * @brief Called, when @a item is started. Upload begins when all items
+     * of the batch have been started.
+     */
+    void itemStarted(CReporterUploadItem *item);
+
+    /*!
+     * @brief Called, when @a item is cancelled.
+     *
+     * Cancels the request, if it is running, as the other files can't be
+     * left out of it any longer.
+     */
+    void itemCancelled(CReporterUploadItem *item);
+
+private Q_SLOTS:
+    void fileFinished(const QString &file, bool success, const QString &errorString);
+    void uploadFinished();
+    void fileStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
+
+private:
+    //! @arg Starts the request when all items have been started.
+    void startIfReady();
+
+    //! @arg Finishes @a item with @a errorString, or successfully if empty.
+    void finishItem(CReporterUploadItem *item, const QString &errorString);
+
+    QList<QPointer<CReporterUploadItem> > m_items;
+    QSet<CReporterUploadItem *> m_started;
+    //! @arg Errors by file path, empty string for success.
+    QHash<QString, QString> m_results;
+    CReporterHttpClient *m_http;
+    //! @arg Number of items added and finished.
+    int m_count;
+    int m_finished;
+    bool m_done;
+};
+
+#endif // CREPORTERUPLOADBATCH_H
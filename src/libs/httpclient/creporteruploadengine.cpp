@@ -46,7 +46,8 @@ static const char *error_string[] = {"NoError", "ProtocolError", "ConnectionNotA
 
 CReporterUploadEnginePrivate::CReporterUploadEnginePrivate()
 {
-    currentItem = 0;
+    totalBytes = 0;
+    bytesDone = 0;
     errorMessage.clear();
     error = CReporterUploadEngine::NoError;
     sentFiles = 0;
@@ -80,20 +81,30 @@ void CReporterUploadEnginePrivate::uploadItem(CReporterUploadItem *item)
     qCDebug(cr) << "Got new item to upload:" << item->filename();
 
     connect(item, SIGNAL(uploadFinished()), this, SLOT(uploadFinished()));
+    connect(item, SIGNAL(updateProgress(int)), this, SLOT(itemProgress(int)));
+    connect(item, SIGNAL(updateThroughput(qint64)), this, SLOT(itemThroughput(qint64)));
 
     // Save item.
-    currentItem = item;
+    activeItems << item;
 
 #ifdef CREPORTER_LIBBEARER_ENABLED
-    stateChange(Connecting);
-    if (!networkSession->open()) {
-        // No network connection. Open new session and wait for sessionOpened() -signal.
+    if (state == Connecting) {
+        // Session is being opened, item is started on sessionOpened() -signal.
         return;
     }
-    qCDebug(cr) << "Network connection exists. => start upload.";
+    if (state != Connected) {
+        stateChange(Connecting);
+        if (!networkSession->open()) {
+            // No network connection. Open new session and wait for sessionOpened() -signal.
+            return;
+        }
+        qCDebug(cr) << "Network connection exists. => start upload.";
+    }
 #endif // CREPORTER_LIBBEARER_ENABLED
     // We have a network connection. Start upload immediately.
-    stateChange(Connected);
+    if (state != Connected) {
+        stateChange(Connected);
+    }
     item->startUpload();
 }
 
@@ -118,6 +129,11 @@ void CReporterUploadEnginePrivate::uploadFinished()
     qCDebug(cr) << "Upload item:" << item->filename()
                 << "finished. Item status was:" << item->statusString();
 
+    activeItems.removeOne(item);
+    bytesSent.remove(item);
+    throughput.remove(item);
+    bytesDone += item->filesize();
+
     if (item->status() == CReporterUploadItem::Error && state != NoConnection) {
         setErrorType(CReporterUploadEngine::ProtocolError);
         setErrorString(item->errorString());
@@ -146,6 +162,41 @@ void CReporterUploadEnginePrivate::uploadFinished()
     item->markDone();
 }
 
+void CReporterUploadEnginePrivate::itemQueued(CReporterUploadItem *item)
+{
+    totalBytes += item->filesize();
+}
+
+void CReporterUploadEnginePrivate::itemProgress(int done)
+{
+    CReporterUploadItem *item = qobject_cast<CReporterUploadItem *>(sender());
+    bytesSent.insert(item, item->filesize() * done / 100);
+
+    if (totalBytes == 0) {
+        return;
+    }
+
+    qint64 sent = bytesDone;
+    foreach (qint64 bytes, bytesSent) {
+        sent += bytes;
+    }
+
+    emit q_ptr->updateProgress(static_cast<int>(qMin(sent * 100 / totalBytes, qint64(100))));
+}
+
+void CReporterUploadEnginePrivate::itemThroughput(qint64 bytesPerSecond)
+{
+    CReporterUploadItem *item = qobject_cast<CReporterUploadItem *>(sender());
+    throughput.insert(item, bytesPerSecond);
+
+    qint64 total = 0;
+    foreach (qint64 rate, throughput) {
+        total += rate;
+    }
+
+    emit q_ptr->updateThroughput(total);
+}
+
 #ifdef CREPORTER_LIBBEARER_ENABLED
 void CReporterUploadEnginePrivate::sessionOpened()
 {
@@ -153,7 +204,11 @@ void CReporterUploadEnginePrivate::sessionOpened()
 
     if (state == Connecting) {
         stateChange(Connected);
-        currentItem->startUpload();
+        foreach (CReporterUploadItem *item, activeItems) {
+            if (item->status() == CReporterUploadItem::Waiting) {
+                item->startUpload();
+            }
+        }
     }
 }
 
@@ -174,12 +229,12 @@ void CReporterUploadEnginePrivate::sessionDisconnected()
     case Connecting:
         // Unable to create connection.
         setErrorType(CReporterUploadEngine::ConnectionNotAvailable);
-        currentItem->cancel();
+        cancelActiveItems();
         break;
     case Connected:
         // Disconnected by the network.
         setErrorType(CReporterUploadEngine::ConnectionClosed);
-        currentItem->cancel();
+        cancelActiveItems();
         break;
     default:
         break;
@@ -194,6 +249,17 @@ void CReporterUploadEnginePrivate::connectionError(const QString &errorString)
 }
 #endif // CREPORTER_LIBBEARER_ENABLED
 
+void CReporterUploadEnginePrivate::cancelActiveItems()
+{
+    // Cancelling finishes the item and removes it from the list.
+    QList<CReporterUploadItem *> items = activeItems;
+    foreach (CReporterUploadItem *item, items) {
+        if (activeItems.contains(item)) {
+            item->cancel();
+        }
+    }
+}
+
 void CReporterUploadEnginePrivate::setErrorString(const QString &message)
 {
     if (errorMessage.isNull()) {
@@ -214,6 +280,8 @@ void CReporterUploadEnginePrivate::emitFinished(CReporterUploadEngine::ErrorType
     qCDebug(cr) << "Signalling finished(). Error:" << error_string[error];
 
     sentFiles = 0;
+    totalBytes = 0;
+    bytesDone = 0;
     emit q_ptr->finished(static_cast<int>(error), sent, total);
 }
 
@@ -231,6 +299,8 @@ CReporterUploadEngine::CReporterUploadEngine(CReporterUploadQueue *queue, QObjec
     connect(queue, SIGNAL(nextItem(CReporterUploadItem *)),
             d_ptr, SLOT(uploadItem(CReporterUploadItem *)));
     connect(queue, SIGNAL(done()), d_ptr, SLOT(queueDone()));
+    connect(queue, SIGNAL(itemAdded(CReporterUploadItem *)),
+            d_ptr, SLOT(itemQueued(CReporterUploadItem *)));
 }
 
 CReporterUploadEngine::~CReporterUploadEngine()
@@ -248,7 +318,5 @@ void CReporterUploadEngine::cancelAll()
 {
     Q_D(CReporterUploadEngine);
     qCDebug(cr) << "Aborting upload(s).";
-    if (d->currentItem) {
-        d->currentItem->cancel();
-    }
+    d->cancelActiveItems();
 }
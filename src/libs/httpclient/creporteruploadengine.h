@@ -86,6 +86,21 @@ Q_SIGNALS:
       */
     void finished(int error, int sent, int total);
 
+    /*!
+      * @brief Sent when upload of queued files progresses.
+      *
+      * @param done Sent data of all the files, including the ones still
+      *  waiting in the queue, in percentage value.
+      */
+    void updateProgress(int done);
+
+    /*!
+      * @brief Sent when upload speed of the active files is measured.
+      *
+      * @param bytesPerSecond Combined upload speed of all active files.
+      */
+    void updateThroughput(qint64 bytesPerSecond);
+
 public Q_SLOTS:
     /*!
      * @brief Cancels all pending uploads.
@@ -25,6 +25,8 @@
 #ifndef CREPORTERUPLOADENGINE_P_H
 #define CREPORTERUPLOADENGINE_P_H
 
+#include <QHash>
+#include <QList>
 #include <QObject>
 
 #include "creporteruploadengine.h"
@@ -91,6 +93,27 @@ public Q_SLOTS:
      * @sa CReporterUploadQueue::done()
      */
     void uploadFinished();
+
+    /*!
+     * @brief Called, when item is added to the upload queue.
+     *
+     * @param item New item.
+     */
+    void itemQueued(CReporterUploadItem *item);
+
+    /*!
+     * @brief Called, when upload of an item progresses.
+     *
+     * @param done Sent data of the item in percentage value.
+     */
+    void itemProgress(int done);
+
+    /*!
+     * @brief Called, when upload speed of an item is measured.
+     *
+     * @param bytesPerSecond Upload speed of the item.
+     */
+    void itemThroughput(qint64 bytesPerSecond);
 #ifdef CREPORTER_LIBBEARER_ENABLED
 public Q_SLOTS:
     /*!
@@ -128,6 +151,11 @@ public:
      */
     void setErrorType(CReporterUploadEngine::ErrorType type);
 
+    /*!
+     * @brief Cancels all items being uploaded.
+     */
+    void cancelActiveItems();
+
 private:
     /*!
       * @brief Sends CReporterUploadEngine::finished() -signal.
@@ -148,8 +176,16 @@ public:
 #endif // CREPORTER_LIBBEARER_ENABLED
     //! @arg Upload queue reference<s.
     CReporterUploadQueue *queue;
-    //! @arg Crash report currently handeled.
-    CReporterUploadItem *currentItem;
+    //! @arg Crash reports currently handled, in order of arrival.
+    QList<CReporterUploadItem *> activeItems;
+    //! @arg Bytes sent of each active item.
+    QHash<CReporterUploadItem *, qint64> bytesSent;
+    //! @arg Last measured upload speed of each active item.
+    QHash<CReporterUploadItem *, qint64> throughput;
+    //! @arg Total size of the files queued since the engine was last finished.
+    qint64 totalBytes;
+    //! @arg Total size of the files handled since the engine was last finished.
+    qint64 bytesDone;
     //! @arg Possible error message, if available.
     QString errorMessage;
     //! @arg Type of error.
@@ -24,9 +24,11 @@
 
 #include <QFileInfo>
 #include <QDebug>
+#include <QPointer>
 
 #include "creporteruploaditem.h"
 #include "creporterhttpclient.h"
+#include "creporteruploadbatch.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -40,7 +42,10 @@ public:
     QString filename;
     QString errorString;
     qint64 filesize;
+    int retryAfter;
     CReporterHttpClient *http;
+    //! @arg Batch this item is uploaded in, if any.
+    QPointer<CReporterUploadBatch> batch;
     CReporterUploadItem::ItemStatus status;
 };
 
@@ -51,6 +56,7 @@ CReporterUploadItem::CReporterUploadItem(const QString &file)
 
     d->filepath = file;
     d->http = 0;
+    d->retryAfter = -1;
 
     QFileInfo fi(d->filepath);
     d->filename = fi.fileName();
@@ -76,6 +82,11 @@ QString CReporterUploadItem::filename() const
     return d_ptr->filename;
 }
 
+QString CReporterUploadItem::filePath() const
+{
+    return d_ptr->filepath;
+}
+
 void CReporterUploadItem::markDone()
 {
     qCDebug(cr) << "Item done.";
@@ -97,16 +108,44 @@ QString CReporterUploadItem::errorString() const
     return d_ptr->errorString;
 }
 
+int CReporterUploadItem::retryAfter() const
+{
+    return d_ptr->retryAfter;
+}
+
+void CReporterUploadItem::makeBatch(const QList<CReporterUploadItem *> &items)
+{
+    if (items.isEmpty()) {
+        return;
+    }
+
+    // Deletes itself after all the items have finished.
+    CReporterUploadBatch *batch = new CReporterUploadBatch(items.first()->parent());
+    foreach (CReporterUploadItem *item, items) {
+        item->d_ptr->batch = batch;
+        batch->addItem(item);
+    }
+}
+
 bool CReporterUploadItem::startUpload()
 {
     Q_D(CReporterUploadItem);
     qCDebug(cr) << "Starting upload of:" << d->filename;
 
+    if (d->batch) {
+        setStatus(Sending);
+        d->batch->itemStarted(this);
+        return d->status != Error;
+    }
+
     d->http = new CReporterHttpClient(this);
     connect(d->http, SIGNAL(finished()), this, SLOT(emitUploadFinished()));
     connect(d->http, SIGNAL(uploadError(QString, QString)),
             this, SLOT(uploadError(QString, QString)));
     connect(d->http, SIGNAL(updateProgress(int)), this, SIGNAL(updateProgress(int)));
+    connect(d->http, SIGNAL(updateThroughput(qint64)), this, SIGNAL(updateThroughput(qint64)));
+    connect(d->http, SIGNAL(uploadStateChanged(QString, CReporterCoreIndex::UploadState)),
+            this, SIGNAL(uploadStateChanged(QString, CReporterCoreIndex::UploadState)));
 
     d->http->initSession();
     if (d->http->upload(d->filepath)) {
@@ -126,6 +165,12 @@ void CReporterUploadItem::cancel()
     ItemStatus previousStatus = d->status;
     setStatus(Cancelled);
 
+    if (d->batch) {
+        // Batch finishes the item.
+        d->batch->itemCancelled(this);
+        return;
+    }
+
     if (d->http != 0) {
         d->http->cancel();
     }
@@ -156,8 +201,10 @@ void CReporterUploadItem::uploadError(const QString &file, const QString &errorS
     disconnect(d->http, SIGNAL(uploadError(QString, QString)),
                this, SLOT(uploadError(QString, QString)));
     disconnect(d->http, SIGNAL(updateProgress(int)), this, SIGNAL(updateProgress(int)));
+    disconnect(d->http, SIGNAL(updateThroughput(qint64)), this, SIGNAL(updateThroughput(qint64)));
 
     setErrorString(errorString);
+    d->retryAfter = d->http->retryAfter();
 
     if (d->status != Cancelled) {
         setStatus(Error);
@@ -165,6 +212,24 @@ void CReporterUploadItem::uploadError(const QString &file, const QString &errorS
     emit uploadFinished();
 }
 
+void CReporterUploadItem::batchFinished(const QString &errorString, int retryAfter)
+{
+    Q_D(CReporterUploadItem);
+
+    if (!errorString.isEmpty()) {
+        qCWarning(cr) << "Upload failed:" << d->filename << errorString;
+        setErrorString(errorString);
+        d->retryAfter = retryAfter;
+        if (d->status != Cancelled) {
+            setStatus(Error);
+        }
+    } else if (d->status != Cancelled) {
+        setStatus(Finished);
+    }
+
+    emit uploadFinished();
+}
+
 void CReporterUploadItem::emitUploadFinished()
 {
     setStatus(Finished);
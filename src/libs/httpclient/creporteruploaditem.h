@@ -25,11 +25,14 @@
 #ifndef CREPORTERUPLOADITEM_H
 #define CREPORTERUPLOADITEM_H
 
+#include <QList>
 #include <QObject>
 
+#include "creportercoreindex.h"
 #include "creporterexport.h"
 
 class CReporterUploadItemPrivate;
+class CReporterUploadBatch;
 
 /*!
   * @class CReporterUploadItem
@@ -81,6 +84,13 @@ public:
      */
     QString filename() const;
 
+    /*!
+     * @brief Returns full path of the file.
+     *
+     * @return File path given to the constructor.
+     */
+    QString filePath() const;
+
     /*!
      * @brief Marks item as done. Causes to emit done().
      *
@@ -109,6 +119,24 @@ public:
      */
     QString errorString() const;
 
+    /*!
+     * @brief Returns delay the server asked to wait before retrying, if
+     * item status is @a error.
+     *
+     * @return Delay in seconds, or -1 if not given.
+     */
+    int retryAfter() const;
+
+    /*!
+     * @brief Uploads @a items together in one request.
+     *
+     * Each item is still started and finished on its own, the request is
+     * sent when all of them have been started.
+     *
+     * @param items Items that haven't been started yet.
+     */
+    static void makeBatch(const QList<CReporterUploadItem *> &items);
+
 public Q_SLOTS:
     /*!
      * @brief Starts uploading to remote server.
@@ -137,6 +165,23 @@ Q_SIGNALS:
      */
     void updateProgress(int done);
 
+    /*!
+     * @brief Sent about once a second while the file is uploaded.
+     *
+     * @param bytesPerSecond Upload speed.
+     */
+    void updateThroughput(qint64 bytesPerSecond);
+
+    /*!
+     * @brief Sent when upload state of the file changes.
+     *
+     * @param file Path to the file.
+     * @param state New upload state.
+     *
+     * @sa CReporterHttpClient::uploadStateChanged()
+     */
+    void uploadStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
+
     /*!
      * @brief Sent, when upload has finished.
      *
@@ -174,6 +219,16 @@ protected:
     void setErrorString(const QString &errorString);
 
 private:
+    /*!
+     * @brief Called by the batch with the result of the file.
+     *
+     * @param errorString Reason of failure, or empty string on success.
+     * @param retryAfter Delay the server asked to wait before retrying.
+     */
+    void batchFinished(const QString &errorString, int retryAfter);
+
+    friend class CReporterUploadBatch;
+
     Q_DECLARE_PRIVATE(CReporterUploadItem)
 
     CReporterUploadItemPrivate *d_ptr;
@@ -0,0 +1,402 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <unistd.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QStringList>
+
+#include "creportercoreregistry.h"
+#include "creporteruploadjournal.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+const quint32 JournalMagic = 0x4352554a; // "CRUJ"
+const quint32 JournalVersion = 1;
+const qint64 HeaderSize = 2 * sizeof(quint32);
+// Size of the record length and checksum preceding each record.
+const qint64 RecordHeaderSize = sizeof(quint32) + sizeof(quint16);
+// Number of superseded records tolerated before the journal is compacted.
+const int CompactThreshold = 64;
+
+QByteArray encodeRecord(const CReporterUploadJournal::Entry &entry)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << entry.filePath << quint8(entry.state) << qint32(entry.attempts)
+           << entry.lastError << entry.nextEligible;
+
+    QByteArray record;
+    QDataStream header(&record, QIODevice::WriteOnly);
+    header << quint32(payload.size()) << qChecksum(payload.constData(), payload.size());
+    record += payload;
+
+    return record;
+}
+
+bool decodeRecord(const QByteArray &payload, CReporterUploadJournal::Entry *entry)
+{
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint8 state;
+    qint32 attempts;
+    stream >> entry->filePath >> state >> attempts >> entry->lastError >> entry->nextEligible;
+    entry->state = static_cast<CReporterUploadJournal::State>(state);
+    entry->attempts = attempts;
+
+    return stream.status() == QDataStream::Ok && state <= CReporterUploadJournal::Done;
+}
+
+QByteArray fileHeader()
+{
+    QByteArray header;
+    QDataStream stream(&header, QIODevice::WriteOnly);
+    stream << JournalMagic << JournalVersion;
+    return header;
+}
+} // namespace
+
+class CReporterUploadJournalPrivate
+{
+public:
+    qint64 parse(const QByteArray &data);
+    void load();
+    bool append(const CReporterUploadJournal::Entry &entry);
+    void update(const CReporterUploadJournal::Entry &entry);
+
+    QString journalFile;
+    QHash<QString, CReporterUploadJournal::Entry> entries;
+    //! @arg Paths of the entries in the order they were added.
+    QStringList order;
+    //! @arg Number of records in the journal file.
+    int records;
+};
+
+/*
+ * Reads the entries from journal contents. Returns size of the valid
+ * records, or -1 if the contents aren't a journal.
+ */
+qint64 CReporterUploadJournalPrivate::parse(const QByteArray &data)
+{
+    entries.clear();
+    order.clear();
+    records = 0;
+
+    if (data.size() < HeaderSize || data.left(HeaderSize) != fileHeader()) {
+        return -1;
+    }
+
+    qint64 pos = HeaderSize;
+    while (data.size() - pos >= RecordHeaderSize) {
+        QDataStream header(data.mid(pos, RecordHeaderSize));
+        quint32 length;
+        quint16 checksum;
+        header >> length >> checksum;
+
+        if (length > data.size() - pos - RecordHeaderSize) {
+            break;
+        }
+
+        QByteArray payload = data.mid(pos + RecordHeaderSize, length);
+        CReporterUploadJournal::Entry entry;
+        if (qChecksum(payload.constData(), payload.size()) != checksum
+                || !decodeRecord(payload, &entry)) {
+            break;
+        }
+
+        pos += RecordHeaderSize + length;
+        records++;
+
+        if (entry.state == CReporterUploadJournal::Done) {
+            entries.remove(entry.filePath);
+            order.removeOne(entry.filePath);
+        } else {
+            if (!entries.contains(entry.filePath)) {
+                order << entry.filePath;
+            }
+            entries.insert(entry.filePath, entry);
+        }
+    }
+
+    return pos;
+}
+
+void CReporterUploadJournalPrivate::load()
+{
+    if (journalFile.isEmpty()) {
+        // Kept in memory only.
+        records = 0;
+        return;
+    }
+
+    QFile file(journalFile);
+    if (!file.open(QIODevice::ReadWrite)) {
+        entries.clear();
+        order.clear();
+        records = 0;
+        qCWarning(cr) << "Couldn't open upload journal" << journalFile << file.errorString();
+        return;
+    }
+
+    QByteArray data = file.readAll();
+    qint64 pos = parse(data);
+    if (pos < 0) {
+        if (!data.isEmpty()) {
+            qCWarning(cr) << "Discarding incompatible upload journal" << journalFile;
+        }
+        file.resize(0);
+        file.seek(0);
+        file.write(fileHeader());
+        return;
+    }
+
+    if (pos != data.size()) {
+        // Torn write from a crash, drop it so that new records follow the good ones.
+        qCWarning(cr) << "Dropping" << data.size() - pos << "bytes of incomplete upload journal records.";
+        file.resize(pos);
+    }
+
+    qCDebug(cr) << "Loaded" << entries.count() << "upload journal entries from" << journalFile;
+}
+
+bool CReporterUploadJournalPrivate::append(const CReporterUploadJournal::Entry &entry)
+{
+    if (journalFile.isEmpty()) {
+        return true;
+    }
+
+    QFile file(journalFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(cr) << "Couldn't write upload journal" << journalFile << file.errorString();
+        return false;
+    }
+
+    QByteArray record = encodeRecord(entry);
+    if (file.write(record) != record.size() || !file.flush()) {
+        qCWarning(cr) << "Couldn't write upload journal" << journalFile << file.errorString();
+        return false;
+    }
+    fdatasync(file.handle());
+
+    records++;
+    return true;
+}
+
+void CReporterUploadJournalPrivate::update(const CReporterUploadJournal::Entry &entry)
+{
+    if (entry.state == CReporterUploadJournal::Done) {
+        entries.remove(entry.filePath);
+        order.removeOne(entry.filePath);
+    } else {
+        if (!entries.contains(entry.filePath)) {
+            order << entry.filePath;
+        }
+        entries.insert(entry.filePath, entry);
+    }
+
+    append(entry);
+}
+
+CReporterUploadJournal::CReporterUploadJournal(const QString &journalFile)
+    : d_ptr(new CReporterUploadJournalPrivate)
+{
+    Q_D(CReporterUploadJournal);
+
+    d->journalFile = journalFile;
+    d->load();
+
+    if (d->records > d->entries.count() + CompactThreshold) {
+        compact();
+    }
+}
+
+CReporterUploadJournal::~CReporterUploadJournal()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+QString CReporterUploadJournal::defaultJournalFile()
+{
+    QStringList paths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    if (paths.isEmpty()) {
+        return QString();
+    }
+
+    return paths.first() + "/upload-journal";
+}
+
+qint64 CReporterUploadJournal::earliestEligible(const QString &journalFile)
+{
+    QFile file(journalFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // Torn records are only dropped by the owner of the journal.
+    CReporterUploadJournalPrivate journal;
+    if (journal.parse(file.readAll()) < 0) {
+        return -1;
+    }
+
+    qint64 earliest = -1;
+    foreach (const Entry &entry, journal.entries) {
+        if (earliest < 0 || entry.nextEligible < earliest) {
+            earliest = entry.nextEligible;
+        }
+    }
+    return earliest;
+}
+
+QString CReporterUploadJournal::journalFile() const
+{
+    Q_D(const CReporterUploadJournal);
+
+    return d->journalFile;
+}
+
+QList<CReporterUploadJournal::Entry> CReporterUploadJournal::entries() const
+{
+    Q_D(const CReporterUploadJournal);
+
+    QList<Entry> result;
+    foreach (const QString &filePath, d->order) {
+        result << d->entries.value(filePath);
+    }
+    return result;
+}
+
+CReporterUploadJournal::Entry CReporterUploadJournal::entry(const QString &filePath) const
+{
+    Q_D(const CReporterUploadJournal);
+
+    return d->entries.value(filePath);
+}
+
+bool CReporterUploadJournal::contains(const QString &filePath) const
+{
+    Q_D(const CReporterUploadJournal);
+
+    return d->entries.contains(filePath);
+}
+
+int CReporterUploadJournal::count() const
+{
+    Q_D(const CReporterUploadJournal);
+
+    return d->entries.count();
+}
+
+void CReporterUploadJournal::add(const QString &filePath)
+{
+    Q_D(CReporterUploadJournal);
+
+    if (d->entries.contains(filePath)) {
+        return;
+    }
+
+    Entry entry;
+    entry.filePath = filePath;
+    d->update(entry);
+}
+
+void CReporterUploadJournal::setState(const QString &filePath, State state, const QString &error)
+{
+    Q_D(CReporterUploadJournal);
+
+    Entry entry = d->entries.value(filePath);
+    entry.filePath = filePath;
+    entry.state = state;
+    if (state == Uploading) {
+        entry.attempts++;
+    } else if (state == Failed) {
+        entry.lastError = error;
+    }
+
+    d->update(entry);
+}
+
+void CReporterUploadJournal::setNextEligible(const QString &filePath, qint64 msecs)
+{
+    Q_D(CReporterUploadJournal);
+
+    QHash<QString, Entry>::iterator it = d->entries.find(filePath);
+    if (it == d->entries.end() || it->nextEligible == msecs) {
+        return;
+    }
+
+    it->nextEligible = msecs;
+    d->append(*it);
+}
+
+void CReporterUploadJournal::remove(const QString &filePath)
+{
+    Q_D(CReporterUploadJournal);
+
+    if (!d->entries.contains(filePath)) {
+        return;
+    }
+
+    Entry entry;
+    entry.filePath = filePath;
+    entry.state = Done;
+    d->update(entry);
+
+    if (d->records > d->entries.count() + CompactThreshold) {
+        compact();
+    }
+}
+
+bool CReporterUploadJournal::compact()
+{
+    Q_D(CReporterUploadJournal);
+
+    if (d->journalFile.isEmpty()) {
+        d->records = d->entries.count();
+        return true;
+    }
+
+    QSaveFile file(d->journalFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Couldn't compact upload journal" << d->journalFile << file.errorString();
+        return false;
+    }
+
+    file.write(fileHeader());
+    foreach (const QString &filePath, d->order) {
+        file.write(encodeRecord(d->entries.value(filePath)));
+    }
+
+    if (!file.commit()) {
+        qCWarning(cr) << "Couldn't compact upload journal" << d->journalFile << file.errorString();
+        return false;
+    }
+
+    d->records = d->entries.count();
+    return true;
+}
@@ -0,0 +1,156 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERUPLOADJOURNAL_H
+#define CREPORTERUPLOADJOURNAL_H
+
+#include <QList>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterUploadJournalPrivate;
+
+/*!
+ * @class CReporterUploadJournal
+ * @brief Persistent state of the reports queued for upload.
+ *
+ * Every change is appended to the journal file as a checksummed record and
+ * synced to disk, so the queue survives exit and crash of the uploader. A
+ * record torn by a crash is detected and dropped when the journal is
+ * loaded. The file is rewritten without the superseded records once they
+ * outnumber the live ones.
+ */
+class CREPORTER_EXPORT CReporterUploadJournal
+{
+public:
+    //! Upload state of a journaled report.
+    enum State {
+        //! Waiting to be uploaded.
+        Pending = 0,
+        //! Upload was started.
+        Uploading,
+        //! Last upload attempt failed.
+        Failed,
+        //! Report was uploaded or dropped, the entry is removed.
+        Done
+    };
+
+    //! Journal record of a single report.
+    struct Entry {
+        Entry() : state(Pending), attempts(0), nextEligible(0) {}
+
+        //! Absolute path of the report.
+        QString filePath;
+        //! Upload state.
+        State state;
+        //! Number of started upload attempts.
+        int attempts;
+        //! Error string of the last failed attempt.
+        QString lastError;
+        //! Earliest time of the next attempt, msecs since epoch.
+        qint64 nextEligible;
+    };
+
+    /*!
+     * @brief Opens journal stored in @a journalFile and loads its entries.
+     *
+     * If @a journalFile is empty, the journal is only kept in memory.
+     */
+    explicit CReporterUploadJournal(const QString &journalFile);
+    ~CReporterUploadJournal();
+
+    /*!
+     * @brief Returns the journal in the core dump directory.
+     *
+     * @return Path of the journal, or empty string if there are no core
+     * dump directories.
+     */
+    static QString defaultJournalFile();
+
+    /*!
+     * @brief Returns the earliest time an entry of @a journalFile may be
+     * uploaded, without modifying the file.
+     *
+     * For processes that only need to know when the owner of the journal
+     * has work to do.
+     *
+     * @return Time in msecs since epoch, or -1 if there are no entries.
+     */
+    static qint64 earliestEligible(const QString &journalFile);
+
+    /*!
+     * @brief Returns path of the journal file.
+     */
+    QString journalFile() const;
+
+    /*!
+     * @brief Returns entries that aren't done, in the order they were added.
+     */
+    QList<Entry> entries() const;
+
+    /*!
+     * @brief Returns entry of @a filePath, or default entry if not found.
+     */
+    Entry entry(const QString &filePath) const;
+
+    bool contains(const QString &filePath) const;
+
+    int count() const;
+
+    /*!
+     * @brief Adds @a filePath as pending, unless it is already journaled.
+     */
+    void add(const QString &filePath);
+
+    /*!
+     * @brief Changes state of @a filePath.
+     *
+     * Entering Uploading state counts as a new attempt. @a error is stored
+     * as the last error with Failed state.
+     */
+    void setState(const QString &filePath, State state, const QString &error = QString());
+
+    /*!
+     * @brief Sets earliest time of the next upload attempt of @a filePath.
+     *
+     * @param msecs Time in msecs since epoch.
+     */
+    void setNextEligible(const QString &filePath, qint64 msecs);
+
+    /*!
+     * @brief Removes @a filePath from the journal.
+     */
+    void remove(const QString &filePath);
+
+    /*!
+     * @brief Rewrites the journal file with only the live entries.
+     */
+    bool compact();
+
+private:
+    Q_DISABLE_COPY(CReporterUploadJournal)
+    Q_DECLARE_PRIVATE(CReporterUploadJournal)
+    CReporterUploadJournalPrivate *d_ptr;
+};
+
+Q_DECLARE_TYPEINFO(CReporterUploadJournal::Entry, Q_MOVABLE_TYPE);
+
+#endif // CREPORTERUPLOADJOURNAL_H
@@ -24,23 +24,118 @@
 
 
 #include <QObject>
-#include <QQueue>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
 
+#include "creportercrashinfo.h"
 #include "creporteruploadqueue.h"
 #include "creporteruploaditem.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
 
+namespace {
+// Default time after which a waiting item is raised by one report class.
+const int DefaultAgingInterval = 10 * 60 * 1000;
+
+struct QueueEntry {
+    CReporterUploadItem *item;
+    //! Report class, lower is uploaded first.
+    int rank;
+    //! Time of enqueuing on the queue clock.
+    qint64 enqueued;
+    //! File size at enqueuing, looked up once.
+    qint64 size;
+};
+
+int reportRank(const QString &filePath)
+{
+    switch (CReporterCrashInfo::fromFileName(filePath).type()) {
+    case CReporterCrashInfo::Crash:
+        return 0;
+    case CReporterCrashInfo::QuickFeedback:
+        // Sent by the user, who may be waiting for it.
+        return 1;
+    case CReporterCrashInfo::Endurance:
+    case CReporterCrashInfo::DuplicateSummary:
+        // Telemetry, least urgent.
+        return 3;
+    default:
+        // System logs.
+        return 2;
+    }
+}
+} // namespace
+
 class CReporterUploadQueuePrivate
 {
 public:
-    QQueue<CReporterUploadItem *> uploadQueue;
+    //! @arg Returns index of the entry to upload next.
+    int nextIndex() const;
+    //! @arg Returns report class of the entry lowered by its waiting time.
+    qint64 agedRank(const QueueEntry &entry, qint64 now) const;
+
+    QList<QueueEntry> uploadQueue;
+    CReporterUploadQueue::Order order;
+    //! @arg Waiting time in ms that raises an item by one report class.
+    int agingInterval;
+    QElapsedTimer clock;
     bool notified;
     int nbrOfItems;
+    //! @arg Number of items handed out and not yet finished.
+    int activeItems;
+    //! @arg Maximum number of items handed out at the same time.
+    int maxActiveItems;
+    //! @arg Size limit of batched items, 0 if batching is disabled.
+    qint64 batchFileSize;
+    int batchMaxFiles;
+    //! @arg Batch of each active batched item.
+    QHash<CReporterUploadItem *, int> batchIds;
+    //! @arg Number of unfinished items in each batch.
+    QHash<int, int> batchRemaining;
+    int nextBatchId;
+    //! @arg Active items that don't take a slot of their own.
+    int batchedItems;
 };
 
+qint64 CReporterUploadQueuePrivate::agedRank(const QueueEntry &entry, qint64 now) const
+{
+    qint64 rank = entry.rank;
+    if (agingInterval > 0) {
+        rank -= (now - entry.enqueued) / agingInterval;
+    }
+    return rank;
+}
+
+int CReporterUploadQueuePrivate::nextIndex() const
+{
+    if (order == CReporterUploadQueue::Fifo) {
+        return 0;
+    }
+
+    /* Report class comes first, then size. Waiting lowers the rank without
+     * limit, so that an item can't be starved by more urgent or smaller
+     * items arriving all the time. Equal items keep their order. */
+    qint64 now = clock.elapsed();
+    int best = -1;
+    qint64 bestRank = 0;
+    qint64 bestSize = 0;
+
+    for (int i = 0; i < uploadQueue.count(); ++i) {
+        const QueueEntry &entry = uploadQueue.at(i);
+        qint64 rank = agedRank(entry, now);
+        if (best == -1 || rank < bestRank || (rank == bestRank && entry.size < bestSize)) {
+            best = i;
+            bestRank = rank;
+            bestSize = entry.size;
+        }
+    }
+
+    return best;
+}
+
 CReporterUploadQueue::CReporterUploadQueue(QObject *parent)
     : QObject(parent),
       d_ptr(new CReporterUploadQueuePrivate())
@@ -49,6 +144,15 @@ CReporterUploadQueue::CReporterUploadQueue(QObject *parent)
     d_ptr->uploadQueue.clear();
     d_ptr->notified = false;
     d_ptr->nbrOfItems = 0;
+    d_ptr->activeItems = 0;
+    d_ptr->maxActiveItems = 1;
+    d_ptr->batchFileSize = 0;
+    d_ptr->batchMaxFiles = 0;
+    d_ptr->nextBatchId = 0;
+    d_ptr->batchedItems = 0;
+    d_ptr->order = Priority;
+    d_ptr->agingInterval = DefaultAgingInterval;
+    d_ptr->clock.start();
 }
 
 CReporterUploadQueue::~CReporterUploadQueue()
@@ -67,7 +171,13 @@ void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
     qCDebug(cr) << "Append new item to queue...";
 
     item->setParent(this);
-    d_ptr->uploadQueue.append(item);
+
+    QueueEntry entry;
+    entry.item = item;
+    entry.rank = reportRank(item->filePath());
+    entry.enqueued = d_ptr->clock.elapsed();
+    entry.size = item->filesize();
+    d_ptr->uploadQueue.append(entry);
 
     emit itemAdded(item);
 
@@ -77,11 +187,12 @@ void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
         d_ptr->nbrOfItems = 0;
         qCDebug(cr) << "Added to empty queue => notify engine.";
         d_ptr->notified = true;
-        // If list was empty, notify engine to start uploading.
-        emit emitNextItem();
     }
 
     d_ptr->nbrOfItems++;
+
+    // Notify engine to start uploading, if there is a free slot.
+    emitNextItems();
 }
 
 void CReporterUploadQueue::itemFinished()
@@ -91,13 +202,29 @@ void CReporterUploadQueue::itemFinished()
     CReporterUploadItem *item = qobject_cast<CReporterUploadItem *>(sender());
     item->deleteLater();
 
+    d_ptr->activeItems--;
+
+    // Batch keeps its slot until the last item has finished.
+    if (d_ptr->batchIds.contains(item)) {
+        int id = d_ptr->batchIds.take(item);
+        if (--d_ptr->batchRemaining[id] > 0) {
+            d_ptr->batchedItems--;
+        } else {
+            d_ptr->batchRemaining.remove(id);
+        }
+    }
+
     if (d_ptr->uploadQueue.isEmpty()) {
+        if (d_ptr->activeItems > 0) {
+            qCDebug(cr) << "Waiting for" << d_ptr->activeItems << "active item(s).";
+            return;
+        }
         qCDebug(cr) << "Queue is empty => emit done()";
         d_ptr->notified = false;
         emit done();
     } else {
         qCDebug(cr) << "Queue size:" << d_ptr->uploadQueue.size();
-        emit emitNextItem();
+        emitNextItems();
     }
 }
 
@@ -106,10 +233,53 @@ int CReporterUploadQueue::totalNumberOfItems() const
     return d_ptr->nbrOfItems;
 }
 
+int CReporterUploadQueue::activeItems() const
+{
+    return d_ptr->activeItems;
+}
+
+void CReporterUploadQueue::setMaxActiveItems(int count)
+{
+    d_ptr->maxActiveItems = qMax(1, count);
+
+    if (d_ptr->notified) {
+        emitNextItems();
+    }
+}
+
+int CReporterUploadQueue::maxActiveItems() const
+{
+    return d_ptr->maxActiveItems;
+}
+
+void CReporterUploadQueue::setOrder(Order order)
+{
+    d_ptr->order = order;
+}
+
+CReporterUploadQueue::Order CReporterUploadQueue::order() const
+{
+    return d_ptr->order;
+}
+
+void CReporterUploadQueue::setAgingInterval(int msecs)
+{
+    d_ptr->agingInterval = qMax(0, msecs);
+}
+
+void CReporterUploadQueue::setBatchLimits(qint64 maxFileSize, int maxFiles)
+{
+    d_ptr->batchFileSize = qMax(qint64(0), maxFileSize);
+    d_ptr->batchMaxFiles = maxFiles;
+}
+
 void CReporterUploadQueue::clear()
 {
     if (d_ptr->uploadQueue.size() != 0) {
-        QQueue<CReporterUploadItem *> items = d_ptr->uploadQueue;
+        QList<CReporterUploadItem *> items;
+        foreach (const QueueEntry &entry, d_ptr->uploadQueue) {
+            items << entry.item;
+        }
         // Clear list.
         d_ptr->uploadQueue.clear();
         // Delete entries.
@@ -120,7 +290,51 @@ void CReporterUploadQueue::clear()
 void CReporterUploadQueue::emitNextItem()
 {
     qCDebug(cr) << "Emit nextItem().";
-    CReporterUploadItem *item = d_ptr->uploadQueue.dequeue();
+    qint64 now = d_ptr->clock.elapsed();
+    QueueEntry head = d_ptr->uploadQueue.takeAt(d_ptr->nextIndex());
+    CReporterUploadItem *item = head.item;
+
+    QList<CReporterUploadItem *> batch;
+    batch << item;
 
-    emit nextItem(item);
+    if (d_ptr->batchFileSize > 0 && head.size <= d_ptr->batchFileSize) {
+        // Less urgent items must not jump the queue by joining a batch.
+        qint64 rank = d_ptr->agedRank(head, now);
+        QList<QueueEntry>::iterator it = d_ptr->uploadQueue.begin();
+        while (it != d_ptr->uploadQueue.end() && batch.count() < d_ptr->batchMaxFiles) {
+            if (d_ptr->agedRank(*it, now) == rank
+                    && it->size <= d_ptr->batchFileSize) {
+                batch << it->item;
+                it = d_ptr->uploadQueue.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    if (batch.count() > 1) {
+        qCDebug(cr) << "Uploading" << batch.count() << "items in a batch.";
+        CReporterUploadItem::makeBatch(batch);
+
+        int id = d_ptr->nextBatchId++;
+        foreach (CReporterUploadItem *batchItem, batch) {
+            d_ptr->batchIds.insert(batchItem, id);
+        }
+        d_ptr->batchRemaining.insert(id, batch.count());
+        d_ptr->batchedItems += batch.count() - 1;
+    }
+
+    d_ptr->activeItems += batch.count();
+
+    foreach (CReporterUploadItem *batchItem, batch) {
+        emit nextItem(batchItem);
+    }
+}
+
+void CReporterUploadQueue::emitNextItems()
+{
+    while (!d_ptr->uploadQueue.isEmpty()
+            && d_ptr->activeItems - d_ptr->batchedItems < d_ptr->maxActiveItems) {
+        emitNextItem();
+    }
 }
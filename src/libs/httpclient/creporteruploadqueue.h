@@ -34,8 +34,12 @@ class CReporterUploadItem;
 
 /*!
   * @class CReporterUploadQueue
-  * @brief Maintains a linked list of the files to be uploaded.
+  * @brief Maintains a list of the files to be uploaded.
   *
+  * By default items are handed out by priority: crash reports first, then
+  * quick feedback, system logs and endurance packages, and smaller files
+  * first within each class. An item that has waited for the aging interval
+  * is raised by one class, so nothing waits forever.
   */
 class CREPORTER_EXPORT CReporterUploadQueue : public QObject
 {
@@ -43,6 +47,17 @@ class CREPORTER_EXPORT CReporterUploadQueue : public QObject
     Q_OBJECT
 
 public:
+    /*!
+     * @enum Order
+     * @brief Order in which items are taken from the queue.
+     */
+    enum Order {
+        //! In order of enqueuing.
+        Fifo = 0,
+        //! By report class, size and waiting time.
+        Priority
+    };
+
     /*!
      * @brief Class constructor.
      *
@@ -64,6 +79,53 @@ public:
      */
     int totalNumberOfItems() const;
 
+    /*!
+     * @brief Returns number of items taken from the queue, but not done yet.
+     */
+    int activeItems() const;
+
+    /*!
+     * @brief Sets how many items may be handled at the same time.
+     *
+     * Queue emits nextItem() until this many items are active. Default is 1.
+     *
+     * @param count Maximum number of active items.
+     */
+    void setMaxActiveItems(int count);
+
+    /*!
+     * @brief Returns maximum number of items handled at the same time.
+     */
+    int maxActiveItems() const;
+
+    /*!
+     * @brief Sets order in which items are taken from the queue.
+     */
+    void setOrder(Order order);
+
+    Order order() const;
+
+    /*!
+     * @brief Sets waiting time that raises an item by one report class in
+     * Priority order.
+     *
+     * @param msecs Interval in milliseconds, 0 disables aging.
+     */
+    void setAgingInterval(int msecs);
+
+    /*!
+     * @brief Enables uploading small items in batches.
+     *
+     * When the next item is taken from the queue and it's at most
+     * @a maxFileSize bytes, other queued items of at most that size are
+     * taken with it, up to @a maxFiles items in total. The items are sent
+     * in one request and take one active slot. Disabled by default.
+     *
+     * @param maxFileSize Size limit of the batched items, 0 disables batching.
+     * @param maxFiles Maximum number of items in a batch.
+     */
+    void setBatchLimits(qint64 maxFileSize, int maxFiles);
+
     /*!
      * @brief Clears upload queue for items.
      *
@@ -73,7 +135,7 @@ public:
 Q_SIGNALS:
 
     /*!
-     * @brief Sent, when all items in the queue are handled.
+     * @brief Sent, when all items in the queue are handled and none is active.
      *
      */
     void done();
@@ -106,6 +168,12 @@ protected:
      */
     void emitNextItem();
 
+    /*!
+     * @brief Emits nextItem() until the queue is empty or maximum number of
+     * items is active.
+     */
+    void emitNextItems();
+
 private:
     Q_DECLARE_PRIVATE(CReporterUploadQueue)
 
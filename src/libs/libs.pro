@@ -34,7 +34,8 @@ QT = \
     dbus
 
 CONFIG += link_pkgconfig
-PKGCONFIG += mce \
+PKGCONFIG += lzo2 \
+             mce \
              usb-moded-qt5 \
              nemonotifications-qt5 \
              systemsettings
@@ -68,35 +69,74 @@ DBUS_INTERFACES = \
 	../autouploader/com.nokia.CrashReporter.AutoUploader.xml \
 
 SOURCES += coredir/creportercoredir.cpp \
+           coredir/creportercoreindex.cpp \
            coredir/creportercoreregistry.cpp \
+           coredir/creportercorewatcher.cpp \
+           coredir/creporterduplicatesummary.cpp \
+           coredir/creportersignatureindex.cpp \
+           httpclient/creporterconnectionpool.cpp \
            httpclient/creporterhttpclient.cpp \
+           httpclient/creporterdigestindex.cpp \
+           httpclient/creporterretrypolicy.cpp \
+           httpclient/creportertokenbucket.cpp \
            httpclient/creporteruploaditem.cpp \
+           httpclient/creporteruploadbatch.cpp \
            httpclient/creporteruploadqueue.cpp \
            httpclient/creporteruploadengine.cpp \
+           httpclient/creporteruploadjournal.cpp \
+           utils/creportercrashinfo.cpp \
+           utils/creporterdeviceidentity.cpp \
+           utils/creporterlzoreader.cpp \
+           utils/creporterlzowriter.cpp \
+           utils/creporterpowerstate.cpp \
+           utils/creporterrichcorereader.cpp \
+           utils/creporterstackfingerprint.cpp \
+           utils/creporterstormdetector.cpp \
            utils/creporterutils.cpp \
+           utils/creporteruploadnotifier.cpp \
            logger/creporterlogger.cpp \
            serviceif/creporterdaemonproxy.cpp \
            settings/creporterprivacysettingsmodel.cpp \
            settings/creportersavedstate.cpp \
            settings/creportersettingsbase.cpp \
+           settings/creportersettingsobserver.cpp \
            settings/creporterapplicationsettings.cpp \
            settings/creportersettingsinit.cpp \
 
 # Public headers
 PUBLIC_HEADERS += creporternamespace.h \
                   coredir/creportercoredir.h \
+                  coredir/creportercoreindex.h \
                   coredir/creportercoreregistry.h \
+                  coredir/creportercorewatcher.h \
+                  coredir/creporterduplicatesummary.h \
+                  coredir/creportersignatureindex.h \
+                  httpclient/creporterconnectionpool.h \
                   httpclient/creporterhttpclient.h \
+                  httpclient/creporterdigestindex.h \
+                  httpclient/creporterretrypolicy.h \
+                  httpclient/creportertokenbucket.h \
                   httpclient/creporteruploaditem.h \
                   httpclient/creporteruploadqueue.h \
                   httpclient/creporteruploadengine.h \
+                  httpclient/creporteruploadjournal.h \
+                  utils/creportercrashinfo.h \
+                  utils/creporterdeviceidentity.h \
+                  utils/creporterlzoreader.h \
+                  utils/creporterlzowriter.h \
+                  utils/creporterpowerstate.h \
+                  utils/creporterrichcorereader.h \
+                  utils/creporterstackfingerprint.h \
+                  utils/creporterstormdetector.h \
                   utils/creporterutils.h \
+                  utils/creporteruploadnotifier.h \
                   logger/creporterlogger.h \
                   serviceif/creporterdaemonproxy.h \
                   serviceif/creportermetatypes.h \
                   settings/creporterprivacysettingsmodel.h \
                   settings/creportersavedstate.h \
                   settings/creportersettingsbase.h \
+                  settings/creportersettingsobserver.h \
                   settings/creporterapplicationsettings.h \
                   creporterexport.h \
 
@@ -105,8 +145,10 @@ HEADERS += $$PUBLIC_HEADERS \
            coredir/creportercoredir_p.h \
            coredir/creportercoreregistry_p.h \
             httpclient/creporterhttpclient_p.h \
+            httpclient/creporteruploadbatch.h \
             httpclient/creporteruploadengine_p.h \
             settings/creportersettingsbase_p.h \
+            settings/creportersettingsobserver_p.h \
             settings/creportersettingsinit_p.h \
 
 TARGET = $$qtLibraryTarget(crashreporter)
@@ -162,6 +162,197 @@ void CReporterApplicationSettings::setUseProxy(bool state)
         emit useProxyChanged();
 }
 
+int CReporterApplicationSettings::maxParallelUploads() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(1, d->intValue(Server::ValueMaxParallelUploads, 3));
+}
+
+void CReporterApplicationSettings::setMaxParallelUploads(int count)
+{
+    if (setValue(Server::ValueMaxParallelUploads, count))
+        emit maxParallelUploadsChanged();
+}
+
+bool CReporterApplicationSettings::resumableUploads() const
+{
+    return value(Server::ValueResumableUploads, false).toBool();
+}
+
+void CReporterApplicationSettings::setResumableUploads(bool state)
+{
+    if (setValue(Server::ValueResumableUploads, state))
+        emit resumableUploadsChanged();
+}
+
+int CReporterApplicationSettings::uploadChunkSize() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(4096, d->intValue(Server::ValueUploadChunkSize, 1024 * 1024));
+}
+
+void CReporterApplicationSettings::setUploadChunkSize(int size)
+{
+    if (setValue(Server::ValueUploadChunkSize, size))
+        emit uploadChunkSizeChanged();
+}
+
+int CReporterApplicationSettings::retryBaseDelay() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(1, d->intValue(Server::ValueRetryBaseDelay, 60));
+}
+
+void CReporterApplicationSettings::setRetryBaseDelay(int seconds)
+{
+    if (setValue(Server::ValueRetryBaseDelay, seconds))
+        emit retryBaseDelayChanged();
+}
+
+int CReporterApplicationSettings::retryMaxDelay() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(retryBaseDelay(), d->intValue(Server::ValueRetryMaxDelay, 6 * 60 * 60));
+}
+
+void CReporterApplicationSettings::setRetryMaxDelay(int seconds)
+{
+    if (setValue(Server::ValueRetryMaxDelay, seconds))
+        emit retryMaxDelayChanged();
+}
+
+int CReporterApplicationSettings::retryMaxAttempts() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(1, d->intValue(Server::ValueRetryMaxAttempts, 10));
+}
+
+void CReporterApplicationSettings::setRetryMaxAttempts(int count)
+{
+    if (setValue(Server::ValueRetryMaxAttempts, count))
+        emit retryMaxAttemptsChanged();
+}
+
+int CReporterApplicationSettings::batchSizeLimit() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Server::ValueBatchSizeLimit, 0));
+}
+
+void CReporterApplicationSettings::setBatchSizeLimit(int size)
+{
+    if (setValue(Server::ValueBatchSizeLimit, size))
+        emit batchSizeLimitChanged();
+}
+
+int CReporterApplicationSettings::batchMaxFiles() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(2, d->intValue(Server::ValueBatchMaxFiles, 16));
+}
+
+void CReporterApplicationSettings::setBatchMaxFiles(int count)
+{
+    if (setValue(Server::ValueBatchMaxFiles, count))
+        emit batchMaxFilesChanged();
+}
+
+QString CReporterApplicationSettings::uploadOrder() const
+{
+    return value(Server::ValueUploadOrder, QStringLiteral("priority")).toString();
+}
+
+void CReporterApplicationSettings::setUploadOrder(const QString &order)
+{
+    if (setValue(Server::ValueUploadOrder, order))
+        emit uploadOrderChanged();
+}
+
+int CReporterApplicationSettings::uploadAgingInterval() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Server::ValueUploadAgingInterval, 600));
+}
+
+void CReporterApplicationSettings::setUploadAgingInterval(int seconds)
+{
+    if (setValue(Server::ValueUploadAgingInterval, seconds))
+        emit uploadAgingIntervalChanged();
+}
+
+int CReporterApplicationSettings::wlanUploadRate() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Bandwidth::ValueWlanUploadRate, 0));
+}
+
+void CReporterApplicationSettings::setWlanUploadRate(int rate)
+{
+    if (setValue(Bandwidth::ValueWlanUploadRate, rate))
+        emit wlanUploadRateChanged();
+}
+
+int CReporterApplicationSettings::ethernetUploadRate() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Bandwidth::ValueEthernetUploadRate, 0));
+}
+
+void CReporterApplicationSettings::setEthernetUploadRate(int rate)
+{
+    if (setValue(Bandwidth::ValueEthernetUploadRate, rate))
+        emit ethernetUploadRateChanged();
+}
+
+int CReporterApplicationSettings::mobileUploadRate() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Bandwidth::ValueMobileUploadRate, 0));
+}
+
+void CReporterApplicationSettings::setMobileUploadRate(int rate)
+{
+    if (setValue(Bandwidth::ValueMobileUploadRate, rate))
+        emit mobileUploadRateChanged();
+}
+
+int CReporterApplicationSettings::usbUploadRate() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(0, d->intValue(Bandwidth::ValueUsbUploadRate, 0));
+}
+
+void CReporterApplicationSettings::setUsbUploadRate(int rate)
+{
+    if (setValue(Bandwidth::ValueUsbUploadRate, rate))
+        emit usbUploadRateChanged();
+}
+
+int CReporterApplicationSettings::compressionMaxThreads() const
+{
+    const Q_D(CReporterApplicationSettings);
+
+    return qMax(1, d->intValue(Compression::ValueMaxThreads, 4));
+}
+
+void CReporterApplicationSettings::setCompressionMaxThreads(int count)
+{
+    if (setValue(Compression::ValueMaxThreads, count))
+        emit compressionMaxThreadsChanged();
+}
+
 QString CReporterApplicationSettings::proxyUrl() const
 {
     return value(Proxy::ValueProxyAddress, QStringLiteral("")).toString();
@@ -45,6 +45,37 @@ const QString ValueServerPort = "Server/server_port";
 const QString ValueServerPath = "Server/server_path";
 const QString ValueUseSsl = "Server/use_ssl";
 const QString ValueUseProxy = "Server/use_proxy";
+const QString ValueMaxParallelUploads = "Server/max_parallel_uploads";
+const QString ValueResumableUploads = "Server/resumable_uploads";
+const QString ValueUploadChunkSize = "Server/upload_chunk_size";
+const QString ValueRetryBaseDelay = "Server/retry_base_delay";
+const QString ValueRetryMaxDelay = "Server/retry_max_delay";
+const QString ValueRetryMaxAttempts = "Server/retry_max_attempts";
+const QString ValueBatchSizeLimit = "Server/batch_size_limit";
+const QString ValueBatchMaxFiles = "Server/batch_max_files";
+const QString ValueUploadOrder = "Server/upload_order";
+const QString ValueUploadAgingInterval = "Server/upload_aging_interval";
+}
+
+/*!
+  * @namespace Bandwidth
+  * @brief Key/ value pairs for upload rate limits, in KiB/s per bearer.
+  *
+  */
+namespace Bandwidth {
+const QString ValueWlanUploadRate = "Bandwidth/wlan_upload_rate";
+const QString ValueEthernetUploadRate = "Bandwidth/ethernet_upload_rate";
+const QString ValueMobileUploadRate = "Bandwidth/mobile_upload_rate";
+const QString ValueUsbUploadRate = "Bandwidth/usb_upload_rate";
+}
+
+/*!
+  * @namespace Compression
+  * @brief Key/ value pairs for compressing generated reports.
+  *
+  */
+namespace Compression {
+const QString ValueMaxThreads = "Compression/max_threads";
 }
 
 /*!
@@ -82,6 +113,21 @@ class CReporterApplicationSettings : public CReporterSettingsBase
     Q_PROPERTY(QString username READ username WRITE setUsername NOTIFY usernameChanged)
     Q_PROPERTY(QString password READ password WRITE setPassword NOTIFY passwordChanged)
     Q_PROPERTY(bool useProxy READ useProxy WRITE setUseProxy NOTIFY useProxyChanged)
+    Q_PROPERTY(int maxParallelUploads READ maxParallelUploads WRITE setMaxParallelUploads NOTIFY maxParallelUploadsChanged)
+    Q_PROPERTY(bool resumableUploads READ resumableUploads WRITE setResumableUploads NOTIFY resumableUploadsChanged)
+    Q_PROPERTY(int uploadChunkSize READ uploadChunkSize WRITE setUploadChunkSize NOTIFY uploadChunkSizeChanged)
+    Q_PROPERTY(int retryBaseDelay READ retryBaseDelay WRITE setRetryBaseDelay NOTIFY retryBaseDelayChanged)
+    Q_PROPERTY(int retryMaxDelay READ retryMaxDelay WRITE setRetryMaxDelay NOTIFY retryMaxDelayChanged)
+    Q_PROPERTY(int retryMaxAttempts READ retryMaxAttempts WRITE setRetryMaxAttempts NOTIFY retryMaxAttemptsChanged)
+    Q_PROPERTY(int batchSizeLimit READ batchSizeLimit WRITE setBatchSizeLimit NOTIFY batchSizeLimitChanged)
+    Q_PROPERTY(int batchMaxFiles READ batchMaxFiles WRITE setBatchMaxFiles NOTIFY batchMaxFilesChanged)
+    Q_PROPERTY(QString uploadOrder READ uploadOrder WRITE setUploadOrder NOTIFY uploadOrderChanged)
+    Q_PROPERTY(int uploadAgingInterval READ uploadAgingInterval WRITE setUploadAgingInterval NOTIFY uploadAgingIntervalChanged)
+    Q_PROPERTY(int wlanUploadRate READ wlanUploadRate WRITE setWlanUploadRate NOTIFY wlanUploadRateChanged)
+    Q_PROPERTY(int ethernetUploadRate READ ethernetUploadRate WRITE setEthernetUploadRate NOTIFY ethernetUploadRateChanged)
+    Q_PROPERTY(int mobileUploadRate READ mobileUploadRate WRITE setMobileUploadRate NOTIFY mobileUploadRateChanged)
+    Q_PROPERTY(int usbUploadRate READ usbUploadRate WRITE setUsbUploadRate NOTIFY usbUploadRateChanged)
+    Q_PROPERTY(int compressionMaxThreads READ compressionMaxThreads WRITE setCompressionMaxThreads NOTIFY compressionMaxThreadsChanged)
     Q_PROPERTY(QString proxyUrl READ proxyUrl WRITE setProxyUrl NOTIFY proxyUrlChanged)
     Q_PROPERTY(int proxyPort READ proxyPort WRITE setProxyPort NOTIFY proxyPortChanged)
     Q_PROPERTY(QString loggerType READ loggerType WRITE setLoggerType NOTIFY loggerTypeChanged)
@@ -123,6 +169,70 @@ public:
     bool useProxy() const;
     void setUseProxy(bool state);
 
+    int maxParallelUploads() const;
+    void setMaxParallelUploads(int count);
+
+    bool resumableUploads() const;
+    void setResumableUploads(bool state);
+
+    int uploadChunkSize() const;
+    void setUploadChunkSize(int size);
+
+    int retryBaseDelay() const;
+    void setRetryBaseDelay(int seconds);
+
+    int retryMaxDelay() const;
+    void setRetryMaxDelay(int seconds);
+
+    int retryMaxAttempts() const;
+    void setRetryMaxAttempts(int count);
+
+    /*!
+     * @brief Reports of at most this many bytes are uploaded in batches.
+     * 0 disables batching.
+     */
+    int batchSizeLimit() const;
+    void setBatchSizeLimit(int size);
+
+    int batchMaxFiles() const;
+    void setBatchMaxFiles(int count);
+
+    /*!
+     * @brief Order of uploads, "priority" or "fifo".
+     */
+    QString uploadOrder() const;
+    void setUploadOrder(const QString &order);
+
+    /*!
+     * @brief Seconds of waiting that raise a report by one class in
+     * priority order. 0 disables aging.
+     */
+    int uploadAgingInterval() const;
+    void setUploadAgingInterval(int seconds);
+
+    /*!
+     * @brief Upload rate limits in KiB/s for each bearer. 0 means no limit,
+     * which is the default.
+     */
+    int wlanUploadRate() const;
+    void setWlanUploadRate(int rate);
+
+    int ethernetUploadRate() const;
+    void setEthernetUploadRate(int rate);
+
+    int mobileUploadRate() const;
+    void setMobileUploadRate(int rate);
+
+    int usbUploadRate() const;
+    void setUsbUploadRate(int rate);
+
+    /*!
+     * @brief Maximum number of threads used for compressing endurance
+     * packages. Fewer are used if there are fewer CPUs online.
+     */
+    int compressionMaxThreads() const;
+    void setCompressionMaxThreads(int count);
+
     QString proxyUrl() const;
     void setProxyUrl(const QString &url);
 
@@ -140,6 +250,21 @@ signals:
     void usernameChanged();
     void passwordChanged();
     void useProxyChanged();
+    void maxParallelUploadsChanged();
+    void resumableUploadsChanged();
+    void uploadChunkSizeChanged();
+    void retryBaseDelayChanged();
+    void retryMaxDelayChanged();
+    void retryMaxAttemptsChanged();
+    void batchSizeLimitChanged();
+    void batchMaxFilesChanged();
+    void uploadOrderChanged();
+    void uploadAgingIntervalChanged();
+    void wlanUploadRateChanged();
+    void ethernetUploadRateChanged();
+    void mobileUploadRateChanged();
+    void usbUploadRateChanged();
+    void compressionMaxThreadsChanged();
     void proxyUrlChanged();
     void proxyPortChanged();
     void loggerTypeChanged();
@@ -31,6 +31,7 @@
 #include <QDebug>
 
 #include "creportersettingsbase.h"
+#include "creportersettingsobserver.h"
 #include "creporterprivacysettingsmodel.h"
 #include "creporternamespace.h"
 #include "../coredir/creportercoreregistry.h"
@@ -48,6 +49,8 @@ const QString UseHomePartition("Settings/use-home-partition");
 const QString AutoDeleteDuplicates("Settings/avoid-dups");
 //! Stores how many similar core dumps are kept when avoid-dups is enabled.
 const QString AutoDeleteMaxSimilarCores("Settings/maxsimilarcores");
+//! When true, occurrences of duplicate rich cores are recorded into a summary report.
+const QString AggregateDuplicates("Settings/aggregate-dups");
 //! When true, crash-reporter tries to upload rich-core dumps automatically.
 const QString AutomaticSending("Settings/automaticsending");
 //! True when user has accepted crash reporter's privacy notice.
@@ -115,6 +118,13 @@ void CReporterPrivacySettingsModel::freeSingleton()
 CReporterPrivacySettingsModel::CReporterPrivacySettingsModel()
     : CReporterSettingsBase("crash-reporter-settings", "crash-reporter-privacy")
 {
+    // Power saving is evaluated in the daemon, but set from the settings UI.
+    CReporterSettingsObserver *observer = new CReporterSettingsObserver(settingsFile(), this);
+    observer->addWatcher(Settings::RestrictWhenLowBattery);
+    observer->addWatcher(Settings::RestrictWhenDischarging);
+    observer->addWatcher(Settings::DischargingThreshold);
+    connect(observer, SIGNAL(valueChanged(QString, QVariant)),
+            this, SLOT(externalValueChanged(QString)));
 }
 
 CReporterPrivacySettingsModel::~CReporterPrivacySettingsModel()
@@ -168,6 +178,11 @@ int CReporterPrivacySettingsModel::autoDeleteMaxSimilarCores() const
     return value(Settings::AutoDeleteMaxSimilarCores, QVariant(5)).toInt();
 }
 
+bool CReporterPrivacySettingsModel::aggregateDuplicates() const
+{
+    return value(Settings::AggregateDuplicates, QVariant(false)).toBool();
+}
+
 bool CReporterPrivacySettingsModel::automaticSendingEnabled() const
 {
     return value(Settings::AutomaticSending, QVariant(true)).toBool();
@@ -287,6 +302,12 @@ void CReporterPrivacySettingsModel::setAutoDeleteMaxSimilarCores(int value)
     setValue(Settings::AutoDeleteMaxSimilarCores, QVariant(value));
 }
 
+void CReporterPrivacySettingsModel::setAggregateDuplicates(bool value)
+{
+    if (setValue(Settings::AggregateDuplicates, QVariant(value)))
+        emit aggregateDuplicatesChanged();
+}
+
 void CReporterPrivacySettingsModel::setAutomaticSendingEnabled(bool value)
 {
     if (setValue(Settings::AutomaticSending, QVariant(value)))
@@ -351,6 +372,20 @@ void CReporterPrivacySettingsModel::setDischargingThreshold(int value)
         emit dischargingThresholdChanged();
 }
 
+void CReporterPrivacySettingsModel::externalValueChanged(const QString &key)
+{
+    // Drop cached values so that the new one is read.
+    writeSettings();
+
+    if (key == Settings::RestrictWhenLowBattery) {
+        emit restrictWhenLowBatteryChanged();
+    } else if (key == Settings::RestrictWhenDischarging) {
+        emit restrictWhenDischargingChanged();
+    } else if (key == Settings::DischargingThreshold) {
+        emit dischargingThresholdChanged();
+    }
+}
+
 void CReporterPrivacySettingsModel::setReduceCore(bool value)
 {
     setValue(Privacy::ReduceCore, QVariant(value));
@@ -49,6 +49,7 @@ class CREPORTER_EXPORT CReporterPrivacySettingsModel : public CReporterSettingsB
     Q_PROPERTY(bool useHomePartition READ useHomePartitionEnabled WRITE setUseHomePartitionEnabled NOTIFY useHomePartitionEnabledChanged)
     Q_PROPERTY(bool notifications READ notificationsEnabled WRITE setNotificationsEnabled NOTIFY notificationsEnabledChanged)
     Q_PROPERTY(bool autoDeleteDuplicates READ autoDeleteDuplicates WRITE setAutoDeleteDuplicates NOTIFY autoDeleteDuplicatesChanged)
+    Q_PROPERTY(bool aggregateDuplicates READ aggregateDuplicates WRITE setAggregateDuplicates NOTIFY aggregateDuplicatesChanged)
     Q_PROPERTY(bool includeStackTrace READ includeStackTrace WRITE setIncludeStackTrace NOTIFY includeStackTraceChanged)
     Q_PROPERTY(bool downloadDebuginfo READ downloadDebuginfo WRITE setDownloadDebuginfo NOTIFY downloadDebuginfoChanged)
     Q_PROPERTY(bool privacyNoticeAccepted READ privacyNoticeAccepted WRITE setPrivacyNoticeAccepted NOTIFY privacyNoticeAcceptedChanged)
@@ -129,6 +130,16 @@ public:
       */
     int autoDeleteMaxSimilarCores() const;
 
+    /*!
+      * @brief Reads setting value for aggregating duplicate crash reports.
+      *
+      * When enabled, similar crashes beyond autoDeleteMaxSimilarCores() are
+      * recorded into a summary report instead of being uploaded or deleted.
+      *
+      * @return true if duplicates are aggregated; otherwise false.
+      */
+    bool aggregateDuplicates() const;
+
     /*!
       * @brief Reads setting value for automatic sending and returns it.
       *
@@ -281,6 +292,13 @@ public:
       */
     void setAutoDeleteMaxSimilarCores(int value);
 
+    /*!
+      * @brief Enables or disables aggregation of duplicate crash reports.
+      *
+      * @param True to enable feature; false to disable.
+      */
+    void setAggregateDuplicates(bool value);
+
     /*!
        * @brief Enables or disables automatic sending.
        *
@@ -381,6 +399,7 @@ signals:
     void useHomePartitionEnabledChanged();
     void notificationsEnabledChanged();
     void autoDeleteDuplicatesChanged();
+    void aggregateDuplicatesChanged();
     void automaticSendingEnabledChanged();
     void includeStackTraceChanged();
     void downloadDebuginfoChanged();
@@ -393,6 +412,10 @@ signals:
 protected:
     CReporterPrivacySettingsModel();
 
+private Q_SLOTS:
+    //! @arg Handles a change seen in the settings file, e.g. by another process.
+    void externalValueChanged(const QString &key);
+
 private:
     Q_DISABLE_COPY(CReporterPrivacySettingsModel)
 
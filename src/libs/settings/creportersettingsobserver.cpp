@@ -0,0 +1,107 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+
+#include "creportersettingsobserver.h"
+#include "creportersettingsobserver_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+CReporterSettingsObserverPrivate::CReporterSettingsObserverPrivate(CReporterSettingsObserver *q)
+    : q_ptr(q)
+{
+}
+
+void CReporterSettingsObserverPrivate::rewatch()
+{
+    if (!watcher.files().contains(settingsFile) && QFile::exists(settingsFile)) {
+        watcher.addPath(settingsFile);
+    }
+}
+
+void CReporterSettingsObserverPrivate::fileChanged()
+{
+    Q_Q(CReporterSettingsObserver);
+
+    rewatch();
+
+    if (values.isEmpty() || !QFile::exists(settingsFile)) {
+        return;
+    }
+
+    QSettings settings(settingsFile, QSettings::NativeFormat);
+    // Picks up what was written by other processes.
+    settings.sync();
+
+    QHash<QString, QVariant>::iterator it = values.begin();
+    for (; it != values.end(); ++it) {
+        QVariant value = settings.value(it.key());
+        if (value != it.value()) {
+            qCDebug(cr) << "Setting" << it.key() << "changed to" << value;
+            it.value() = value;
+            emit q->valueChanged(it.key(), value);
+        }
+    }
+}
+
+CReporterSettingsObserver::CReporterSettingsObserver(const QString &settingsFile,
+                                                     QObject *parent)
+    : QObject(parent),
+      d_ptr(new CReporterSettingsObserverPrivate(this))
+{
+    Q_D(CReporterSettingsObserver);
+
+    d->settingsFile = settingsFile;
+    d->watcher.addPath(QFileInfo(settingsFile).absolutePath());
+    d->rewatch();
+
+    connect(&d->watcher, SIGNAL(fileChanged(QString)), this, SLOT(fileChanged()));
+    connect(&d->watcher, SIGNAL(directoryChanged(QString)), this, SLOT(fileChanged()));
+}
+
+CReporterSettingsObserver::~CReporterSettingsObserver()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+void CReporterSettingsObserver::addWatcher(const QString &key)
+{
+    Q_D(CReporterSettingsObserver);
+
+    if (!d->values.contains(key)) {
+        QSettings settings(d->settingsFile, QSettings::NativeFormat);
+        d->values.insert(key, settings.value(key));
+    }
+}
+
+void CReporterSettingsObserver::removeWatcher(const QString &key)
+{
+    Q_D(CReporterSettingsObserver);
+
+    d->values.remove(key);
+}
+
+#include "moc_creportersettingsobserver.cpp"
@@ -0,0 +1,84 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSETTINGSOBSERVER_H
+#define CREPORTERSETTINGSOBSERVER_H
+
+#include <QObject>
+#include <QVariant>
+
+#include "creporterexport.h"
+
+class CReporterSettingsObserverPrivate;
+
+/*!
+  * @class CReporterSettingsObserver
+  * @brief Notifies of settings changed in the settings file.
+  *
+  * Unlike CReporterSettingsBase::valueChanged(), changes written by other
+  * processes are noticed as well.
+  */
+class CREPORTER_EXPORT CReporterSettingsObserver : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Class constructor.
+     *
+     * @param settingsFile Absolute path of the settings file to observe.
+     * @param parent Parent object.
+     */
+    CReporterSettingsObserver(const QString &settingsFile, QObject *parent = 0);
+
+    virtual ~CReporterSettingsObserver();
+
+    /*!
+     * @brief Starts following changes of @a key.
+     *
+     * @param key Setting key.
+     */
+    void addWatcher(const QString &key);
+
+    /*!
+     * @brief Stops following changes of @a key.
+     *
+     * @param key Setting key.
+     */
+    void removeWatcher(const QString &key);
+
+Q_SIGNALS:
+    /*!
+      * @brief Sent, when watched @a key has changed to @a value.
+      *
+      * @param key Changed key.
+      * @param value New value.
+      */
+    void valueChanged(const QString &key, const QVariant &value);
+
+private:
+    Q_DISABLE_COPY(CReporterSettingsObserver)
+    Q_DECLARE_PRIVATE(CReporterSettingsObserver)
+    CReporterSettingsObserverPrivate *d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void fileChanged())
+};
+
+#endif // CREPORTERSETTINGSOBSERVER_H
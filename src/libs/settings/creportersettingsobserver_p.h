@@ -0,0 +1,56 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSETTINGSOBSERVER_P_H
+#define CREPORTERSETTINGSOBSERVER_P_H
+
+#include <QFileSystemWatcher>
+#include <QHash>
+
+#include "creportersettingsobserver.h"
+
+/*!
+  * @class CReporterSettingsObserverPrivate
+  * @brief Private data class for CReporterSettingsObserver.
+  *
+  * @sa CReporterSettingsObserver
+  */
+class CReporterSettingsObserverPrivate
+{
+public:
+    CReporterSettingsObserverPrivate(CReporterSettingsObserver *q);
+
+    //! @arg Watches the settings file again after it has been replaced.
+    void rewatch();
+    void fileChanged();
+
+    //! @arg Observed settings file.
+    QString settingsFile;
+    //! @arg Watches the file and its directory, as the file is replaced on writing.
+    QFileSystemWatcher watcher;
+    //! @arg Last known value of each watched key.
+    QHash<QString, QVariant> values;
+
+private:
+    Q_DECLARE_PUBLIC(CReporterSettingsObserver)
+    CReporterSettingsObserver *q_ptr;
+};
+
+#endif // CREPORTERSETTINGSOBSERVER_P_H
@@ -0,0 +1,149 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <limits.h>
+
+#include "creportercrashinfo.h"
+#include "creporternamespace.h"
+
+namespace {
+/*
+ * Parses decimal number from [begin, end). Returns false if the range is
+ * empty, contains something else than digits or doesn't fit into int.
+ */
+bool parseNumber(const QChar *begin, const QChar *end, int *result)
+{
+    if (begin == end) {
+        return false;
+    }
+
+    qint64 value = 0;
+    for (const QChar *c = begin; c != end; ++c) {
+        ushort digit = c->unicode() - '0';
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+        if (value > INT_MAX) {
+            return false;
+        }
+    }
+
+    *result = static_cast<int>(value);
+    return true;
+}
+
+bool startsWith(const QChar *begin, const QChar *end, const QString &prefix)
+{
+    if (end - begin < prefix.size()) {
+        return false;
+    }
+
+    const QChar *p = prefix.constData();
+    for (const QChar *c = begin; c != begin + prefix.size(); ++c, ++p) {
+        if (*c != *p) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CReporterCrashInfo::ReportType reportType(const QChar *begin, const QChar *end)
+{
+    static const struct {
+        const QString &prefix;
+        CReporterCrashInfo::ReportType type;
+    } types[] = {
+        { CReporter::QuickFeedbackPrefix, CReporterCrashInfo::QuickFeedback },
+        { CReporter::EndurancePackagePrefix, CReporterCrashInfo::Endurance },
+        { CReporter::PowerExcessPrefix, CReporterCrashInfo::PowerExcess },
+        { CReporter::OneshotFailurePrefix, CReporterCrashInfo::OneshotFailure },
+        { CReporter::OverheatShutdownPrefix, CReporterCrashInfo::OverheatShutdown },
+        { CReporter::JournalSpyPrefix, CReporterCrashInfo::JournalSpy },
+        { CReporter::HWSMPLPrefix, CReporterCrashInfo::HWSMPL },
+        { CReporter::HWrebootPrefix, CReporterCrashInfo::HWReboot },
+        { CReporter::DuplicateSummaryPrefix, CReporterCrashInfo::DuplicateSummary },
+    };
+
+    for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); ++i) {
+        if (startsWith(begin, end, types[i].prefix)) {
+            return types[i].type;
+        }
+    }
+
+    return CReporterCrashInfo::Crash;
+}
+} // namespace
+
+CReporterCrashInfo::CReporterCrashInfo()
+    : m_signalNumber(0), m_pid(0), m_type(Crash), m_valid(false)
+{
+}
+
+CReporterCrashInfo CReporterCrashInfo::fromFileName(const QString &filePath)
+{
+    CReporterCrashInfo info;
+
+    const QChar *data = filePath.constData();
+    const QChar *end = data + filePath.size();
+
+    if (filePath.endsWith(QLatin1String(".rcore.lzo"))) {
+        end -= 10;
+    } else if (filePath.endsWith(QLatin1String(".rcore"))) {
+        end -= 6;
+    }
+
+    /* Walk backwards from the end of the name, remembering the three
+     * rightmost dashes (before PID, SIGNUM and HWID) and stopping at the
+     * directory separator. An unknown suffix is cut off at its first dot. */
+    const QChar *dashes[3];
+    int dashCount = 0;
+    const QChar *begin = data;
+
+    for (const QChar *c = end; c != data;) {
+        --c;
+        if (*c == QLatin1Char('/')) {
+            begin = c + 1;
+            break;
+        } else if (*c == QLatin1Char('-') && dashCount < 3) {
+            dashes[dashCount++] = c;
+        } else if (*c == QLatin1Char('.') && dashCount < 3) {
+            end = c;
+            dashCount = 0;
+        }
+    }
+
+    if (dashCount < 3) {
+        info.m_applicationName = QString(begin, end - begin);
+        info.m_type = reportType(begin, end);
+        return info;
+    }
+
+    info.m_applicationName = QString(begin, dashes[2] - begin);
+    info.m_hwId = QString(dashes[2] + 1, dashes[1] - dashes[2] - 1);
+    info.m_type = reportType(begin, dashes[2]);
+
+    bool signalOk = parseNumber(dashes[1] + 1, dashes[0], &info.m_signalNumber);
+    bool pidOk = parseNumber(dashes[0] + 1, end, &info.m_pid);
+    info.m_valid = signalOk && pidOk;
+
+    return info;
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCRASHINFO_H
+#define CREPORTERCRASHINFO_H
+
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterCrashInfo
+ * @brief Details of a rich core report encoded in its file name.
+ *
+ * Rich core file names have the format
+ * application_name-hwid-signum-pid.rcore.lzo. Application name may itself
+ * contain dashes, so the name is parsed from the end.
+ */
+class CREPORTER_EXPORT CReporterCrashInfo
+{
+public:
+    //! Kind of the report, derived from the application name.
+    enum ReportType {
+        //! Application crash or termination.
+        Crash = 0,
+        //! Quick feedback message.
+        QuickFeedback,
+        //! Pack of endurance snapshots.
+        Endurance,
+        //! System logs collected on power excess uevent.
+        PowerExcess,
+        //! System logs collected after oneshot script failure.
+        OneshotFailure,
+        //! System logs collected after overheating shutdown.
+        OverheatShutdown,
+        //! System logs collected by journal spy.
+        JournalSpy,
+        //! Hardware reboot logs.
+        HWReboot,
+        //! Hardware SMPL reboot logs.
+        HWSMPL,
+        //! Occurrences of duplicate crashes.
+        DuplicateSummary
+    };
+
+    CReporterCrashInfo();
+
+    /*!
+     * @brief Parses crash details from a rich core file name or path.
+     *
+     * The name is read in a single pass, without temporary strings.
+     *
+     * @param filePath Rich core file name, with or without directory.
+     * @return Parsed details. Check isValid() for success.
+     */
+    static CReporterCrashInfo fromFileName(const QString &filePath);
+
+    /*!
+     * @brief Returns true if all fields were found in the file name.
+     */
+    bool isValid() const { return m_valid; }
+
+    QString applicationName() const { return m_applicationName; }
+    QString hwId() const { return m_hwId; }
+    int signalNumber() const { return m_signalNumber; }
+    int pid() const { return m_pid; }
+    ReportType type() const { return m_type; }
+
+    /*!
+     * @brief Returns true if the report was created from a crashed
+     * application, i.e. it isn't a log or feedback package.
+     */
+    bool includesCrash() const { return m_type == Crash; }
+
+private:
+    QString m_applicationName;
+    QString m_hwId;
+    int m_signalNumber;
+    int m_pid;
+    ReportType m_type;
+    bool m_valid;
+};
+
+Q_DECLARE_TYPEINFO(CReporterCrashInfo, Q_MOVABLE_TYPE);
+
+#endif // CREPORTERCRASHINFO_H
@@ -0,0 +1,188 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <deviceinfo.h>
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+#include <QTimer>
+
+#include "creporterdeviceidentity.h"
+#include "creporterutils.h"
+#include "../ssu_interface.h" // generated
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+// Time (ms) to wait for the first answer from SSU.
+const int ResolveTimeout = 3000;
+
+QDBusConnection ssuBus()
+{
+#ifndef CREPORTER_UNIT_TEST
+    return QDBusConnection::systemBus();
+#else
+    // Tests provide SSU on the session bus.
+    return QDBusConnection::sessionBus();
+#endif
+}
+} // namespace
+
+class CReporterDeviceIdentityPrivate
+{
+public:
+    CReporterDeviceIdentityPrivate(CReporterDeviceIdentity *q);
+
+    void refresh();
+    void onUidReceived(QDBusPendingCallWatcher *watcher);
+    void resolve();
+
+    OrgNemoSsuInterface *ssuProxy;
+    //! @arg Query in progress, if any.
+    QDBusPendingCallWatcher *uidCall;
+    //! @arg Limits waiting for the first answer.
+    QTimer resolveTimer;
+    bool resolved;
+    QString deviceUid;
+    QString deviceModel;
+
+    Q_DECLARE_PUBLIC(CReporterDeviceIdentity)
+    CReporterDeviceIdentity *q_ptr;
+};
+
+CReporterDeviceIdentityPrivate::CReporterDeviceIdentityPrivate(CReporterDeviceIdentity *q)
+    : ssuProxy(0), uidCall(0), resolved(false), q_ptr(q)
+{
+}
+
+void CReporterDeviceIdentityPrivate::refresh()
+{
+    Q_Q(CReporterDeviceIdentity);
+
+    if (uidCall) {
+        // Newer answer is coming anyway.
+        uidCall->disconnect();
+        uidCall->deleteLater();
+    }
+
+    uidCall = new QDBusPendingCallWatcher(ssuProxy->deviceUid(), q);
+    QObject::connect(uidCall, SIGNAL(finished(QDBusPendingCallWatcher *)),
+                     q, SLOT(onUidReceived(QDBusPendingCallWatcher *)));
+}
+
+void CReporterDeviceIdentityPrivate::onUidReceived(QDBusPendingCallWatcher *watcher)
+{
+    Q_Q(CReporterDeviceIdentity);
+
+    QDBusPendingReply<QString> reply = *watcher;
+    watcher->deleteLater();
+    uidCall = 0;
+
+    if (reply.isError()) {
+        qCWarning(cr) << "DBus unavailable, UUID might be incorrect.";
+    } else if (reply.value() != deviceUid) {
+        deviceUid = reply.value();
+        emit q->deviceUidChanged();
+    }
+
+    resolve();
+}
+
+void CReporterDeviceIdentityPrivate::resolve()
+{
+    Q_Q(CReporterDeviceIdentity);
+
+    resolveTimer.stop();
+    if (!resolved) {
+        if (uidCall) {
+            qCWarning(cr) << "SSU didn't answer in time, UUID might be incorrect.";
+        }
+        resolved = true;
+        emit q->resolved();
+    }
+}
+
+CReporterDeviceIdentity *CReporterDeviceIdentity::sm_Instance = 0;
+
+CReporterDeviceIdentity *CReporterDeviceIdentity::instance()
+{
+    if (sm_Instance == 0) {
+        sm_Instance = new CReporterDeviceIdentity();
+    }
+    return sm_Instance;
+}
+
+void CReporterDeviceIdentity::freeSingleton()
+{
+    if (sm_Instance != 0) {
+        delete sm_Instance;
+        sm_Instance = 0;
+    }
+}
+
+CReporterDeviceIdentity::CReporterDeviceIdentity()
+    : d_ptr(new CReporterDeviceIdentityPrivate(this))
+{
+    Q_D(CReporterDeviceIdentity);
+
+    // Local fallbacks, used as they are if SSU can't be reached.
+    DeviceInfo info(true);
+    d->deviceUid = info.deviceUid();
+    d->deviceModel = info.model();
+
+    d->ssuProxy = new OrgNemoSsuInterface("org.nemo.ssu", "/org/nemo/ssu",
+                                          ssuBus(), this);
+    connect(d->ssuProxy, SIGNAL(registrationStatusChanged()), this, SLOT(refresh()));
+
+    d->resolveTimer.setSingleShot(true);
+    d->resolveTimer.setInterval(ResolveTimeout);
+    connect(&d->resolveTimer, SIGNAL(timeout()), this, SLOT(resolve()));
+    d->resolveTimer.start();
+
+    d->refresh();
+}
+
+CReporterDeviceIdentity::~CReporterDeviceIdentity()
+{
+}
+
+QString CReporterDeviceIdentity::deviceUid() const
+{
+    Q_D(const CReporterDeviceIdentity);
+
+    return d->deviceUid;
+}
+
+bool CReporterDeviceIdentity::isResolved() const
+{
+    Q_D(const CReporterDeviceIdentity);
+
+    return d->resolved;
+}
+
+QString CReporterDeviceIdentity::deviceModel() const
+{
+    Q_D(const CReporterDeviceIdentity);
+
+    return d->deviceModel;
+}
+
+#include "moc_creporterdeviceidentity.cpp"
@@ -0,0 +1,104 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERDEVICEIDENTITY_H
+#define CREPORTERDEVICEIDENTITY_H
+
+#include <QObject>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterDeviceIdentityPrivate;
+class QDBusPendingCallWatcher;
+
+/*!
+ * @class CReporterDeviceIdentity
+ * @brief Cached device UID and model.
+ *
+ * The model is read once. The UID is asked from SSU asynchronously when the
+ * instance is created and again when SSU reports a registration change.
+ * Until SSU has answered, the UID from DeviceInfo is used, so reading the
+ * identity never waits for D-Bus. Users that would rather have the SSU UID
+ * can wait for resolved().
+ */
+class CREPORTER_EXPORT CReporterDeviceIdentity : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates a new instance of this class if it doesn't exist and returns it.
+     *
+     * Create the instance early to have the SSU UID ready when it's needed.
+     *
+     * @return Class instance.
+     */
+    static CReporterDeviceIdentity *instance();
+
+    /*!
+     * @brief Frees the class instance.
+     */
+    static void freeSingleton();
+
+    /*!
+     * @brief Returns the device ID used in SSU requests.
+     */
+    QString deviceUid() const;
+
+    /*!
+     * @brief Tells whether SSU has answered or waiting for it has timed out.
+     */
+    bool isResolved() const;
+
+    /*!
+     * @brief Returns model of the device.
+     */
+    QString deviceModel() const;
+
+Q_SIGNALS:
+    /*!
+     * @brief Sent when the device UID has changed.
+     */
+    void deviceUidChanged();
+
+    /*!
+     * @brief Sent once, when the device UID is as good as it gets.
+     *
+     * @sa isResolved()
+     */
+    void resolved();
+
+private:
+    CReporterDeviceIdentity();
+    ~CReporterDeviceIdentity();
+
+    Q_DISABLE_COPY(CReporterDeviceIdentity)
+    Q_DECLARE_PRIVATE(CReporterDeviceIdentity)
+    QScopedPointer<CReporterDeviceIdentityPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void refresh())
+    Q_PRIVATE_SLOT(d_func(), void onUidReceived(QDBusPendingCallWatcher *))
+    Q_PRIVATE_SLOT(d_func(), void resolve())
+
+    static CReporterDeviceIdentity *sm_Instance;
+};
+
+#endif // CREPORTERDEVICEIDENTITY_H
@@ -0,0 +1,322 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <string.h>
+#include <lzo/lzo1x.h>
+
+#include <QFile>
+#include <QtEndian>
+
+#include "creporterlzoreader.h"
+
+namespace {
+const char LzopMagic[] = { '\x89', 'L', 'Z', 'O', '\0', '\r', '\n', '\x1a', '\n' };
+const int LzopMagicSize = sizeof(LzopMagic);
+
+// Flags of the lzop file header.
+const quint32 AdlerDecompressed = 0x00000001;
+const quint32 AdlerCompressed = 0x00000002;
+const quint32 ExtraField = 0x00000040;
+const quint32 CrcDecompressed = 0x00000100;
+const quint32 CrcCompressed = 0x00000200;
+const quint32 Filter = 0x00000800;
+
+// lzop never writes larger blocks.
+const quint32 MaxBlockSize = 64 * 1024 * 1024;
+
+bool readBytes(QIODevice *device, char *data, qint64 size)
+{
+    return device->read(data, size) == size;
+}
+
+bool readU8(QIODevice *device, quint8 *value)
+{
+    return device->getChar(reinterpret_cast<char *>(value));
+}
+
+bool readU16(QIODevice *device, quint16 *value)
+{
+    uchar data[2];
+    if (!readBytes(device, reinterpret_cast<char *>(data), sizeof(data))) {
+        return false;
+    }
+    *value = qFromBigEndian<quint16>(data);
+    return true;
+}
+
+bool readU32(QIODevice *device, quint32 *value)
+{
+    uchar data[4];
+    if (!readBytes(device, reinterpret_cast<char *>(data), sizeof(data))) {
+        return false;
+    }
+    *value = qFromBigEndian<quint32>(data);
+    return true;
+}
+
+bool skip(QIODevice *device, qint64 size)
+{
+    return device->read(size).size() == size;
+}
+} // namespace
+
+class CReporterLzoReaderPrivate
+{
+public:
+    CReporterLzoReaderPrivate();
+
+    bool readStreamHeader();
+    bool readBlockHeader();
+    bool setError(const QString &message);
+
+    QFile file;
+    quint32 flags;
+    bool atEnd;
+    QString error;
+
+    //! @arg Header of the block about to be read.
+    quint32 decodedLength;
+    quint32 encodedLength;
+    quint32 decodedChecksum;
+    quint32 decodedCrc;
+};
+
+CReporterLzoReaderPrivate::CReporterLzoReaderPrivate()
+    : flags(0), atEnd(false), decodedLength(0), encodedLength(0),
+      decodedChecksum(0), decodedCrc(0)
+{
+}
+
+bool CReporterLzoReaderPrivate::setError(const QString &message)
+{
+    error = message;
+    atEnd = true;
+    return false;
+}
+
+bool CReporterLzoReaderPrivate::readStreamHeader()
+{
+    quint16 version, libVersion, versionNeeded;
+    quint8 method, level, nameLength;
+    quint32 mode, mtime, checksum;
+
+    if (!readU16(&file, &version) || !readU16(&file, &libVersion)
+            || (version >= 0x0940 && !readU16(&file, &versionNeeded))
+            || !readU8(&file, &method)
+            || (version >= 0x0940 && !readU8(&file, &level))
+            || !readU32(&file, &flags)) {
+        return setError("Truncated lzop header");
+    }
+
+    // Methods 1-3 are the LZO1X variants, which share one decompressor.
+    if (method < 1 || method > 3) {
+        return setError(QString("Unsupported lzop method %1").arg(method));
+    }
+    if (flags & Filter) {
+        return setError("Filtered lzop files are not supported");
+    }
+
+    if (!readU32(&file, &mode) || !readU32(&file, &mtime)
+            || (version >= 0x0940 && !readU32(&file, &mtime))
+            || !readU8(&file, &nameLength) || !skip(&file, nameLength)
+            || !readU32(&file, &checksum)) {
+        return setError("Truncated lzop header");
+    }
+
+    if (flags & ExtraField) {
+        quint32 extraLength;
+        if (!readU32(&file, &extraLength) || !skip(&file, extraLength)
+                || !readU32(&file, &checksum)) {
+            return setError("Truncated lzop header");
+        }
+    }
+
+    return true;
+}
+
+bool CReporterLzoReaderPrivate::readBlockHeader()
+{
+    if (atEnd) {
+        return false;
+    }
+
+    forever {
+        if (!readU32(&file, &decodedLength)) {
+            return setError("Truncated lzop file");
+        }
+        if (decodedLength != 0) {
+            break;
+        }
+
+        /* End of stream. Further data is appended to rich cores as
+         * concatenated lzop streams. */
+        char magic[LzopMagicSize];
+        qint64 length = file.read(magic, LzopMagicSize);
+        if (length == 0) {
+            atEnd = true;
+            return false;
+        }
+        if (length != LzopMagicSize || memcmp(magic, LzopMagic, LzopMagicSize) != 0) {
+            return setError("Garbage after lzop stream");
+        }
+        if (!readStreamHeader()) {
+            return false;
+        }
+    }
+
+    quint32 checksum;
+    if (!readU32(&file, &encodedLength)
+            || ((flags & AdlerDecompressed) && !readU32(&file, &decodedChecksum))
+            || ((flags & CrcDecompressed) && !readU32(&file, &decodedCrc))) {
+        return setError("Truncated lzop block header");
+    }
+
+    if (decodedLength > MaxBlockSize || encodedLength > decodedLength) {
+        return setError("Corrupted lzop block header");
+    }
+
+    if (encodedLength < decodedLength
+            && (((flags & AdlerCompressed) && !readU32(&file, &checksum))
+                || ((flags & CrcCompressed) && !readU32(&file, &checksum)))) {
+        return setError("Truncated lzop block header");
+    }
+
+    return true;
+}
+
+CReporterLzoReader::CReporterLzoReader(const QString &filePath)
+    : d_ptr(new CReporterLzoReaderPrivate)
+{
+    Q_D(CReporterLzoReader);
+
+    d->file.setFileName(filePath);
+}
+
+CReporterLzoReader::~CReporterLzoReader()
+{
+}
+
+bool CReporterLzoReader::open()
+{
+    Q_D(CReporterLzoReader);
+
+    if (lzo_init() != LZO_E_OK) {
+        return d->setError("Initializing LZO library failed");
+    }
+
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        return d->setError(d->file.errorString());
+    }
+
+    char magic[LzopMagicSize];
+    if (!readBytes(&d->file, magic, LzopMagicSize)
+            || memcmp(magic, LzopMagic, LzopMagicSize) != 0) {
+        return d->setError("Not an lzop file");
+    }
+
+    return d->readStreamHeader();
+}
+
+bool CReporterLzoReader::readBlock(QByteArray *buffer)
+{
+    Q_D(CReporterLzoReader);
+
+    if (!d->readBlockHeader()) {
+        return false;
+    }
+
+    QByteArray encoded(d->file.read(d->encodedLength));
+    if (encoded.size() != static_cast<int>(d->encodedLength)) {
+        return d->setError("Truncated lzop block");
+    }
+
+    int offset = buffer->size();
+    if (d->encodedLength == d->decodedLength) {
+        // Incompressible blocks are stored as they are.
+        buffer->append(encoded);
+    } else {
+        buffer->resize(offset + d->decodedLength);
+        lzo_uint length = d->decodedLength;
+        int result = lzo1x_decompress_safe(
+                    reinterpret_cast<lzo_bytep>(encoded.data()), d->encodedLength,
+                    reinterpret_cast<lzo_bytep>(buffer->data() + offset), &length, 0);
+        if (result != LZO_E_OK || length != d->decodedLength) {
+            buffer->resize(offset);
+            return d->setError(QString("Decompressing lzop block failed (%1)").arg(result));
+        }
+    }
+
+    lzo_bytep decoded = reinterpret_cast<lzo_bytep>(buffer->data() + offset);
+    if (((d->flags & AdlerDecompressed)
+         && lzo_adler32(1, decoded, d->decodedLength) != d->decodedChecksum)
+            || ((d->flags & CrcDecompressed)
+                && lzo_crc32(0, decoded, d->decodedLength) != d->decodedCrc)) {
+        buffer->resize(offset);
+        return d->setError("lzop block checksum mismatch");
+    }
+
+    return true;
+}
+
+bool CReporterLzoReader::skipBlock(quint32 *decompressedLength)
+{
+    Q_D(CReporterLzoReader);
+
+    if (!d->readBlockHeader()) {
+        return false;
+    }
+
+    if (!d->file.seek(d->file.pos() + d->encodedLength) || d->file.pos() > d->file.size()) {
+        return d->setError("Truncated lzop block");
+    }
+
+    *decompressedLength = d->decodedLength;
+    return true;
+}
+
+bool CReporterLzoReader::atEnd() const
+{
+    Q_D(const CReporterLzoReader);
+
+    return d->atEnd && d->error.isEmpty();
+}
+
+QString CReporterLzoReader::errorString() const
+{
+    Q_D(const CReporterLzoReader);
+
+    return d->error;
+}
+
+qint64 CReporterLzoReader::decompressedSize(const QString &filePath)
+{
+    CReporterLzoReader reader(filePath);
+    if (!reader.open()) {
+        return -1;
+    }
+
+    qint64 size = 0;
+    quint32 length;
+    while (reader.skipBlock(&length)) {
+        size += length;
+    }
+
+    return reader.atEnd() ? size : -1;
+}
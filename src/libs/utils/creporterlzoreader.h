@@ -0,0 +1,90 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOREADER_H
+#define CREPORTERLZOREADER_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterLzoReaderPrivate;
+
+/*!
+ * @class CReporterLzoReader
+ * @brief Block by block decoder of lzop files.
+ *
+ * Only one block (at most 256 KiB when written by lzop) is decompressed at
+ * a time. Concatenated lzop streams, as produced by appending to rich cores,
+ * are read as one.
+ */
+class CREPORTER_EXPORT CReporterLzoReader
+{
+public:
+    explicit CReporterLzoReader(const QString &filePath);
+    ~CReporterLzoReader();
+
+    /*!
+     * @brief Opens the file and reads the lzop header.
+     *
+     * @return true on success; otherwise false and errorString() tells why.
+     */
+    bool open();
+
+    /*!
+     * @brief Decompresses the next block to the end of @a buffer.
+     *
+     * @return false at the end of the file or on error.
+     */
+    bool readBlock(QByteArray *buffer);
+
+    /*!
+     * @brief Skips the next block without decompressing it.
+     *
+     * @param decompressedLength Set to the decompressed length of the block.
+     * @return false at the end of the file or on error.
+     */
+    bool skipBlock(quint32 *decompressedLength);
+
+    /*!
+     * @brief Returns true when the file was read to the end without errors.
+     */
+    bool atEnd() const;
+
+    /*!
+     * @brief Returns description of the last error, or empty string.
+     */
+    QString errorString() const;
+
+    /*!
+     * @brief Returns length of the decompressed contents of @a filePath,
+     * like lzop --ls, or -1 if the file can't be read.
+     */
+    static qint64 decompressedSize(const QString &filePath);
+
+private:
+    Q_DISABLE_COPY(CReporterLzoReader)
+    Q_DECLARE_PRIVATE(CReporterLzoReader)
+    QScopedPointer<CReporterLzoReaderPrivate> d_ptr;
+};
+
+#endif // CREPORTERLZOREADER_H
@@ -0,0 +1,291 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <lzo/lzo1x.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QtEndian>
+
+#include "creporterlzowriter.h"
+
+namespace {
+const char LzopMagic[] = { '\x89', 'L', 'Z', 'O', '\0', '\r', '\n', '\x1a', '\n' };
+
+// Values written by lzop 1.03 for its default compression method.
+const quint16 LzopVersion = 0x1030;
+const quint16 VersionNeeded = 0x0940;
+const quint8 MethodLzo1x1 = 1;
+const quint8 Level = 5;
+
+// Flags of the lzop file header.
+const quint32 AdlerDecompressed = 0x00000001;
+const quint32 AdlerCompressed = 0x00000002;
+const quint32 OsUnix = 0x03000000;
+
+const quint32 RegularFileMode = 0100644;
+
+// Same as lzop, older versions refuse larger blocks.
+const int BlockSize = 256 * 1024;
+
+void putU8(QByteArray *data, quint8 value)
+{
+    data->append(static_cast<char>(value));
+}
+
+void putU16(QByteArray *data, quint16 value)
+{
+    uchar bytes[2];
+    qToBigEndian(value, bytes);
+    data->append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+void putU32(QByteArray *data, quint32 value)
+{
+    uchar bytes[4];
+    qToBigEndian(value, bytes);
+    data->append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+quint32 adler32(const char *data, int size)
+{
+    // liblzo2 doesn't declare its input buffers const.
+    return lzo_adler32(1, reinterpret_cast<lzo_bytep>(const_cast<char *>(data)), size);
+}
+} // namespace
+
+class CReporterLzoWriterPrivate
+{
+public:
+    CReporterLzoWriterPrivate();
+
+    bool writeBlock(const char *data, int size);
+    bool writeRaw(const QByteArray &data);
+    bool setError(const QString &message);
+
+    QFile file;
+    qint64 originalSize;
+    bool opened;
+    bool stored;
+    //! @arg Uncompressed data waiting for a full block.
+    QByteArray pending;
+    QByteArray compressed;
+    QByteArray workMemory;
+    QString error;
+};
+
+CReporterLzoWriterPrivate::CReporterLzoWriterPrivate()
+    : originalSize(0), opened(false), stored(false)
+{
+}
+
+bool CReporterLzoWriterPrivate::setError(const QString &message)
+{
+    error = message;
+    if (opened) {
+        file.resize(originalSize);
+        file.close();
+        opened = false;
+    }
+    return false;
+}
+
+bool CReporterLzoWriterPrivate::writeRaw(const QByteArray &data)
+{
+    if (file.write(data) != data.size()) {
+        return setError(file.errorString());
+    }
+    return true;
+}
+
+bool CReporterLzoWriterPrivate::writeBlock(const char *data, int size)
+{
+    lzo_uint compressedSize = size;
+
+    if (!stored) {
+        if (compressed.isEmpty()) {
+            // Worst case expansion of LZO1X.
+            compressed.resize(BlockSize + BlockSize / 16 + 64 + 3);
+            workMemory.resize(LZO1X_1_MEM_COMPRESS);
+        }
+
+        compressedSize = compressed.size();
+        int result = lzo1x_1_compress(reinterpret_cast<lzo_bytep>(const_cast<char *>(data)), size,
+                                      reinterpret_cast<lzo_bytep>(compressed.data()),
+                                      &compressedSize, workMemory.data());
+        if (result != LZO_E_OK) {
+            return setError(QString("Compressing lzop block failed (%1)").arg(result));
+        }
+    }
+
+    QByteArray header;
+    putU32(&header, size);
+
+    // Data that doesn't compress is stored as is, without the second checksum.
+    if (compressedSize < lzo_uint(size)) {
+        putU32(&header, compressedSize);
+        putU32(&header, adler32(data, size));
+        putU32(&header, adler32(compressed.constData(), compressedSize));
+        return writeRaw(header) && writeRaw(QByteArray::fromRawData(compressed.constData(),
+                                                                    compressedSize));
+    }
+
+    putU32(&header, size);
+    putU32(&header, adler32(data, size));
+    return writeRaw(header) && writeRaw(QByteArray::fromRawData(data, size));
+}
+
+CReporterLzoWriter::CReporterLzoWriter(const QString &filePath)
+    : d_ptr(new CReporterLzoWriterPrivate)
+{
+    Q_D(CReporterLzoWriter);
+
+    d->file.setFileName(filePath);
+}
+
+CReporterLzoWriter::~CReporterLzoWriter()
+{
+    Q_D(CReporterLzoWriter);
+
+    if (d->opened) {
+        d->setError("Stream was not finished");
+    }
+}
+
+bool CReporterLzoWriter::open()
+{
+    Q_D(CReporterLzoWriter);
+
+    d->error.clear();
+    d->pending.clear();
+
+    if (lzo_init() != LZO_E_OK) {
+        return d->setError("Initializing LZO library failed");
+    }
+
+    if (!d->file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return d->setError(d->file.errorString());
+    }
+    d->originalSize = d->file.size();
+    d->opened = true;
+
+    QByteArray header;
+    putU16(&header, LzopVersion);
+    putU16(&header, lzo_version() & 0xffff);
+    putU16(&header, VersionNeeded);
+    putU8(&header, MethodLzo1x1);
+    putU8(&header, Level);
+    putU32(&header, AdlerDecompressed | AdlerCompressed | OsUnix);
+    putU32(&header, RegularFileMode);
+    putU32(&header, QDateTime::currentMSecsSinceEpoch() / 1000);
+    putU32(&header, 0);
+    // No file name, as with compressing from stdin.
+    putU8(&header, 0);
+    putU32(&header, adler32(header.constData(), header.size()));
+
+    return d->writeRaw(QByteArray::fromRawData(LzopMagic, sizeof(LzopMagic)))
+            && d->writeRaw(header);
+}
+
+bool CReporterLzoWriter::write(const QByteArray &data)
+{
+    Q_D(CReporterLzoWriter);
+
+    if (!d->opened) {
+        return false;
+    }
+
+    int offset = 0;
+    if (!d->pending.isEmpty()) {
+        offset = qMin(BlockSize - d->pending.size(), data.size());
+        d->pending.append(data.constData(), offset);
+        if (d->pending.size() < BlockSize) {
+            return true;
+        }
+        if (!d->writeBlock(d->pending.constData(), d->pending.size())) {
+            return false;
+        }
+        d->pending.clear();
+    }
+
+    // Full blocks are compressed straight from the caller's data.
+    for (; data.size() - offset >= BlockSize; offset += BlockSize) {
+        if (!d->writeBlock(data.constData() + offset, BlockSize)) {
+            return false;
+        }
+    }
+
+    d->pending.append(data.constData() + offset, data.size() - offset);
+    return true;
+}
+
+void CReporterLzoWriter::setStored(bool stored)
+{
+    Q_D(CReporterLzoWriter);
+
+    d->stored = stored;
+}
+
+bool CReporterLzoWriter::finish()
+{
+    Q_D(CReporterLzoWriter);
+
+    if (!d->opened) {
+        return false;
+    }
+
+    if (!d->pending.isEmpty() && !d->writeBlock(d->pending.constData(), d->pending.size())) {
+        return false;
+    }
+    d->pending.clear();
+
+    QByteArray end;
+    putU32(&end, 0);
+    if (!d->writeRaw(end)) {
+        return false;
+    }
+
+    if (!d->file.flush()) {
+        return d->setError(d->file.errorString());
+    }
+    if (fsync(d->file.handle()) != 0) {
+        return d->setError(QString("fsync() failed: %1").arg(strerror(errno)));
+    }
+
+    d->file.close();
+    d->opened = false;
+    return true;
+}
+
+QString CReporterLzoWriter::errorString() const
+{
+    Q_D(const CReporterLzoWriter);
+
+    return d->error;
+}
+
+bool CReporterLzoWriter::append(const QByteArray &data, const QString &filePath)
+{
+    CReporterLzoWriter writer(filePath);
+    return writer.open() && writer.write(data) && writer.finish();
+}
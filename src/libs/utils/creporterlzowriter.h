@@ -0,0 +1,94 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOWRITER_H
+#define CREPORTERLZOWRITER_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterLzoWriterPrivate;
+
+/*!
+ * @class CReporterLzoWriter
+ * @brief Appends an lzop compatible stream to a file.
+ *
+ * Data is compressed with liblzo2 in blocks of the same size lzop uses, so
+ * the result can be read with lzop -d and CReporterRichCoreReader. A rich
+ * core already in the file is left untouched: the new stream is added after
+ * it, like with lzop -c >> file.
+ */
+class CREPORTER_EXPORT CReporterLzoWriter
+{
+public:
+    explicit CReporterLzoWriter(const QString &filePath);
+    ~CReporterLzoWriter();
+
+    /*!
+     * @brief Opens the file for appending and writes the stream header.
+     *
+     * The file is created if it doesn't exist.
+     */
+    bool open();
+
+    /*!
+     * @brief Compresses @a data into the stream.
+     *
+     * Data is buffered until a full block is collected or finish() is called.
+     */
+    bool write(const QByteArray &data);
+
+    /*!
+     * @brief Stores blocks written from now on without compressing them.
+     *
+     * Meant for data that is already compressed, which LZO would only spend
+     * CPU time on. The stream stays readable by lzop.
+     */
+    void setStored(bool stored);
+
+    /*!
+     * @brief Writes pending data and the end of stream marker, and syncs the
+     * file to disk.
+     *
+     * On failure the file is truncated back to its size before open().
+     */
+    bool finish();
+
+    /*!
+     * @brief Returns description of the last error.
+     */
+    QString errorString() const;
+
+    /*!
+     * @brief Convenience function compressing @a data as a new stream at the
+     * end of @a filePath.
+     */
+    static bool append(const QByteArray &data, const QString &filePath);
+
+private:
+    Q_DISABLE_COPY(CReporterLzoWriter)
+    Q_DECLARE_PRIVATE(CReporterLzoWriter)
+    QScopedPointer<CReporterLzoWriterPrivate> d_ptr;
+};
+
+#endif // CREPORTERLZOWRITER_H
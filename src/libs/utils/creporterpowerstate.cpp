@@ -0,0 +1,295 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDBusConnection>
+#include <QDBusInterface>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+
+#include <mce/dbus-names.h>
+#include <mce/mode-names.h>
+
+#include "creporterpowerstate.h"
+#include "creporterprivacysettingsmodel.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+QDBusConnection mceBus()
+{
+#ifndef CREPORTER_UNIT_TEST
+    return QDBusConnection::systemBus();
+#else
+    // Tests provide MCE on the session bus.
+    return QDBusConnection::sessionBus();
+#endif
+}
+} // namespace
+
+class CReporterPowerStatePrivate
+{
+public:
+    CReporterPowerStatePrivate(CReporterPowerState *q);
+    ~CReporterPowerStatePrivate();
+
+    QDBusPendingCallWatcher *query(const char *method);
+    //! @arg Drops the pending query, a value from a signal is more recent.
+    void cancelQuery(QDBusPendingCallWatcher **call);
+    void handleReply(QDBusPendingCallWatcher *watcher);
+    //! @arg Blocks until the pending queries have been answered.
+    void waitForQueries();
+    bool evaluate() const;
+
+    void update();
+    void onQueryFinished(QDBusPendingCallWatcher *watcher);
+    void onBatteryStatusChanged(const QString &status);
+    void onBatteryLevelChanged(int level);
+    void onChargerStateChanged(const QString &state);
+
+    //! @arg Empty until known.
+    QString batteryStatus;
+    //! @arg Negative until known.
+    int batteryLevel;
+    //! @arg Empty until known.
+    QString chargerState;
+
+    QDBusPendingCallWatcher *batteryStatusCall;
+    QDBusPendingCallWatcher *batteryLevelCall;
+    QDBusPendingCallWatcher *chargerStateCall;
+
+    //! @arg Result of the latest evaluation, to detect changes.
+    bool savePower;
+
+    Q_DECLARE_PUBLIC(CReporterPowerState)
+    CReporterPowerState *q_ptr;
+};
+
+CReporterPowerStatePrivate::CReporterPowerStatePrivate(CReporterPowerState *q)
+    : batteryLevel(-1), batteryStatusCall(0), batteryLevelCall(0), chargerStateCall(0),
+      savePower(false), q_ptr(q)
+{
+}
+
+CReporterPowerStatePrivate::~CReporterPowerStatePrivate()
+{
+    delete batteryStatusCall;
+    delete batteryLevelCall;
+    delete chargerStateCall;
+}
+
+QDBusPendingCallWatcher *CReporterPowerStatePrivate::query(const char *method)
+{
+    Q_Q(CReporterPowerState);
+
+    QDBusMessage message = QDBusMessage::createMethodCall(QLatin1String(MCE_SERVICE),
+                                                          QLatin1String(MCE_REQUEST_PATH),
+                                                          QLatin1String(MCE_REQUEST_IF),
+                                                          QLatin1String(method));
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(mceBus().asyncCall(message));
+    QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher *)),
+                     q, SLOT(onQueryFinished(QDBusPendingCallWatcher *)));
+    return watcher;
+}
+
+void CReporterPowerStatePrivate::cancelQuery(QDBusPendingCallWatcher **call)
+{
+    if (*call) {
+        (*call)->disconnect();
+        (*call)->deleteLater();
+        *call = 0;
+    }
+}
+
+void CReporterPowerStatePrivate::handleReply(QDBusPendingCallWatcher *watcher)
+{
+    if (watcher == batteryStatusCall) {
+        QDBusPendingReply<QString> reply = *watcher;
+        if (reply.isValid()) {
+            batteryStatus = reply.value();
+        } else {
+            qCWarning(cr) << "Failed to query battery status" << reply.error().message();
+        }
+        cancelQuery(&batteryStatusCall);
+    } else if (watcher == batteryLevelCall) {
+        QDBusPendingReply<int> reply = *watcher;
+        if (reply.isValid()) {
+            batteryLevel = reply.value();
+        } else {
+            qCWarning(cr) << "Failed to query battery level" << reply.error().message();
+        }
+        cancelQuery(&batteryLevelCall);
+    } else if (watcher == chargerStateCall) {
+        QDBusPendingReply<QString> reply = *watcher;
+        if (reply.isValid()) {
+            chargerState = reply.value();
+        } else {
+            qCWarning(cr) << "Failed to query charger state" << reply.error().message();
+        }
+        cancelQuery(&chargerStateCall);
+    }
+}
+
+void CReporterPowerStatePrivate::waitForQueries()
+{
+    QDBusPendingCallWatcher *calls[] = { batteryStatusCall, batteryLevelCall, chargerStateCall };
+
+    for (size_t i = 0; i < sizeof(calls) / sizeof(calls[0]); ++i) {
+        if (calls[i]) {
+            calls[i]->waitForFinished();
+            handleReply(calls[i]);
+        }
+    }
+
+    update();
+}
+
+bool CReporterPowerStatePrivate::evaluate() const
+{
+    if (batteryStatus.isEmpty() || batteryLevel < 0 || chargerState.isEmpty()) {
+        // Don't restrict anything if the state isn't known.
+        return false;
+    }
+
+    CReporterPrivacySettingsModel *settings = CReporterPrivacySettingsModel::instance();
+
+    if (batteryStatus == QLatin1String(MCE_BATTERY_STATUS_UNKNOWN)
+            || batteryStatus == QLatin1String(MCE_BATTERY_STATUS_FULL)) {
+        return false;
+    } else if (chargerState != QLatin1String(MCE_CHARGER_STATE_OFF)) {
+        return settings->restrictWhenLowBattery()
+            && batteryStatus != QLatin1String(MCE_BATTERY_STATUS_OK);
+    } else {
+        return settings->restrictWhenDischarging()
+            && batteryLevel < settings->dischargingThreshold();
+    }
+}
+
+void CReporterPowerStatePrivate::update()
+{
+    Q_Q(CReporterPowerState);
+
+    bool saved = savePower;
+    savePower = evaluate();
+
+    if (savePower != saved) {
+        qCDebug(cr) << "Battery status:" << batteryStatus
+                    << "level:" << batteryLevel
+                    << "charger-state:" << chargerState
+                    << "save power:" << savePower;
+        if (!savePower) {
+            emit q->restrictionLifted();
+        }
+    }
+}
+
+void CReporterPowerStatePrivate::onQueryFinished(QDBusPendingCallWatcher *watcher)
+{
+    handleReply(watcher);
+    update();
+}
+
+void CReporterPowerStatePrivate::onBatteryStatusChanged(const QString &status)
+{
+    cancelQuery(&batteryStatusCall);
+    batteryStatus = status;
+    update();
+}
+
+void CReporterPowerStatePrivate::onBatteryLevelChanged(int level)
+{
+    cancelQuery(&batteryLevelCall);
+    batteryLevel = level;
+    update();
+}
+
+void CReporterPowerStatePrivate::onChargerStateChanged(const QString &state)
+{
+    cancelQuery(&chargerStateCall);
+    chargerState = state;
+    update();
+}
+
+CReporterPowerState *CReporterPowerState::sm_Instance = 0;
+
+CReporterPowerState *CReporterPowerState::instance()
+{
+    if (sm_Instance == 0) {
+        sm_Instance = new CReporterPowerState();
+    }
+    return sm_Instance;
+}
+
+void CReporterPowerState::freeSingleton()
+{
+    if (sm_Instance != 0) {
+        delete sm_Instance;
+        sm_Instance = 0;
+    }
+}
+
+CReporterPowerState::CReporterPowerState()
+    : d_ptr(new CReporterPowerStatePrivate(this))
+{
+    Q_D(CReporterPowerState);
+
+    QDBusConnection bus = mceBus();
+    const QString service(QLatin1String(MCE_SERVICE));
+    const QString path(QLatin1String(MCE_SIGNAL_PATH));
+    const QString interface(QLatin1String(MCE_SIGNAL_IF));
+
+    // Subscribe before querying so that no change can be missed.
+    bus.connect(service, path, interface, QLatin1String(MCE_BATTERY_STATUS_SIG),
+                this, SLOT(onBatteryStatusChanged(QString)));
+    bus.connect(service, path, interface, QLatin1String(MCE_BATTERY_LEVEL_SIG),
+                this, SLOT(onBatteryLevelChanged(int)));
+    bus.connect(service, path, interface, QLatin1String(MCE_CHARGER_STATE_SIG),
+                this, SLOT(onChargerStateChanged(QString)));
+
+    d->batteryStatusCall = d->query(MCE_BATTERY_STATUS_GET);
+    d->batteryLevelCall = d->query(MCE_BATTERY_LEVEL_GET);
+    d->chargerStateCall = d->query(MCE_CHARGER_STATE_GET);
+
+    CReporterPrivacySettingsModel *settings = CReporterPrivacySettingsModel::instance();
+    connect(settings, SIGNAL(restrictWhenLowBatteryChanged()), this, SLOT(update()));
+    connect(settings, SIGNAL(restrictWhenDischargingChanged()), this, SLOT(update()));
+    connect(settings, SIGNAL(dischargingThresholdChanged()), this, SLOT(update()));
+}
+
+CReporterPowerState::~CReporterPowerState()
+{
+}
+
+bool CReporterPowerState::shouldSavePower()
+{
+    Q_D(CReporterPowerState);
+
+    if (d->batteryStatusCall || d->batteryLevelCall || d->chargerStateCall) {
+        d->waitForQueries();
+    }
+
+    /* Settings are cheap to read, and a change made by another process may
+     * not have been delivered yet. */
+    return d->evaluate();
+}
+
+#include "moc_creporterpowerstate.cpp"
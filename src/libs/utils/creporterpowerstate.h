@@ -0,0 +1,90 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERPOWERSTATE_H
+#define CREPORTERPOWERSTATE_H
+
+#include <QObject>
+
+#include "creporterexport.h"
+
+class CReporterPowerStatePrivate;
+class QDBusPendingCallWatcher;
+
+/*!
+ * @class CReporterPowerState
+ * @brief Cached battery and charger state from MCE.
+ *
+ * The state is queried once asynchronously and then kept up to date from
+ * MCE change signals, so that shouldSavePower() can be answered without
+ * D-Bus round trips.
+ */
+class CREPORTER_EXPORT CReporterPowerState : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates a new instance of this class if it doesn't exist and returns it.
+     *
+     * @return Class instance.
+     */
+    static CReporterPowerState *instance();
+
+    /*!
+     * @brief Frees the class instance.
+     */
+    static void freeSingleton();
+
+    /*!
+     * @brief Determines whether running power-intensive tasks is appropriate.
+     *
+     * Waits for the initial state from MCE if it hasn't been received yet.
+     *
+     * @return @c true if not.
+     */
+    bool shouldSavePower();
+
+Q_SIGNALS:
+    /*!
+     * @brief Sent when power no longer needs to be saved.
+     *
+     * Work that was deferred because of shouldSavePower() may be resumed.
+     */
+    void restrictionLifted();
+
+private:
+    CReporterPowerState();
+    ~CReporterPowerState();
+
+    Q_DISABLE_COPY(CReporterPowerState)
+    Q_DECLARE_PRIVATE(CReporterPowerState)
+    QScopedPointer<CReporterPowerStatePrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void update())
+    Q_PRIVATE_SLOT(d_func(), void onQueryFinished(QDBusPendingCallWatcher *))
+    Q_PRIVATE_SLOT(d_func(), void onBatteryStatusChanged(const QString &))
+    Q_PRIVATE_SLOT(d_func(), void onBatteryLevelChanged(int))
+    Q_PRIVATE_SLOT(d_func(), void onChargerStateChanged(const QString &))
+
+    static CReporterPowerState *sm_Instance;
+};
+
+#endif // CREPORTERPOWERSTATE_H
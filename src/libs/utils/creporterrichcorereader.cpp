@@ -0,0 +1,211 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+
+#include "creporterlzoreader.h"
+#include "creporterrichcorereader.h"
+
+namespace {
+const int PlainChunkSize = 64 * 1024;
+// Header names are short, anything longer is not a header.
+const int MaxHeaderSize = 4096;
+
+const QByteArray SectionStart("\n[---rich-core: ");
+const QByteArray SectionEnd("---]\n");
+const QString CoreDumpSection("coredump");
+} // namespace
+
+class CReporterRichCoreReaderPrivate
+{
+public:
+    CReporterRichCoreReaderPrivate();
+
+    bool fill();
+    bool setError(const QString &message);
+
+    //! @arg Decoder of .rcore.lzo files, null for plain .rcore files.
+    QScopedPointer<CReporterLzoReader> lzo;
+    QFile file;
+    //! @arg Decoded data not consumed yet starts at position.
+    QByteArray buffer;
+    int position;
+    bool atEnd;
+    QString section;
+    QString error;
+};
+
+CReporterRichCoreReaderPrivate::CReporterRichCoreReaderPrivate()
+    : position(0), atEnd(false)
+{
+}
+
+bool CReporterRichCoreReaderPrivate::setError(const QString &message)
+{
+    error = message;
+    atEnd = true;
+    return false;
+}
+
+bool CReporterRichCoreReaderPrivate::fill()
+{
+    if (atEnd) {
+        return false;
+    }
+
+    // Drop what has been consumed before making room for more.
+    buffer.remove(0, position);
+    position = 0;
+
+    if (lzo) {
+        if (!lzo->readBlock(&buffer)) {
+            atEnd = true;
+            error = lzo->errorString();
+            return false;
+        }
+        return true;
+    }
+
+    QByteArray chunk(file.read(PlainChunkSize));
+    if (chunk.isEmpty()) {
+        atEnd = true;
+        return false;
+    }
+    buffer.append(chunk);
+    return true;
+}
+
+CReporterRichCoreReader::CReporterRichCoreReader(const QString &filePath)
+    : d_ptr(new CReporterRichCoreReaderPrivate)
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (filePath.endsWith(QLatin1String(".lzo"))) {
+        d->lzo.reset(new CReporterLzoReader(filePath));
+    } else {
+        d->file.setFileName(filePath);
+    }
+}
+
+CReporterRichCoreReader::~CReporterRichCoreReader()
+{
+}
+
+bool CReporterRichCoreReader::open()
+{
+    Q_D(CReporterRichCoreReader);
+
+    // Headers are searched for after a line break.
+    d->buffer = "\n";
+
+    if (d->lzo) {
+        return d->lzo->open() || d->setError(d->lzo->errorString());
+    }
+
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        return d->setError(d->file.errorString());
+    }
+
+    return true;
+}
+
+bool CReporterRichCoreReader::nextSection()
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (d->section == CoreDumpSection) {
+        return false;
+    }
+
+    forever {
+        int start = d->buffer.indexOf(SectionStart, d->position);
+        if (start == -1) {
+            // Keep the tail, it may hold beginning of a header.
+            d->position = qMax(d->position, d->buffer.size() - SectionStart.size() + 1);
+        } else {
+            int nameStart = start + SectionStart.size();
+            int end = d->buffer.indexOf(SectionEnd, nameStart);
+            if (end != -1 && end - nameStart < MaxHeaderSize) {
+                d->section = QString::fromUtf8(d->buffer.constData() + nameStart, end - nameStart);
+                d->position = end + SectionEnd.size();
+                return d->section != CoreDumpSection;
+            }
+            if (end != -1 || d->buffer.size() - nameStart >= MaxHeaderSize + SectionEnd.size()) {
+                // Not a header after all.
+                d->position = start + 1;
+                continue;
+            }
+            d->position = start;
+        }
+
+        if (!d->fill()) {
+            d->section.clear();
+            return false;
+        }
+    }
+}
+
+QString CReporterRichCoreReader::sectionName() const
+{
+    Q_D(const CReporterRichCoreReader);
+
+    return d->section;
+}
+
+QByteArray CReporterRichCoreReader::readSection(int maxSize)
+{
+    Q_D(CReporterRichCoreReader);
+
+    QByteArray result;
+    if (d->section.isEmpty() || d->section == CoreDumpSection) {
+        return result;
+    }
+
+    forever {
+        int next = d->buffer.indexOf(SectionStart, d->position);
+        int end = next != -1 ? next : d->buffer.size() - SectionStart.size() + 1;
+        if (end > d->position) {
+            int length = qMin(end - d->position, maxSize - result.size());
+            result.append(d->buffer.constData() + d->position, length);
+            d->position += length;
+        }
+
+        if (next != -1 || result.size() >= maxSize) {
+            break;
+        }
+
+        if (!d->fill()) {
+            // End of file, the tail belongs to this section.
+            int length = qMin(d->buffer.size() - d->position, maxSize - result.size());
+            result.append(d->buffer.constData() + d->position, length);
+            d->position += length;
+            break;
+        }
+    }
+
+    return result;
+}
+
+QString CReporterRichCoreReader::errorString() const
+{
+    Q_D(const CReporterRichCoreReader);
+
+    return d->error;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERRICHCOREREADER_H
+#define CREPORTERRICHCOREREADER_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterRichCoreReaderPrivate;
+
+/*!
+ * @class CReporterRichCoreReader
+ * @brief Sequential reader for sections of a rich core report.
+ *
+ * Rich cores consist of sections that begin with a
+ * [---rich-core: name---] header line. The reader decompresses
+ * .rcore.lzo files block by block as sections are requested, so only the
+ * part of the file up to the last requested section is ever decoded.
+ * Reading ends at the core dump section, which is always the last one and
+ * makes up most of the file. Plain .rcore files are read as they are.
+ */
+class CREPORTER_EXPORT CReporterRichCoreReader
+{
+public:
+    explicit CReporterRichCoreReader(const QString &filePath);
+    ~CReporterRichCoreReader();
+
+    /*!
+     * @brief Opens the file and reads the lzop header.
+     *
+     * @return true on success; otherwise false and errorString() tells why.
+     */
+    bool open();
+
+    /*!
+     * @brief Skips to the header of the next section.
+     *
+     * @return false at the end of the file, at the core dump section or on
+     * error.
+     */
+    bool nextSection();
+
+    /*!
+     * @brief Returns name of the current section.
+     */
+    QString sectionName() const;
+
+    /*!
+     * @brief Reads contents of the current section.
+     *
+     * @param maxSize Maximum number of bytes returned. The rest of the
+     * section is skipped by the following nextSection().
+     */
+    QByteArray readSection(int maxSize = 1024 * 1024);
+
+    /*!
+     * @brief Returns description of the last error, or empty string.
+     */
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CReporterRichCoreReader)
+    Q_DECLARE_PRIVATE(CReporterRichCoreReader)
+    QScopedPointer<CReporterRichCoreReaderPrivate> d_ptr;
+};
+
+#endif // CREPORTERRICHCOREREADER_H
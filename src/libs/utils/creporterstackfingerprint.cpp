@@ -0,0 +1,218 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QSet>
+
+#include "creporterrichcorereader.h"
+#include "creporterstackfingerprint.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+// Larger traces are cut, the top frames are at the beginning anyway.
+const int MaxStackTraceSize = 256 * 1024;
+
+const QString UnknownFunction("??");
+const QString SignalHandlerFrame("<signal handler called>");
+
+/* Frames of the C library and Qt that only deliver the signal. They are
+ * the same for every abort, so they would hide the actual crash site. */
+bool isSignalingFrame(const QString &function)
+{
+    static const QSet<QString> functions = QSet<QString>()
+        << "raise" << "__GI_raise" << "abort" << "__GI_abort"
+        << "pthread_kill" << "__pthread_kill" << "__pthread_kill_implementation"
+        << "__pthread_kill_internal" << "__libc_message" << "__fortify_fail"
+        << "__chk_fail" << "__stack_chk_fail" << "malloc_printerr"
+        << "__malloc_assert" << "__assert_fail" << "__assert_fail_base"
+        << "__GI___assert_fail" << "qt_message_fatal" << "qFatal"
+        << "QMessageLogger::fatal" << "qt_assert" << "qt_assert_x";
+
+    return functions.contains(function);
+}
+
+/*
+ * Reduces a frame line, without the #N prefix, to the function name. gdb
+ * prints "0xADDR in function (args) at file:line" or "... from library",
+ * eu-stack "0xADDR function - library".
+ */
+QString normalizeFrame(QString frame)
+{
+    QString library;
+
+    if (frame.startsWith(QLatin1String("0x"))) {
+        int space = frame.indexOf(' ');
+        frame = space == -1 ? QString() : frame.mid(space + 1).trimmed();
+        if (frame.startsWith(QLatin1String("in "))) {
+            frame.remove(0, 3);
+        }
+    }
+
+    int index = frame.lastIndexOf(QLatin1String(" from "));
+    if (index != -1) {
+        library = frame.mid(index + 6).trimmed();
+        frame.truncate(index);
+    } else if (!frame.contains(QLatin1String(" ("))) {
+        // Only eu-stack uses the dash and it doesn't print arguments.
+        index = frame.lastIndexOf(QLatin1String(" - "));
+        if (index != -1) {
+            library = frame.mid(index + 3).trimmed();
+            frame.truncate(index);
+        }
+    }
+
+    index = frame.lastIndexOf(QLatin1String(" at "));
+    if (index != -1) {
+        frame.truncate(index);
+    }
+
+    index = frame.indexOf(QLatin1String(" ("));
+    if (index != -1) {
+        frame.truncate(index);
+    }
+
+    frame = frame.trimmed();
+    if (frame.isEmpty() || frame == UnknownFunction) {
+        // Library load addresses vary, its name is all there is to go by.
+        frame = UnknownFunction;
+        if (!library.isEmpty()) {
+            frame += '@' + library.mid(library.lastIndexOf('/') + 1);
+        }
+    }
+
+    return frame;
+}
+} // namespace
+
+QStringList CReporterStackFingerprint::frames(const QByteArray &stackTrace, int maxFrames)
+{
+    QStringList lines(QString::fromUtf8(stackTrace).split('\n'));
+
+    /* gdb lists threads of a core dump in descending order and the thread
+     * that received the signal is thread 1. Without thread headers the
+     * first listed thread is used. */
+    int first = 0;
+    for (int i = 0; i < lines.count(); ++i) {
+        if (lines.at(i).startsWith(QLatin1String("Thread 1 "))) {
+            first = i + 1;
+            break;
+        }
+    }
+
+    QStringList result;
+    bool inThread = false;
+    int previousNumber = -1;
+
+    for (int i = first; i < lines.count() && result.count() < maxFrames; ++i) {
+        const QString &raw = lines.at(i);
+        QString line(raw.trimmed());
+
+        if (!line.startsWith('#')) {
+            // A blank line or another thread header ends the thread.
+            if (inThread && (line.isEmpty() || !raw.at(0).isSpace())) {
+                break;
+            }
+            continue;
+        }
+
+        int space = line.indexOf(' ');
+        bool ok;
+        int number = line.mid(1, space - 1).toInt(&ok);
+        if (space == -1 || !ok) {
+            continue;
+        }
+        if (number <= previousNumber) {
+            // Numbering restarts with the next thread.
+            break;
+        }
+        previousNumber = number;
+        inThread = true;
+
+        QString function(normalizeFrame(line.mid(space + 1).trimmed()));
+        if (function == SignalHandlerFrame) {
+            // Anything above is the application's own crash handler.
+            result.clear();
+        } else if (result.isEmpty() && isSignalingFrame(function)) {
+            continue;
+        } else {
+            result << function;
+        }
+    }
+
+    return result;
+}
+
+QByteArray CReporterStackFingerprint::fromStackTrace(const QByteArray &stackTrace, int maxFrames,
+                                                     bool *symbolized)
+{
+    QStringList top(frames(stackTrace, maxFrames));
+
+    if (symbolized) {
+        *symbolized = !top.isEmpty();
+        foreach (const QString &function, top) {
+            if (function.startsWith(UnknownFunction)) {
+                *symbolized = false;
+                break;
+            }
+        }
+    }
+
+    if (top.isEmpty()) {
+        return QByteArray();
+    }
+
+    return QCryptographicHash::hash(top.join('\n').toUtf8(), QCryptographicHash::Sha1);
+}
+
+QByteArray CReporterStackFingerprint::fromFile(const QString &filePath, int maxFrames,
+                                               bool *symbolized)
+{
+    CReporterRichCoreReader reader(filePath);
+
+    if (symbolized) {
+        *symbolized = false;
+    }
+
+    if (reader.open()) {
+        while (reader.nextSection()) {
+            if (isStackTraceSection(reader.sectionName())) {
+                return fromStackTrace(reader.readSection(MaxStackTraceSize), maxFrames,
+                                      symbolized);
+            }
+        }
+    }
+
+    if (!reader.errorString().isEmpty()) {
+        qCWarning(cr) << "Can't read" << filePath << ":" << reader.errorString();
+    }
+
+    return QByteArray();
+}
+
+bool CReporterStackFingerprint::isStackTraceSection(const QString &sectionName)
+{
+    // Kernel stacks are collected from /proc, those don't identify crashes.
+    return !sectionName.startsWith('/')
+            && (sectionName.contains(QLatin1String("stack"), Qt::CaseInsensitive)
+                || sectionName.contains(QLatin1String("backtrace"), Qt::CaseInsensitive));
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSTACKFINGERPRINT_H
+#define CREPORTERSTACKFINGERPRINT_H
+
+#include <QByteArray>
+#include <QStringList>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterStackFingerprint
+ * @brief Identifies crashes by the top frames of their stack trace.
+ *
+ * Frames are normalized so that the fingerprint stays the same across
+ * processes and builds of the same code: addresses, arguments and source
+ * lines are dropped, unresolved frames are named by their library, and the
+ * abort()/raise() frames leading to the signal are skipped.
+ */
+class CREPORTER_EXPORT CReporterStackFingerprint
+{
+public:
+    //! Number of frames included in the fingerprint by default.
+    static const int DefaultFrameCount = 5;
+
+    /*!
+     * @brief Returns normalized top frames of the crashed thread.
+     *
+     * @param stackTrace gdb or eu-stack style stack trace of all threads.
+     * @param maxFrames Maximum number of frames returned.
+     */
+    static QStringList frames(const QByteArray &stackTrace,
+                              int maxFrames = DefaultFrameCount);
+
+    /*!
+     * @brief Returns fingerprint of a stack trace.
+     *
+     * @param symbolized If given, set to true if all the frames in the
+     * fingerprint have function names. Unresolved frames are only named by
+     * their library and are alike across applications.
+     * @return SHA-1 of the normalized frames, or empty array if the trace
+     * has no frames.
+     */
+    static QByteArray fromStackTrace(const QByteArray &stackTrace,
+                                     int maxFrames = DefaultFrameCount,
+                                     bool *symbolized = 0);
+
+    /*!
+     * @brief Returns fingerprint of the stack trace in a rich core.
+     *
+     * Only the sections preceding the stack trace are decompressed.
+     *
+     * @param symbolized See fromStackTrace().
+     * @return Fingerprint, or empty array if the file has no stack trace.
+     */
+    static QByteArray fromFile(const QString &filePath,
+                               int maxFrames = DefaultFrameCount,
+                               bool *symbolized = 0);
+
+    /*!
+     * @brief Returns true if @a sectionName is a stack trace section.
+     */
+    static bool isStackTraceSection(const QString &sectionName);
+};
+
+#endif // CREPORTERSTACKFINGERPRINT_H
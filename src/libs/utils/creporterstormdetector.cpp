@@ -0,0 +1,230 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDateTime>
+#include <QDebug>
+#include <QHash>
+#include <QTimer>
+
+#include "creporterstormdetector.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+/* A service restarted by systemd after each crash exceeds the source
+ * limit within a minute, while separate crashes of a few applications
+ * stay below both limits. */
+const int DefaultSourceBurst = 3;
+const int DefaultSourceRate = 1;
+const int DefaultGlobalBurst = 10;
+const int DefaultGlobalRate = 6;
+const int DefaultQuietPeriod = 2 * 60 * 1000;
+
+// Buckets of sources seen once in a while are dropped above this.
+const int MaxSources = 64;
+
+const qint64 Minute = 60 * 1000;
+/* Tokens are counted in fractions, so that whole rates per minute refill
+ * exactly on every millisecond. */
+const qint64 Token = Minute;
+
+struct Limit {
+    int burst;
+    int perMinute;
+};
+
+struct Bucket {
+    Bucket() : tokens(-1), updated(0) {}
+
+    qint64 tokens;
+    qint64 updated;
+};
+
+qint64 currentTime(qint64 time)
+{
+    return time < 0 ? QDateTime::currentMSecsSinceEpoch() : time;
+}
+
+//! Adds tokens for the time passed. Returns true if the bucket is full.
+bool refill(Bucket *bucket, const Limit &limit, qint64 time)
+{
+    qint64 capacity = limit.burst * Token;
+
+    if (bucket->tokens < 0) {
+        bucket->tokens = capacity;
+    } else if (time > bucket->updated) {
+        qint64 added = (time - bucket->updated) * limit.perMinute * Token / Minute;
+        bucket->tokens = qMin(capacity, bucket->tokens + added);
+    }
+    // If the clock was turned back, refilling waits until it catches up.
+    bucket->updated = qMax(bucket->updated, time);
+
+    return bucket->tokens == capacity;
+}
+} // namespace
+
+class CReporterStormDetectorPrivate
+{
+public:
+    CReporterStormDetectorPrivate();
+
+    void dropIdleSources(qint64 time);
+    void endStorm();
+
+    Limit sourceLimit;
+    Limit globalLimit;
+    QHash<QString, Bucket> sources;
+    Bucket global;
+    QMap<QString, int> suppressed;
+    qint64 firstSuppressed;
+    qint64 lastSuppressed;
+    QTimer quietTimer;
+
+    Q_DECLARE_PUBLIC(CReporterStormDetector)
+    CReporterStormDetector *q_ptr;
+};
+
+CReporterStormDetectorPrivate::CReporterStormDetectorPrivate()
+    : firstSuppressed(0), lastSuppressed(0), q_ptr(0)
+{
+    sourceLimit.burst = DefaultSourceBurst;
+    sourceLimit.perMinute = DefaultSourceRate;
+    globalLimit.burst = DefaultGlobalBurst;
+    globalLimit.perMinute = DefaultGlobalRate;
+
+    quietTimer.setSingleShot(true);
+    quietTimer.setInterval(DefaultQuietPeriod);
+}
+
+void CReporterStormDetectorPrivate::dropIdleSources(qint64 time)
+{
+    // A full bucket behaves the same as a new one.
+    QHash<QString, Bucket>::iterator it = sources.begin();
+    while (it != sources.end()) {
+        if (refill(&it.value(), sourceLimit, time)) {
+            it = sources.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CReporterStormDetectorPrivate::endStorm()
+{
+    Q_Q(CReporterStormDetector);
+
+    QMap<QString, int> events;
+    events.swap(suppressed);
+
+    qCDebug(cr) << "Event storm is over, suppressed" << events;
+    emit q->stormEnded(events, lastSuppressed - firstSuppressed);
+}
+
+CReporterStormDetector::CReporterStormDetector(QObject *parent)
+    : QObject(parent), d_ptr(new CReporterStormDetectorPrivate)
+{
+    Q_D(CReporterStormDetector);
+
+    d->q_ptr = this;
+    connect(&d->quietTimer, SIGNAL(timeout()), this, SLOT(endStorm()));
+}
+
+CReporterStormDetector::~CReporterStormDetector()
+{
+}
+
+void CReporterStormDetector::setSourceLimit(int burst, int perMinute)
+{
+    Q_D(CReporterStormDetector);
+
+    d->sourceLimit.burst = qMax(1, burst);
+    d->sourceLimit.perMinute = qMax(0, perMinute);
+    d->sources.clear();
+}
+
+void CReporterStormDetector::setGlobalLimit(int burst, int perMinute)
+{
+    Q_D(CReporterStormDetector);
+
+    d->globalLimit.burst = qMax(1, burst);
+    d->globalLimit.perMinute = qMax(0, perMinute);
+    d->global = Bucket();
+}
+
+void CReporterStormDetector::setQuietPeriod(int msecs)
+{
+    Q_D(CReporterStormDetector);
+
+    d->quietTimer.setInterval(msecs);
+}
+
+bool CReporterStormDetector::admit(const QString &source, qint64 time)
+{
+    Q_D(CReporterStormDetector);
+
+    time = currentTime(time);
+
+    bool globalAvailable = d->globalLimit.perMinute == 0;
+    if (!globalAvailable) {
+        refill(&d->global, d->globalLimit, time);
+        globalAvailable = d->global.tokens >= Token;
+    }
+
+    bool sourceAvailable = d->sourceLimit.perMinute == 0;
+    Bucket *bucket = 0;
+    if (!sourceAvailable) {
+        if (d->sources.count() >= MaxSources && !d->sources.contains(source)) {
+            d->dropIdleSources(time);
+        }
+        bucket = &d->sources[source];
+        refill(bucket, d->sourceLimit, time);
+        sourceAvailable = bucket->tokens >= Token;
+    }
+
+    if (globalAvailable && sourceAvailable) {
+        if (d->globalLimit.perMinute != 0) {
+            d->global.tokens -= Token;
+        }
+        if (bucket) {
+            bucket->tokens -= Token;
+        }
+        return true;
+    }
+
+    if (d->suppressed.isEmpty()) {
+        qCWarning(cr) << "Event storm detected at" << source << ", handling events cheaply.";
+        d->firstSuppressed = time;
+    }
+    d->lastSuppressed = qMax(d->lastSuppressed, time);
+    ++d->suppressed[source];
+    d->quietTimer.start();
+
+    return false;
+}
+
+bool CReporterStormDetector::inStorm() const
+{
+    Q_D(const CReporterStormDetector);
+
+    return !d->suppressed.isEmpty();
+}
+
+#include "moc_creporterstormdetector.cpp"
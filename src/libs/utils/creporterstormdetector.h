@@ -0,0 +1,102 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSTORMDETECTOR_H
+#define CREPORTERSTORMDETECTOR_H
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterStormDetectorPrivate;
+
+/*!
+ * @class CReporterStormDetector
+ * @brief Detects bursts of events, such as a service crash-looping.
+ *
+ * Each event source, e.g. a binary name, has a token bucket and all sources
+ * share a global one. An event is admitted while both buckets have tokens.
+ * Otherwise the event is only counted and the caller is expected to handle
+ * it cheaply. Once no events have been suppressed for the quiet period, the
+ * storm is over and stormEnded() summarizes what was suppressed.
+ */
+class CREPORTER_EXPORT CReporterStormDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CReporterStormDetector(QObject *parent = 0);
+    ~CReporterStormDetector();
+
+    /*!
+     * @brief Sets the limit for each event source.
+     *
+     * @param burst Number of events admitted at once.
+     * @param perMinute Rate at which the burst is refilled. 0 means no limit.
+     */
+    void setSourceLimit(int burst, int perMinute);
+
+    /*!
+     * @brief Sets the limit for all sources together.
+     *
+     * @sa setSourceLimit()
+     */
+    void setGlobalLimit(int burst, int perMinute);
+
+    /*!
+     * @brief Sets how long no events may be suppressed before the storm is
+     * considered over.
+     */
+    void setQuietPeriod(int msecs);
+
+    /*!
+     * @brief Registers an event from @a source.
+     *
+     * @param time Time of the event in ms since epoch, current time if negative.
+     * @return true if the event should be handled in full, false if it
+     * was only counted.
+     */
+    bool admit(const QString &source, qint64 time = -1);
+
+    /*!
+     * @brief Returns true while events are being suppressed.
+     */
+    bool inStorm() const;
+
+Q_SIGNALS:
+    /*!
+     * @brief Sent when the quiet period has passed after a storm.
+     *
+     * @param suppressed Number of suppressed events by source.
+     * @param duration Time from the first to the last suppressed event in ms.
+     */
+    void stormEnded(const QMap<QString, int> &suppressed, qint64 duration);
+
+private:
+    Q_DISABLE_COPY(CReporterStormDetector)
+    Q_DECLARE_PRIVATE(CReporterStormDetector)
+    QScopedPointer<CReporterStormDetectorPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void endStorm())
+};
+
+#endif // CREPORTERSTORMDETECTOR_H
@@ -0,0 +1,212 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+#include "creporternamespace.h"
+#include "creporteruploadnotifier.h"
+#include "creporterutils.h"
+#include "../autouploader_interface.h" // generated
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+// Time (ms) to collect automatic requests before sending them.
+const int CoalesceWindow = 500;
+// Number of remembered files after which removed ones are forgotten.
+const int SubmittedPruneLimit = 256;
+} // namespace
+
+class CReporterUploadNotifierPrivate
+{
+public:
+    CReporterUploadNotifierPrivate(CReporterUploadNotifier *q);
+
+    void send(const QStringList &files, bool obeyResourcesRestrictions);
+    void flush();
+    void onReply(QDBusPendingCallWatcher *watcher);
+
+    ComNokiaCrashReporterAutoUploaderInterface *proxy;
+    QTimer flushTimer;
+    //! @arg Files for automatic upload, in order of submission.
+    QStringList pending;
+    //! @arg Files to upload regardless of restrictions.
+    QStringList pendingExplicit;
+    //! @arg Whether an automatic request is due even if pending is empty.
+    bool retry;
+    //! @arg Files the auto uploader has been given for automatic upload.
+    QSet<QString> submitted;
+    //! @arg Files of each automatic request in flight.
+    QHash<QDBusPendingCallWatcher *, QStringList> inFlight;
+
+    Q_DECLARE_PUBLIC(CReporterUploadNotifier)
+    CReporterUploadNotifier *q_ptr;
+};
+
+CReporterUploadNotifierPrivate::CReporterUploadNotifierPrivate(CReporterUploadNotifier *q)
+    : proxy(0), retry(false), q_ptr(q)
+{
+    flushTimer.setSingleShot(true);
+}
+
+void CReporterUploadNotifierPrivate::send(const QStringList &files,
+                                          bool obeyResourcesRestrictions)
+{
+    Q_Q(CReporterUploadNotifier);
+
+    qCDebug(cr) << "Requesting crash-reporter-autouploader to upload"
+                << files.size() << "files.";
+
+    QDBusPendingCallWatcher *watcher =
+        new QDBusPendingCallWatcher(proxy->uploadFiles(files, obeyResourcesRestrictions), q);
+    QObject::connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher *)),
+                     q, SLOT(onReply(QDBusPendingCallWatcher *)));
+
+    if (obeyResourcesRestrictions) {
+        inFlight.insert(watcher, files);
+    }
+}
+
+void CReporterUploadNotifierPrivate::flush()
+{
+    if (!pendingExplicit.isEmpty()) {
+        send(pendingExplicit, false);
+        pendingExplicit.clear();
+    }
+
+    if (!pending.isEmpty() || retry) {
+        send(pending, true);
+        pending.clear();
+        retry = false;
+    }
+
+    if (submitted.count() > SubmittedPruneLimit) {
+        QSet<QString>::iterator it = submitted.begin();
+        while (it != submitted.end()) {
+            if (QFile::exists(*it)) {
+                ++it;
+            } else {
+                it = submitted.erase(it);
+            }
+        }
+    }
+}
+
+void CReporterUploadNotifierPrivate::onReply(QDBusPendingCallWatcher *watcher)
+{
+    QDBusPendingReply<bool> reply = *watcher;
+    QStringList files = inFlight.take(watcher);
+    watcher->deleteLater();
+
+    if (reply.isError()) {
+        qCWarning(cr) << "D-Bus error occurred:" << reply.error().name() << reply.error().message();
+        // Not journaled by the auto uploader, send them again next time.
+        foreach (const QString &file, files) {
+            submitted.remove(file);
+        }
+    }
+}
+
+CReporterUploadNotifier *CReporterUploadNotifier::sm_Instance = 0;
+
+CReporterUploadNotifier *CReporterUploadNotifier::instance()
+{
+    if (sm_Instance == 0) {
+        sm_Instance = new CReporterUploadNotifier();
+    }
+    return sm_Instance;
+}
+
+void CReporterUploadNotifier::freeSingleton()
+{
+    if (sm_Instance != 0) {
+        delete sm_Instance;
+        sm_Instance = 0;
+    }
+}
+
+CReporterUploadNotifier::CReporterUploadNotifier()
+    : d_ptr(new CReporterUploadNotifierPrivate(this))
+{
+    Q_D(CReporterUploadNotifier);
+
+    d->proxy = new ComNokiaCrashReporterAutoUploaderInterface(CReporter::AutoUploaderServiceName,
+            CReporter::AutoUploaderObjectPath, QDBusConnection::sessionBus(), this);
+    connect(&d->flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+}
+
+CReporterUploadNotifier::~CReporterUploadNotifier()
+{
+    Q_D(CReporterUploadNotifier);
+
+    // Don't lose what was asked for.
+    if (d->flushTimer.isActive()) {
+        d->flush();
+    }
+}
+
+void CReporterUploadNotifier::submit(const QStringList &files, bool obeyResourcesRestrictions)
+{
+    Q_D(CReporterUploadNotifier);
+
+    if (!obeyResourcesRestrictions) {
+        foreach (const QString &file, files) {
+            if (!d->pendingExplicit.contains(file)) {
+                d->pendingExplicit << file;
+            }
+        }
+        // The user is waiting for these.
+        d->flushTimer.start(0);
+        return;
+    }
+
+    bool added = false;
+    foreach (const QString &file, files) {
+        if (!d->submitted.contains(file)) {
+            d->submitted.insert(file);
+            d->pending << file;
+            added = true;
+        }
+    }
+
+    // Not restarted, so that a steady stream of requests is still sent out.
+    if (added && !d->flushTimer.isActive()) {
+        d->flushTimer.start(CoalesceWindow);
+    }
+}
+
+void CReporterUploadNotifier::retry()
+{
+    Q_D(CReporterUploadNotifier);
+
+    d->retry = true;
+
+    if (!d->flushTimer.isActive()) {
+        d->flushTimer.start(CoalesceWindow);
+    }
+}
+
+#include "moc_creporteruploadnotifier.cpp"
@@ -0,0 +1,93 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERUPLOADNOTIFIER_H
+#define CREPORTERUPLOADNOTIFIER_H
+
+#include <QObject>
+#include <QStringList>
+
+#include "creporterexport.h"
+
+class CReporterUploadNotifierPrivate;
+class QDBusPendingCallWatcher;
+
+/*!
+ * @class CReporterUploadNotifier
+ * @brief Passes files to the auto uploader without blocking.
+ *
+ * Requests made within a short window are sent as one D-Bus call. Files
+ * that the auto uploader has already accepted for automatic upload are not
+ * sent again, it keeps them in its journal until they are uploaded.
+ */
+class CREPORTER_EXPORT CReporterUploadNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates a new instance of this class if it doesn't exist and returns it.
+     *
+     * @return Class instance.
+     */
+    static CReporterUploadNotifier *instance();
+
+    /*!
+     * @brief Frees the class instance.
+     */
+    static void freeSingleton();
+
+    /*!
+     * @brief Queues @a files to be sent to the auto uploader.
+     *
+     * Nothing is sent if all @a files have been sent before, use retry() to
+     * have the auto uploader retry the files in its journal.
+     *
+     * @param files Files to upload.
+     * @param obeyResourcesRestrictions @c false if the files should be uploaded
+     *                                  regardless of the network connection type
+     *                                  and battery state. Such requests are sent
+     *                                  right away and always include all @a files.
+     */
+    void submit(const QStringList &files, bool obeyResourcesRestrictions = true);
+
+    /*!
+     * @brief Asks the auto uploader to retry the files in its journal.
+     *
+     * Use when a restriction that held uploads back has been lifted. The
+     * request is sent together with pending files, if any.
+     */
+    void retry();
+
+private:
+    CReporterUploadNotifier();
+    ~CReporterUploadNotifier();
+
+    Q_DISABLE_COPY(CReporterUploadNotifier)
+    Q_DECLARE_PRIVATE(CReporterUploadNotifier)
+    QScopedPointer<CReporterUploadNotifierPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void flush())
+    Q_PRIVATE_SLOT(d_func(), void onReply(QDBusPendingCallWatcher *))
+
+    static CReporterUploadNotifier *sm_Instance;
+};
+
+#endif // CREPORTERUPLOADNOTIFIER_H
@@ -28,28 +28,24 @@
 #include <sys/types.h> // for stat()
 #include <sys/stat.h>
 
-#ifndef CREPORTER_UNIT_TEST
-#include <deviceinfo.h>
-#endif
-
 #include <QDebug>
 #include <QFileInfo>
 #include <QDir>
 #include <QFile>
 #include <QProcess>
 
-#include <mce/dbus-names.h>
-#include <mce/mode-names.h>
 #include <notification.h>
 
 #include "creporterutils.h"
 
+#include "creporterlzowriter.h"
 #include "creporternamespace.h"
-#include "../autouploader_interface.h" // generated
-#include "../ssu_interface.h" // generated
+#include "creporteruploadnotifier.h"
 
 #ifndef CREPORTER_UNIT_TEST
-#include "creporterprivacysettingsmodel.h"
+#include "creporterdeviceidentity.h"
+#include "creporterpowerstate.h"
+#include "creporterstormdetector.h"
 #endif
 
 namespace CReporter {
@@ -60,7 +56,6 @@ Q_LOGGING_CATEGORY(cr, "creporter", QtInfoMsg)
 
 using CReporter::LoggingCategory::cr;
 
-const QString richCoreTmpNoteFile = "/tmp/rich-core-note.txt";
 const QString coreSuffixRcore = "rcore";
 const QString coreSuffixRcoreLzo = "rcore.lzo";
 
@@ -97,9 +92,16 @@ bool CReporterUtils::removeFile(const QString &path)
 {
     QFileInfo fi(path);
     qCDebug(cr) << "Removing file:" << fi.absoluteFilePath();
+    QFile::remove(uploadOffsetFile(fi.absoluteFilePath()));
     return QFile::remove(fi.absoluteFilePath());
 }
 
+QString CReporterUtils::uploadOffsetFile(const QString &path)
+{
+    QFileInfo fi(path);
+    return fi.absolutePath() + "/." + fi.fileName() + ".upload";
+}
+
 QStringList CReporterUtils::parseCrashInfoFromFilename(const QString &filePath)
 {
     qCDebug(cr) << "Parse:" << filePath;
@@ -153,46 +155,19 @@ QStringList CReporterUtils::parseCrashInfoFromFilename(const QString &filePath)
 
 bool CReporterUtils::appendToLzo(const QString &text, const QString &filePath)
 {
-    QFile tmpFile(richCoreTmpNoteFile);
-    // Create local temp file, where comments are written.
-    if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qCWarning(cr) << "Unable to open file:" << filePath;
+    CReporterLzoWriter writer(filePath);
+    if (!writer.open() || !writer.write(text.toUtf8()) || !writer.finish()) {
+        qCWarning(cr) << "Unable to append to" << filePath << ":" << writer.errorString();
         return false;
     }
 
-    QTextStream out(&tmpFile);
-    out << text;
-    tmpFile.close();
-
-    // Append to *.lzo.
-    QString cmd = QString("/usr/bin/lzop -c %1 >> %2").arg(richCoreTmpNoteFile).arg(filePath) ;
-    int res = system(qPrintable(cmd));
-    qCDebug(cr) << "System returned:"  << res;
-
-    // Remove temp file.
-    if (!tmpFile.remove()) {
-        qCWarning(cr) << "Unable to remove file:" << richCoreTmpNoteFile;
-    }
     return true;
 }
 
 QString CReporterUtils::deviceUid()
 {
 #ifndef CREPORTER_UNIT_TEST
-    static OrgNemoSsuInterface *ssuProxy = 0;
-    if (!ssuProxy) {
-        ssuProxy = new OrgNemoSsuInterface("org.nemo.ssu", "/org/nemo/ssu",
-                                           QDBusConnection::systemBus(), qApp);
-    }
-
-    QDBusPendingReply<QString> reply = ssuProxy->deviceUid();
-    reply.waitForFinished();
-    if (reply.isError()) {
-        qCWarning(cr) << "DBus unavailable, UUID might be incorrect.";
-        return DeviceInfo(true).deviceUid();
-    } else {
-        return reply.value();
-    }
+    return CReporterDeviceIdentity::instance()->deviceUid();
 #else
     return "1234";
 #endif
@@ -201,7 +176,7 @@ QString CReporterUtils::deviceUid()
 QString CReporterUtils::deviceModel()
 {
 #ifndef CREPORTER_UNIT_TEST
-    return DeviceInfo(true).model();
+    return CReporterDeviceIdentity::instance()->deviceModel();
 #else
     return "Device";
 #endif
@@ -210,45 +185,7 @@ QString CReporterUtils::deviceModel()
 bool CReporterUtils::shouldSavePower()
 {
 #ifndef CREPORTER_UNIT_TEST
-    auto *settings = CReporterPrivacySettingsModel::instance();
-
-    QDBusInterface mce(QLatin1String(MCE_SERVICE),
-            QLatin1String(MCE_REQUEST_PATH),
-            QLatin1String(MCE_REQUEST_IF),
-            QDBusConnection::systemBus());
-
-    QDBusReply<QString> batteryStatus = mce.call(QLatin1String(MCE_BATTERY_STATUS_GET));
-    if (!batteryStatus.isValid()) {
-        qCWarning(cr) << "Failed to query battery status" << batteryStatus.error().message();
-        return false;
-    }
-    QDBusReply<int> batteryLevel = mce.call(QLatin1String(MCE_BATTERY_LEVEL_GET));
-    if (!batteryLevel.isValid()) {
-        qCWarning(cr) << "Failed to query battery level" << batteryLevel.error().message();
-        return false;
-    }
-    QDBusReply<QString> chargerState = mce.call(QLatin1String(MCE_CHARGER_STATE_GET));
-    if (!chargerState.isValid()) {
-        qCWarning(cr) << "Failed to query charger state" << chargerState.error().message();
-        return false;
-    }
-
-    qCDebug(cr) << "Battery status:" << batteryStatus
-        << "level:" << batteryLevel
-        << "charger-state:" << chargerState;
-
-    if (batteryStatus == QLatin1String(MCE_BATTERY_STATUS_UNKNOWN))
-        return false;
-
-    if (batteryStatus == QLatin1String(MCE_BATTERY_STATUS_FULL)) {
-        return false;
-    } else if (chargerState != QLatin1String(MCE_CHARGER_STATE_OFF)) {
-        return settings->restrictWhenLowBattery()
-            && batteryStatus != QLatin1String(MCE_BATTERY_STATUS_OK);
-    } else {
-        return settings->restrictWhenDischarging()
-            && batteryLevel < settings->dischargingThreshold();
-    }
+    return CReporterPowerState::instance()->shouldSavePower();
 #else
     return false;
 #endif
@@ -263,33 +200,31 @@ bool CReporterUtils::reportIncludesCrash(const QString &fileName)
              fileName.contains(CReporter::HWrebootPrefix) ||
              fileName.contains(CReporter::HWSMPLPrefix) ||
              fileName.contains(CReporter::OverheatShutdownPrefix) ||
-             fileName.contains(CReporter::JournalSpyPrefix));
+             fileName.contains(CReporter::JournalSpyPrefix) ||
+             fileName.contains(CReporter::DuplicateSummaryPrefix));
 }
 
-bool CReporterUtils::notifyAutoUploader(const QStringList &filesToUpload,
+void CReporterUtils::notifyAutoUploader(const QStringList &filesToUpload,
                                         bool obeyResourcesRestrictions)
 {
-    qCDebug(cr) << "Requesting crash-reporter-autouploader to upload"
-                << filesToUpload.size() << "files.";
-
-    ComNokiaCrashReporterAutoUploaderInterface proxy(CReporter::AutoUploaderServiceName,
-            CReporter::AutoUploaderObjectPath, QDBusConnection::sessionBus());
-
-    QDBusPendingReply <bool>reply =
-        proxy.uploadFiles(filesToUpload, obeyResourcesRestrictions);
-    // This blocks.
-    reply.waitForFinished();
-
-    if (reply.isError()) {
-        qCWarning(cr) << "D-Bus error occurred:" << reply.error().name() << reply.error().message();
-
-        return false;
-    }
-    return true;
+    CReporterUploadNotifier::instance()->submit(filesToUpload, obeyResourcesRestrictions);
 }
 
 QProcess *CReporterUtils::invokeLogCollection(const QString &label)
 {
+#ifndef CREPORTER_UNIT_TEST
+    /* Each collection forks rich-core-helper, which copies logs from all
+     * over the system. Don't let a repeating trigger do that in a loop. */
+    static CReporterStormDetector *limiter = 0;
+    if (!limiter) {
+        limiter = new CReporterStormDetector(qApp);
+    }
+    if (!limiter->admit(label)) {
+        qCDebug(cr) << "Too many log collections, skipping" << label;
+        return 0;
+    }
+#endif
+
     QScopedPointer<QProcess> richCoreHelper(new QProcess(qApp));
 
     richCoreHelper->start("/usr/libexec/rich-core-helper",
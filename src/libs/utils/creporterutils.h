@@ -67,13 +67,24 @@ public:
     static bool isMounted(const QString &path);
 
     /*!
-     * Removes the given file.
+     * Removes the given file, and the saved upload offset of it.
      *
      * @param file Path to the file to remove.
      * @return true, if operation succeeds, otherwise false.
      */
     static bool removeFile(const QString &path);
 
+    /*!
+     * Returns path of the file that stores how much of @a path has been
+     * uploaded, if the upload was interrupted.
+     *
+     * The file is hidden, so that it isn't taken as a core file.
+     *
+     * @param path Path to the core file.
+     * @return Path to the upload offset file.
+     */
+    static QString uploadOffsetFile(const QString &path);
+
     /*!
      * Parses the components of *rcore.lzo filename.
      *
@@ -82,6 +93,8 @@ public:
      * indexes of the returned QStringList (0 = Application name, 1 = HWID,
      * 2 = SIGNUM and 3 = PID).
      *
+     * Kept for compatibility, new code should use CReporterCrashInfo.
+     *
      * @param Absolute file path to rich core file.
      * @return Data extracted to string list.
      */
@@ -90,6 +103,9 @@ public:
     /*!
       * @brief Appends the user comments to *.lzo -file.
       *
+      * The text is compressed in-process into a new lzop stream at the end
+      * of the file, see CReporterLzoWriter.
+      *
       * @param text File content to be appended.
       * @param filepath Path to *.lzo to be modified.
       * @return True, if operation was successfull otherwise false.
@@ -99,6 +115,8 @@ public:
     /*!
      * @brief Returns the device ID used in SSU requests.
      *
+     * Answered from CReporterDeviceIdentity without waiting for SSU.
+     *
      * @return Device ID.
      */
     static QString deviceUid();
@@ -113,6 +131,8 @@ public:
     /*!
      * @brief Determines whether running power-intensive tasks is appropriate
      *
+     * Answered from CReporterPowerState, which keeps the battery state cached.
+     *
      * @return @c true if not
      */
     static bool shouldSavePower();
@@ -128,14 +148,16 @@ public:
     /*!
      * Sends a request for auto uploader daemon to add files into upload queue.
      *
+     * The request is sent asynchronously by CReporterUploadNotifier, together
+     * with other requests made shortly before or after it.
+     *
      * @param filesToUpload A list of files we want to upload to the server.
      * @param obeyResourcesRestrictions @c false if the files should be uploaded
      *                                  regardless of the network connection type,
      *                                  i.e. also over paid mobile/3G, and battery
      *                                  state.
-     * @return @c true if files were successfully added, otherwise @c true.
      */
-    Q_INVOKABLE static bool notifyAutoUploader(const QStringList &filesToUpload,
+    Q_INVOKABLE static void notifyAutoUploader(const QStringList &filesToUpload,
             bool obeyResourcesRestrictions = true);
 
     /*!
@@ -147,8 +169,8 @@ public:
      * @return a @c QProcess instance for the invoked rich-core-dumper that you
      * can use for example to connect to its finished() signal. The instance is
      * automatically destroyed next time the application enters message loop
-     * after finished() is emitted. If rich-core-dumper fails to start,
-     * the method returns @c NULL.
+     * after finished() is emitted. If rich-core-dumper fails to start or
+     * logs are collected too often, the method returns @c NULL.
      */
     static QProcess *invokeLogCollection(const QString &label);
 
@@ -155,6 +155,19 @@ Page {
                         font.pixelSize: Theme.fontSizeExtraSmall
                         color: appLabel.color
                     }
+                    Label {
+                        visible: model.fingerprint !== ""
+                        //% " stack "
+                        text: qsTrId("settings_crash-reporter_stack_fingerprint")
+                        font.pixelSize: Theme.fontSizeExtraSmall
+                        color: listDelegate.highlighted ? Theme.secondaryHighlightColor : Theme.secondaryColor
+                    }
+                    Label {
+                        visible: model.fingerprint !== ""
+                        text: model.fingerprint
+                        font.pixelSize: Theme.fontSizeExtraSmall
+                        color: appLabel.color
+                    }
                 }
             }
         }
@@ -21,9 +21,8 @@
 
 #include "crashreporteradapter.h"
 
-#include <QFileSystemWatcher>
-
 #include "creportercoreregistry.h"
+#include "creportercorewatcher.h"
 #include "creporterutils.h"
 #include "pendinguploadsmodel.h"
 
@@ -37,8 +36,11 @@ public:
 
 private:
     void updateCoreDirectoryModels();
+    void handleCoreFilesAdded(const QStringList &filePaths);
+    void handleCoreFilesRemoved(const QStringList &filePaths);
+    void handleDirectoryRemoved(const QString &path);
 
-    QFileSystemWatcher watcher;
+    CReporterCoreWatcher watcher;
 
     Q_DECLARE_PUBLIC(CrashReporterAdapter)
     CrashReporterAdapter *q_ptr;
@@ -50,9 +52,13 @@ CrashReporterAdapterPrivate::CrashReporterAdapterPrivate(CrashReporterAdapter *q
     Q_Q(CrashReporterAdapter);
 
     updateCoreDirectoryModels();
-    // Recalculate the models when directory contents change.
-    QObject::connect(&watcher, SIGNAL(directoryChanged(const QString &)),
-                     q, SLOT(updateCoreDirectoryModels()));
+    // Update the models with the changed files, without rescanning directories.
+    QObject::connect(&watcher, SIGNAL(coreFilesAdded(QStringList)),
+                     q, SLOT(handleCoreFilesAdded(QStringList)));
+    QObject::connect(&watcher, SIGNAL(coreFilesRemoved(QStringList)),
+                     q, SLOT(handleCoreFilesRemoved(QStringList)));
+    QObject::connect(&watcher, SIGNAL(directoryRemoved(QString)),
+                     q, SLOT(handleDirectoryRemoved(QString)));
 
     watcher.addPaths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
 }
@@ -72,6 +78,31 @@ void CrashReporterAdapterPrivate::updateCoreDirectoryModels()
     pendingUploadsModel.setData(coreFiles);
 }
 
+void CrashReporterAdapterPrivate::handleCoreFilesAdded(const QStringList &filePaths)
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    foreach (const QString &filePath, filePaths) {
+        registry->registerCoreFile(filePath);
+    }
+    updateCoreDirectoryModels();
+}
+
+void CrashReporterAdapterPrivate::handleCoreFilesRemoved(const QStringList &filePaths)
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    foreach (const QString &filePath, filePaths) {
+        registry->unregisterCoreFile(filePath);
+    }
+    updateCoreDirectoryModels();
+}
+
+void CrashReporterAdapterPrivate::handleDirectoryRemoved(const QString &path)
+{
+    // Drops the cores of the directory; not expected to happen often.
+    CReporterCoreRegistry::instance()->refreshDirectory(path);
+    updateCoreDirectoryModels();
+}
+
 CrashReporterAdapter::CrashReporterAdapter(QObject *parent)
     : QObject(parent), d_ptr(new CrashReporterAdapterPrivate(this))
 {
@@ -93,7 +124,7 @@ QAbstractListModel *CrashReporterAdapter::pendingUploads()
 
 void CrashReporterAdapter::deleteCrashReport(const QString &filePath) const
 {
-    QFile::remove(filePath);
+    CReporterUtils::removeFile(filePath);
 }
 
 void CrashReporterAdapter::uploadAllCrashReports() const
@@ -105,7 +136,7 @@ void CrashReporterAdapter::uploadAllCrashReports() const
 void CrashReporterAdapter::deleteAllCrashReports() const
 {
     foreach (const QString &filename, CReporterCoreRegistry::instance()->collectAllCoreFiles()) {
-        QFile(filename).remove();
+        CReporterUtils::removeFile(filename);
     }
 }
 
@@ -53,7 +53,9 @@ private:
 
     QScopedPointer<CrashReporterAdapterPrivate> d_ptr;
 
-    Q_PRIVATE_SLOT(d_func(), void updateCoreDirectoryModels())
+    Q_PRIVATE_SLOT(d_func(), void handleCoreFilesAdded(const QStringList &))
+    Q_PRIVATE_SLOT(d_func(), void handleCoreFilesRemoved(const QStringList &))
+    Q_PRIVATE_SLOT(d_func(), void handleDirectoryRemoved(const QString &))
 };
 
 #endif // CRASHREPORTERADAPTER_H
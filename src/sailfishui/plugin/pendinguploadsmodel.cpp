@@ -23,8 +23,20 @@
 
 #include <QStringList>
 #include <QDateTime>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 
-#include "creporterutils.h"
+#include "creportercrashinfo.h"
+#include "creporterstackfingerprint.h"
+
+namespace {
+QString shortFingerprint(const QString &filePath)
+{
+    // Leading bytes are enough to tell crashes apart by eye.
+    return QString::fromLatin1(CReporterStackFingerprint::fromFile(filePath).left(4).toHex());
+}
+} // namespace
 
 class PendingUploadsModelPrivate
 {
@@ -35,14 +47,52 @@ public:
         QString signal;
         QString filePath;
         QDateTime dateCreated;
+        QString fingerprint;
     };
 
+    /* Reports are decompressed in the thread pool, so that the view
+     * doesn't stall. Lookups by file path. */
+    QHash<QString, QFutureWatcher<QString> *> fingerprintLookups;
+
     QList<Item> contents;
+
+    void fingerprintsReady();
+
+    Q_DECLARE_PUBLIC(PendingUploadsModel)
+    PendingUploadsModel *q_ptr;
 };
 
+void PendingUploadsModelPrivate::fingerprintsReady()
+{
+    Q_Q(PendingUploadsModel);
+
+    QHash<QString, QFutureWatcher<QString> *>::iterator it = fingerprintLookups.begin();
+    while (it != fingerprintLookups.end()) {
+        QFutureWatcher<QString> *watcher = it.value();
+        if (!watcher->isFinished()) {
+            ++it;
+            continue;
+        }
+
+        for (int i = 0; i < contents.count(); ++i) {
+            if (contents.at(i).filePath == it.key()) {
+                contents[i].fingerprint = watcher->result();
+                QModelIndex index(q->index(i));
+                emit q->dataChanged(index, index,
+                                    QVector<int>() << PendingUploadsModel::Fingerprint);
+                break;
+            }
+        }
+
+        watcher->deleteLater();
+        it = fingerprintLookups.erase(it);
+    }
+}
+
 PendingUploadsModel::PendingUploadsModel(QObject *parent)
     : QAbstractListModel(parent), d_ptr(new PendingUploadsModelPrivate)
 {
+    d_ptr->q_ptr = this;
 }
 
 PendingUploadsModel::~PendingUploadsModel()
@@ -77,6 +127,9 @@ QVariant PendingUploadsModel::data(const QModelIndex &index, int role) const
         return item.filePath;
     case DateCreated:
         return item.dateCreated;
+    case Fingerprint:
+        // Empty until the lookup finishes.
+        return item.fingerprint;
     default:
         return QVariant();
     }
@@ -90,6 +143,7 @@ QHash<int, QByteArray> PendingUploadsModel::roleNames() const
     result.insert(Signal, "signal");
     result.insert(FilePath, "filePath");
     result.insert(DateCreated, "dateCreated");
+    result.insert(Fingerprint, "fingerprint");
 
     return result;
 }
@@ -103,6 +157,8 @@ void PendingUploadsModel::setData(const QStringList &data)
     for (int i = 0; i != d->contents.size(); ++i) {
         int index = newData.indexOf(d->contents.at(i).filePath);
         if (index == -1) {
+            // The result of a pending lookup is no longer needed.
+            delete d->fingerprintLookups.take(d->contents.at(i).filePath);
             beginRemoveRows(QModelIndex(), i, i);
             d->contents.removeAt(i--);
             endRemoveRows();
@@ -118,15 +174,22 @@ void PendingUploadsModel::setData(const QStringList &data)
 
     // Append new items.
     foreach (const QString &filePath, newData) {
-        QStringList info(CReporterUtils::parseCrashInfoFromFilename(filePath));
+        CReporterCrashInfo info(CReporterCrashInfo::fromFileName(filePath));
 
         PendingUploadsModelPrivate::Item item;
-        item.applicationName = info[0];
-        item.pid = info[3].toInt();
-        item.signal = strsignal(info[2].toInt());
+        item.applicationName = info.applicationName();
+        item.pid = info.pid();
+        item.signal = strsignal(info.signalNumber());
         item.filePath = filePath;
         item.dateCreated = QFileInfo(filePath).created();
 
+        if (info.includesCrash() && !d->fingerprintLookups.contains(filePath)) {
+            QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+            connect(watcher, SIGNAL(finished()), this, SLOT(fingerprintsReady()));
+            watcher->setFuture(QtConcurrent::run(shortFingerprint, filePath));
+            d->fingerprintLookups.insert(filePath, watcher);
+        }
+
         int i = 0;
         for (; i < d->contents.count(); ++i) {
             if (item.dateCreated > d->contents.at(i).dateCreated) {
@@ -138,3 +201,5 @@ void PendingUploadsModel::setData(const QStringList &data)
         endInsertRows();
     }
 }
+
+#include "moc_pendinguploadsmodel.cpp"
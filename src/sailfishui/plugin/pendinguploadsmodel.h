@@ -36,6 +36,7 @@ public:
         Signal,
         FilePath,
         DateCreated,
+        Fingerprint,
     };
 
     PendingUploadsModel(QObject *parent = 0);
@@ -51,6 +52,8 @@ public:
 private:
     Q_DECLARE_PRIVATE(PendingUploadsModel)
     QScopedPointer<PendingUploadsModelPrivate> d_ptr;
+
+    Q_PRIVATE_SLOT(d_func(), void fingerprintsReady())
 };
 
 #endif // PENDINGUPLOADSMODEL_H
@@ -4,7 +4,7 @@ TARGET = $$qtLibraryTarget(settingsplugin)
 MODULENAME = com/jolla/settings/crashreporter
 TARGETPATH = $$[QT_INSTALL_QML]/$$MODULENAME
 
-QT += dbus qml
+QT += concurrent dbus qml
 CONFIG += plugin
 
 qml.files = qmldir *.qml
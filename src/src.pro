@@ -8,6 +8,7 @@ SUBDIRS += \
     autouploader \
     sailfishui \
     endurancecollect \
+    endurancepack \
     richcorehelper \
     journalspy \
     servicehelper \
@@ -29,6 +29,7 @@
 #include <notification.h>
 
 #include "creporterapplicationsettings.h"
+#include "creportercoreindex.h"
 #include "creportercoreregistry.h"
 #include "creporternamespace.h"
 #include "creportersavedstate.h"
@@ -114,11 +115,7 @@ private:
     {
         qCDebug(cr) << "Size limit:" << m_sizeLimitMb << "MiB";
 
-        qint64 totalSize = 0;
-        CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
-        foreach (const QString &coreFile, registry->collectAllCoreFiles()) {
-            totalSize += QFileInfo(coreFile).size();
-        }
+        qint64 totalSize = CReporterCoreRegistry::instance()->coreIndex()->totalSize();
 
         if (totalSize < (m_sizeLimitMb << 20)) {
             qCDebug(cr) << "Low storage usage - will not be reported";
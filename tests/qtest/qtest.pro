@@ -6,13 +6,26 @@ SUBDIRS =  ut_creporterdaemonmonitor \
           ut_creportercoreregistry \
           ut_creportersettingsobserver \
           ut_creportercoredir \
+          ut_creportercorewatcher \
           ut_creporterutils \
+          ut_creporterlzowriter \
           ut_creporternwsessionmgr \
           ut_creporteruploaditem \
           ut_creporteruploadqueue \
           ut_creporteruploadengine \
+          ut_creporterhttpclientupload \
+          ut_creporteruploadjournal \
+          ut_creporterdigestindex \
+          ut_creporterduplicatesummary \
+          ut_creportersignatureindex \
+          ut_creporterstackfingerprint \
+          ut_creporterstormdetector \
+          ut_creporterpowerstate \
+          ut_creporterdeviceidentity \
+          ut_creporterretrypolicy \
           ut_creporterapplicationsettings \
           ut_creporterprivacysettingsmodel \
+          ut_endurancepacker \
 
 testsxml.target = $$OUT_PWD/tests.xml
 testsxml.commands = $$PWD/generate_tests_xml.sh $$PWD > $$testsxml.target
@@ -21,6 +21,15 @@ QNetworkReply *QNetworkAccessManager::put(const QNetworkRequest &request,
     return new QNetworkReply(this);
 }
 
+QNetworkReply *QNetworkAccessManager::put(const QNetworkRequest &request,
+        QIODevice *data)
+{
+    Q_UNUSED(request);
+    Q_UNUSED(data);
+
+    return new QNetworkReply(this);
+}
+
 void QNetworkAccessManager::emitAuthenticationRequired(QNetworkReply *reply)
 {
     emit authenticationRequired(reply, new QAuthenticator());
@@ -33,6 +33,7 @@ public:
     void setProxy(const QNetworkProxy &proxy);
     QNetworkReply *post(const QNetworkRequest &request, const QByteArray &data);
     QNetworkReply *put(const QNetworkRequest &request, const QByteArray &data);
+    QNetworkReply *put(const QNetworkRequest &request, QIODevice *data);
 
     void emitAuthenticationRequired(QNetworkReply *reply);
 
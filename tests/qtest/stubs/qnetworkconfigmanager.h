@@ -20,6 +20,10 @@ public:
 
     void updateConfigurations() {}
 
+Q_SIGNALS:
+    void onlineStateChanged(bool isOnline);
+    void configurationChanged(const QNetworkConfiguration &config);
+
 private:
     QNetworkConfiguration m_defaultConfiguration;
 };
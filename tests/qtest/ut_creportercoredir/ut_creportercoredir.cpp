@@ -26,6 +26,7 @@
 #include <QStringList>
 #include <QFile>
 #include <QDir>
+#include <QSignalSpy>
 
 #include "ut_creportercoredir.h"
 #include "creportercoredir.h"
@@ -87,10 +88,10 @@ void Ut_CReporterCoreDir::testCollectingCrashReportsFromDirectory()
     richCoreInvalid.open(QIODevice::ReadWrite);
     richCoreInvalid.close();
 
-    QStringList files;
-    dir->collectAllCoreFilesAtLocation(files);
+    QSignalSpy addedSpy(dir, SIGNAL(coreFileAdded(QString)));
+    dir->updateCoreList();
 
-    QCOMPARE(files.count(), 2);
+    QCOMPARE(addedSpy.count(), 2);
 }
 
 void Ut_CReporterCoreDir::testCheckDirectoryForNewCrashReport()
@@ -108,9 +109,59 @@ void Ut_CReporterCoreDir::testCheckDirectoryForNewCrashReport()
     richCore.open(QIODevice::ReadWrite);
     richCore.close();
 
-    QString newFile = dir->checkDirectoryForCores();
+    QFile richCore2;
+    richCore2.setFileName("rich-core-application2.rcore.lzo");
+    richCore2.open(QIODevice::ReadWrite);
+    richCore2.close();
+
+    QSignalSpy addedSpy(dir, SIGNAL(coreFileAdded(QString)));
+    QSignalSpy removedSpy(dir, SIGNAL(coreFileRemoved(QString)));
+
+    // All new files are reported at once.
+    dir->updateCoreList();
+    QStringList newFiles;
+    for (int i = 0; i < addedSpy.count(); ++i) {
+        newFiles << addedSpy.at(i).at(0).toString();
+    }
+    newFiles.sort();
+
+    QCOMPARE(newFiles, QStringList()
+             << coreDirectory + "/rich-core-application.rcore.lzo"
+             << coreDirectory + "/rich-core-application2.rcore.lzo");
+
+    addedSpy.clear();
+    QVERIFY(richCore.remove());
+    dir->updateCoreList();
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(0).toString(),
+             coreDirectory + "/rich-core-application.rcore.lzo");
+}
+
+void Ut_CReporterCoreDir::benchmarkCheckDirectoryForCores()
+{
+    dir = new CReporterCoreDir(testMountPoint2);
 
-    QVERIFY(newFile == coreDirectory.append("/rich-core-application.rcore.lzo"));
+    QString coreDirectory = QString(testMountPoint2);
+    coreDirectory.append("/core-dumps");
+    dir->setDirectory(coreDirectory);
+    dir->createCoreDirectory();
+
+    for (int i = 0; i < 10000; ++i) {
+        QFile richCore(QString("%1/application-1234-11-%2.rcore.lzo")
+                       .arg(coreDirectory).arg(i));
+        richCore.open(QIODevice::WriteOnly);
+        richCore.close();
+    }
+
+    QSignalSpy addedSpy(dir, SIGNAL(coreFileAdded(QString)));
+    dir->updateCoreList();
+    QCOMPARE(addedSpy.count(), 10000);
+
+    // Diffing a large, unchanged directory must stay linear.
+    QBENCHMARK {
+        dir->updateCoreList();
+    }
 }
 
 void Ut_CReporterCoreDir::cleanupTestCase()
@@ -40,6 +40,7 @@ private slots:
     void testCreationOfDirectoryForCores();
     void testCollectingCrashReportsFromDirectory();
     void testCheckDirectoryForNewCrashReport();
+    void benchmarkCheckDirectoryForCores();
     void cleanupTestCase();
     void cleanup();
 
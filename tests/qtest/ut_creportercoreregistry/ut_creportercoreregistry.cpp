@@ -23,6 +23,7 @@
  */
 
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QDir>
 #include <QFile>
 #include <QVariant>
@@ -30,9 +31,11 @@
 #include <MGConfItem>
 #include <QMap>
 
+#include "creportercoreindex.h"
 #include "creportercoreregistry.h"
 #include "creportercoreregistry_p.h"
 #include "creportertestutils.h"
+#include "creporterutils.h"
 #include "ut_creportercoreregistry.h"
 
 extern QMap<QString, MGConfItem *> gMGConfItems;
@@ -40,6 +43,121 @@ extern QMap<QString, MGConfItem *> gMGConfItems;
 void Ut_CReporterCoreRegistry::initTestCase()
 {
     CReporterTestUtils::createTestMountpoints();
+    // Act as the daemon.
+    CReporterCoreRegistry::instance()->reconcileIndex();
+}
+
+void Ut_CReporterCoreRegistry::testCoreIndexFollowsDirectory()
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    CReporterCoreIndex *index = registry->coreIndex();
+    QString path(registry->getCoreLocationPaths().first());
+
+    QFile core(path + "/application-1234-11-4321.rcore.lzo");
+    QVERIFY(core.open(QIODevice::WriteOnly));
+    core.write("rich core");
+    core.close();
+
+    registry->refreshDirectory(path);
+
+    QCOMPARE(registry->collectAllCoreFiles(), QStringList() << core.fileName());
+    QCOMPARE(index->totalSize(), qint64(9));
+
+    CReporterCoreIndex::Entry entry = index->entry(core.fileName());
+    QCOMPARE(entry.applicationName, QString("application"));
+    QCOMPARE(entry.hwId, QString("1234"));
+    QCOMPARE(entry.signalNumber, 11);
+    QCOMPARE(entry.pid, 4321);
+    QCOMPARE(entry.uploadState, CReporterCoreIndex::NotUploaded);
+
+    // Persisted index is loaded back without scanning the directory.
+    QVERIFY(index->save());
+    CReporterCoreIndex reloaded(index->indexFile());
+    QCOMPARE(reloaded.filePaths(), QStringList() << core.fileName());
+    QCOMPARE(reloaded.totalSize(), qint64(9));
+
+    core.remove();
+    registry->refreshDirectory(path);
+
+    QVERIFY(registry->collectAllCoreFiles().isEmpty());
+    QCOMPARE(index->totalSize(), qint64(0));
+}
+
+void Ut_CReporterCoreRegistry::testSharedIndexKeepsFiles()
+{
+    QTemporaryDir dir;
+    QString path(dir.path());
+    QString indexFile(path + "/core-index");
+
+    QStringList files;
+    for (int i = 0; i < 2; ++i) {
+        QFile core(path + QString("/application-1234-11-%1.rcore.lzo").arg(1000 + i));
+        QVERIFY(core.open(QIODevice::WriteOnly));
+        core.close();
+        files << core.fileName();
+    }
+
+    CReporterCoreIndex owner(indexFile);
+    owner.setOwner(true);
+    owner.add(files.at(0));
+    QVERIFY(owner.save());
+
+    // Another process loads the index before the second core is added.
+    CReporterCoreIndex shared(indexFile);
+    QVERIFY(!shared.isOwner());
+    QCOMPARE(shared.filePaths(), files.mid(0, 1));
+
+    owner.add(files.at(1));
+    QVERIFY(owner.save());
+
+    // The stale process only merges its upload state into the file.
+    shared.setUploadState(files.at(0), CReporterCoreIndex::Uploaded);
+    QVERIFY(shared.save());
+
+    CReporterCoreIndex reloaded(indexFile);
+    QCOMPARE(reloaded.filePaths(), files);
+    QCOMPARE(reloaded.entry(files.at(0)).uploadState, CReporterCoreIndex::Uploaded);
+
+    // Newer state from the other process is kept by the owner too.
+    owner.setUploadState(files.at(1), CReporterCoreIndex::UploadFailed);
+    QVERIFY(owner.save());
+    QCOMPARE(owner.entry(files.at(0)).uploadState, CReporterCoreIndex::Uploaded);
+}
+
+void Ut_CReporterCoreRegistry::testUploadOffsetsAreRemoved()
+{
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+    QString path(registry->getCoreLocationPaths().first());
+
+    QFile core(path + "/application-1234-11-4321.rcore.lzo");
+    QVERIFY(core.open(QIODevice::WriteOnly));
+    core.close();
+    QFile offset(CReporterUtils::uploadOffsetFile(core.fileName()));
+    QVERIFY(offset.open(QIODevice::WriteOnly));
+    offset.close();
+    registry->refreshDirectory(path);
+
+    // Core removed behind the back of the registry.
+    core.remove();
+    registry->refreshDirectory(path);
+    QVERIFY(!offset.exists());
+
+    // Offset of a core that is gone by the time the registry starts.
+    QFile orphan(CReporterUtils::uploadOffsetFile(path + "/application-1234-11-9999.rcore.lzo"));
+    QVERIFY(orphan.open(QIODevice::WriteOnly));
+    orphan.close();
+    QVERIFY(offset.open(QIODevice::WriteOnly));
+    offset.close();
+    QVERIFY(core.open(QIODevice::WriteOnly));
+    core.close();
+    registry->refreshDirectory(path);
+
+    registry->removeOrphanedUploadOffsets();
+    QVERIFY(!orphan.exists());
+    QVERIFY(offset.exists());
+
+    core.remove();
+    registry->refreshDirectory(path);
 }
 
 void Ut_CReporterCoreRegistry::testRegistryRefreshNeededEmission()
@@ -38,6 +38,9 @@ private slots:
 
     void initTestCase();
 
+    void testCoreIndexFollowsDirectory();
+    void testSharedIndexKeepsFiles();
+    void testUploadOffsetsAreRemoved();
     void testRegistryRefreshNeededEmission();
     void testCoreLocationsUpdatedEmission();
 
@@ -23,6 +23,7 @@ TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
 HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
+		   $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.h \
 		   $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
 		   ut_creportercoreregistry.h \
@@ -30,6 +31,7 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
 		   ut_creportercoreregistry.cpp \
 
@@ -0,0 +1,139 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "ut_creportercorewatcher.h"
+#include "creportercorewatcher.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests/core-dumps");
+
+static void createFile(const QString &fileName)
+{
+    QFile file(testDirectory + '/' + fileName);
+    file.open(QIODevice::WriteOnly);
+    file.write("rich core");
+    file.close();
+}
+
+static QStringList collectPaths(const QSignalSpy &spy)
+{
+    QStringList paths;
+    for (int i = 0; i < spy.count(); ++i) {
+        paths << spy.at(i).at(0).toStringList();
+    }
+    paths.sort();
+    return paths;
+}
+
+void Ut_CReporterCoreWatcher::init()
+{
+    QDir().mkpath(testDirectory);
+
+    watcher = new CReporterCoreWatcher();
+    QVERIFY(watcher->addPath(testDirectory));
+    QCOMPARE(watcher->directories(), QStringList() << testDirectory);
+}
+
+void Ut_CReporterCoreWatcher::testBurstOfCoresIsReported()
+{
+    QSignalSpy addedSpy(watcher, SIGNAL(coreFilesAdded(QStringList)));
+
+    // Several cores arrive before the event loop runs; none may be skipped.
+    QStringList expected;
+    for (int i = 0; i < 5; ++i) {
+        QString fileName = QString("app-1234-11-%1.rcore.lzo").arg(1000 + i);
+        createFile(fileName);
+        expected << testDirectory + '/' + fileName;
+    }
+    createFile("notes.txt");
+    createFile(".partial-1234-11-1.rcore.lzo");
+
+    QTRY_VERIFY(addedSpy.count() > 0);
+    QTest::qWait(50);
+
+    QCOMPARE(collectPaths(addedSpy), expected);
+}
+
+void Ut_CReporterCoreWatcher::testRemovedCoresAreReported()
+{
+    createFile("app-1234-11-1000.rcore.lzo");
+    QTest::qWait(50);
+
+    QSignalSpy addedSpy(watcher, SIGNAL(coreFilesAdded(QStringList)));
+    QSignalSpy removedSpy(watcher, SIGNAL(coreFilesRemoved(QStringList)));
+
+    QFile::remove(testDirectory + "/app-1234-11-1000.rcore.lzo");
+
+    // File created and deleted within one batch doesn't produce events.
+    createFile("app-1234-11-1001.rcore.lzo");
+    QFile::remove(testDirectory + "/app-1234-11-1001.rcore.lzo");
+
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(collectPaths(removedSpy),
+             QStringList() << testDirectory + "/app-1234-11-1000.rcore.lzo");
+    QCOMPARE(addedSpy.count(), 0);
+}
+
+void Ut_CReporterCoreWatcher::testDirectoryRemoval()
+{
+    QSignalSpy removedSpy(watcher, SIGNAL(directoryRemoved(QString)));
+
+    QDir(testDirectory).removeRecursively();
+
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(0).toString(), testDirectory);
+    QVERIFY(watcher->directories().isEmpty());
+}
+
+void Ut_CReporterCoreWatcher::testOverflowIsReported()
+{
+    QFile limit("/proc/sys/fs/inotify/max_queued_events");
+    QVERIFY(limit.open(QIODevice::ReadOnly));
+    int maxEvents = limit.readAll().trimmed().toInt();
+    QVERIFY(maxEvents > 0);
+
+    QSignalSpy overflowSpy(watcher, SIGNAL(overflowed()));
+
+    // More events than the kernel queues before the event loop reads them.
+    for (int i = 0; i <= maxEvents; ++i) {
+        createFile(QString("filler-%1").arg(i));
+    }
+
+    QTRY_COMPARE(overflowSpy.count(), 1);
+
+    // Watching goes on after the overflow.
+    QSignalSpy addedSpy(watcher, SIGNAL(coreFilesAdded(QStringList)));
+    createFile("app-1234-11-1000.rcore.lzo");
+    QTRY_COMPARE(addedSpy.count(), 1);
+    QCOMPARE(overflowSpy.count(), 1);
+}
+
+void Ut_CReporterCoreWatcher::cleanup()
+{
+    delete watcher;
+    watcher = 0;
+
+    QDir("/tmp/crash-reporter-tests").removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterCoreWatcher)
@@ -25,7 +25,9 @@
 #include "stdlib.h"
 
 #include <QSignalSpy>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 #include <QSettings>
 #include <QCoreApplication>
 #include <QProcess>
@@ -42,6 +44,8 @@
 #include "creporterdialogserverdbusadaptor.h"
 #include "creportersettingsinit_p.h"
 #include "creporternotification.h"
+#include "creporternwsessionmgr.h"
+#include "creporteruploadjournal.h"
 
 static const char *test_files1[] = {
     "test_core.rcore.lzo",
@@ -149,6 +153,30 @@ void TestDialogServer::quit()
     quitCalled = true;
 }
 
+TestAutoUploader::TestAutoUploader()
+{
+    uploadRequests = 0;
+
+    QDBusConnection::sessionBus().registerObject(CReporter::AutoUploaderObjectPath, this,
+                                                 QDBusConnection::ExportAllSlots);
+    QDBusConnection::sessionBus().registerService(CReporter::AutoUploaderServiceName);
+}
+
+TestAutoUploader::~TestAutoUploader()
+{
+    QDBusConnection::sessionBus().unregisterService(CReporter::AutoUploaderServiceName);
+    QDBusConnection::sessionBus().unregisterObject(CReporter::AutoUploaderObjectPath);
+}
+
+bool TestAutoUploader::uploadFiles(const QStringList &fileList, bool obeyNetworkRestrictions)
+{
+    Q_UNUSED(obeyNetworkRestrictions);
+
+    uploadRequests++;
+    requestedFiles << fileList;
+    return true;
+}
+
 void Ut_CReporterDaemon::initTestCase()
 {
     CReporterTestUtils::createTestMountpoints();
@@ -378,6 +406,69 @@ void Ut_CReporterDaemon::testLaunchingUIFailed()
     QVERIFY(notificationCreated == true);
 }
 
+void Ut_CReporterDaemon::testConnectivityChangesAreCoalesced()
+{
+    QStringList compareFiles;
+    TestAutoUploader autoUploader;
+
+    QStringList paths(CReporterCoreRegistry::instance()->getCoreLocationPaths());
+    CReporterTestUtils::createTestDataFiles(paths, compareFiles, test_files1);
+
+    daemon = new CReporterDaemon;
+    CReporterPrivacySettingsModel::instance()->setAutomaticSendingEnabled(true);
+    CReporterPrivacySettingsModel::instance()->setAllowMobileData(true);
+
+    // Connecting to a network produces a burst of changes.
+    for (int i = 0; i < 5; ++i) {
+        QMetaObject::invokeMethod(daemon->d_ptr->networkWatcher, "connectivityChanged");
+        QTest::qWait(100);
+    }
+    QCOMPARE(autoUploader.uploadRequests, 0);
+
+    // Pending reports are handed over once, after the changes have settled.
+    QTest::qWait(4000);
+    QCOMPARE(autoUploader.uploadRequests, 1);
+    compareFiles.sort();
+    autoUploader.requestedFiles.sort();
+    QCOMPARE(autoUploader.requestedFiles, compareFiles);
+
+    // Uploading was possible already, so there is nothing new to hand over.
+    QMetaObject::invokeMethod(daemon->d_ptr->networkWatcher, "connectivityChanged");
+    QTest::qWait(4000);
+    QCOMPARE(autoUploader.uploadRequests, 1);
+
+    CReporterTestUtils::removeDirectories(paths);
+}
+
+void Ut_CReporterDaemon::testFailedUploadIsRetried()
+{
+    TestAutoUploader autoUploader;
+    QString journalFile(CReporterUploadJournal::defaultJournalFile());
+    QString filePath(QFileInfo(journalFile).absolutePath() + "/app-1234-11-4321.rcore.lzo");
+    QDir().mkpath(QFileInfo(journalFile).absolutePath());
+
+    {
+        // Left by an earlier auto uploader session that failed.
+        CReporterUploadJournal journal(journalFile);
+        journal.add(filePath);
+        journal.setState(filePath, CReporterUploadJournal::Uploading);
+        journal.setState(filePath, CReporterUploadJournal::Failed, "Server error");
+        journal.setNextEligible(filePath, QDateTime::currentMSecsSinceEpoch() + 2000);
+    }
+
+    daemon = new CReporterDaemon;
+    CReporterPrivacySettingsModel::instance()->setAutomaticSendingEnabled(true);
+    CReporterPrivacySettingsModel::instance()->setAllowMobileData(true);
+    QVERIFY(daemon->d_ptr->retryTimer.isActive());
+
+    // No new reports or network changes, the retry comes from the journal.
+    QTest::qWait(5000);
+    QCOMPARE(autoUploader.uploadRequests, 0);
+    QTRY_COMPARE_WITH_TIMEOUT(autoUploader.uploadRequests, 1, 15000);
+
+    QFile::remove(journalFile);
+}
+
 void Ut_CReporterDaemon::cleanupTestCase()
 {
     CReporterTestUtils::removeTestMountpoints();
@@ -56,6 +56,22 @@ public:
     QString requestedDialog;
 };
 
+class TestAutoUploader : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.CrashReporter.AutoUploader")
+public:
+    TestAutoUploader();
+
+    ~TestAutoUploader();
+public Q_SLOTS:
+    bool uploadFiles(const QStringList &fileList, bool obeyNetworkRestrictions);
+
+public:
+    int uploadRequests;
+    QStringList requestedFiles;
+};
+
 class Ut_CReporterDaemon : public QObject
 {
     Q_OBJECT
@@ -71,6 +87,8 @@ private slots:
     void testMonitoringEnabledFromSettings();
     void testMonitoringDisabledFromSettings();
     void testLaunchingUIFailed();
+    void testConnectivityChangesAreCoalesced();
+    void testFailedUploadIsRetried();
 
     void cleanupTestCase();
     void cleanup();
@@ -14,6 +14,9 @@ INCLUDEPATH += . \
     $${CREPORTER_SRC_DIR}/libs/notification
 DEPENDPATH += $$INCLUDEPATH
 
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
 TEST_STUBS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.cpp \
     $${CREPORTER_STUBS_DIR}/qnetworkconfiguration.cpp \
     $${CREPORTER_STUBS_DIR}/qnetworksession.cpp
@@ -32,9 +35,18 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercorewatcher.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creporterduplicatesummary.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportersignatureindex.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterlzoreader.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterrichcorereader.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstackfingerprint.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstormdetector.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
+    $${CREPORTER_SRC_DIR}/libs/httpclient/creporteruploadjournal.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
@@ -42,7 +54,9 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver_p.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.h \
     $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.h \
     $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
     ut_creporterdaemon.h
 
@@ -54,13 +68,24 @@ SOURCES += $$TEST_SOURCES \
     $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.cpp \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercorewatcher.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creporterduplicatesummary.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportersignatureindex.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterlzoreader.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterrichcorereader.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstackfingerprint.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterstormdetector.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.cpp \
+    $${CREPORTER_SRC_DIR}/libs/httpclient/creporteruploadjournal.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.cpp \
     $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+    $${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.cpp \
     ut_creporterdaemon.cpp
 include(../ut_coverage.pri)
@@ -37,6 +37,29 @@
 #include "creporterdialogserverdbusadaptor.h"
 #include "creporterdaemonmonitor_p.h"
 #include "creporternotification.h"
+#include "creporterprivacysettingsmodel.h"
+#include "creporterduplicatesummary.h"
+#include "creportersignatureindex.h"
+#include "creporterstormdetector.h"
+
+static const QByteArray unresolvedStack(
+        "Thread 1 (Thread 0xb6f2c000 (LWP 2260)):\n"
+        "#0  0xb6d00100 in ?? () from /usr/lib/libplugin.so.1\n"
+        "#1  0xb6d00200 in ?? () from /usr/lib/libplugin.so.1\n"
+        "#2  0xb6c00300 in ?? () from /usr/lib/libQt5Core.so.5\n");
+
+static const QByteArray symbolizedStack(
+        "Thread 1 (Thread 0xb6f2c000 (LWP 2260)):\n"
+        "#0  0x00012345 in Crasher::crash (this=0x1e2f0) at crasher.cpp:42\n"
+        "#1  0x00012400 in main (argc=1, argv=0xbefff6d4) at main.cpp:50\n");
+
+static void writeRichCore(const QString &path, const QByteArray &stackTrace)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("\n[---rich-core: stack-trace---]\n" + stackTrace
+               + "\n[---rich-core: coredump---]\nELF");
+}
 
 static bool notificationCreated;
 static bool notificationUpdated;
@@ -275,6 +298,129 @@ void Ut_CReporterDaemonMonitor::testAutoDeleteDublicateCores()
     QVERIFY(QFile::exists(filePath) == false);
 }
 
+void Ut_CReporterDaemonMonitor::testUnresolvedStacksKeepBinaryName()
+{
+    CReporterPrivacySettingsModel::instance()->setIncludeStackTrace(true);
+    monitor = new CReporterDaemonMonitor(this);
+    CReporterDaemonMonitorPrivate *d = monitor->d_ptr;
+
+    // Different applications crashing in the same unsymbolized library.
+    // Written outside the monitored directories to check them directly.
+    QString first(QDir::tempPath() + "/firstapp-0287-11-2260.rcore");
+    QString second(QDir::tempPath() + "/secondapp-0287-11-2261.rcore");
+    writeRichCore(first, unresolvedStack);
+    writeRichCore(second, unresolvedStack);
+
+    quint64 firstSignature = 0;
+    quint64 secondSignature = 0;
+    d->checkForDuplicates(first, &firstSignature);
+    d->checkForDuplicates(second, &secondSignature);
+    QVERIFY(firstSignature != secondSignature);
+
+    // The same code run through different launchers is still one crash.
+    writeRichCore(first, symbolizedStack);
+    writeRichCore(second, symbolizedStack);
+    d->checkForDuplicates(first, &firstSignature);
+    d->checkForDuplicates(second, &secondSignature);
+    QCOMPARE(firstSignature, secondSignature);
+
+    QFile::remove(first);
+    QFile::remove(second);
+}
+
+void Ut_CReporterDaemonMonitor::testStormDuplicatesAreCapped()
+{
+    CReporterPrivacySettingsModel *settings = CReporterPrivacySettingsModel::instance();
+    settings->setNotificationsEnabled(false);
+    settings->setAutoDeleteDuplicates(true);
+    settings->setAggregateDuplicates(false);
+
+    monitor = new CReporterDaemonMonitor(this);
+    monitor->setAutoDeleteMaxSimilarCores(2);
+    CReporterDaemonMonitorPrivate *d = monitor->d_ptr;
+    // Counts of earlier runs must not affect the test.
+    delete d->signatures;
+    d->signatures = new CReporterSignatureIndex(QString(), d);
+    // Everything after the first crash is suppressed.
+    d->storm->setSourceLimit(1, 1);
+
+    QStringList files;
+    for (int pid = 100; pid < 105; ++pid) {
+        QString path(QString("%1/looper-0287-11-%2.rcore").arg(QDir::tempPath()).arg(pid));
+        writeRichCore(path, unresolvedStack);
+        d->handleNewCore(path);
+        files << path;
+    }
+
+    QVERIFY(d->storm->inStorm());
+    // Deferred reports aren't checked for duplicates during the storm.
+    QCOMPARE(d->stormDeferred, files.mid(1));
+    foreach (const QString &file, files) {
+        QVERIFY(QFile::exists(file));
+    }
+
+    // Only the reports within the limit are kept when the storm ends.
+    QMap<QString, int> suppressed;
+    suppressed.insert("looper", 4);
+    d->handleStormEnded(suppressed, 1000);
+    QVERIFY(d->stormDeferred.isEmpty());
+    QVERIFY(QFile::exists(files.at(0)));
+    QVERIFY(QFile::exists(files.at(1)));
+    for (int i = 2; i < files.count(); ++i) {
+        QVERIFY(!QFile::exists(files.at(i)));
+    }
+
+    QFile::remove(files.at(0));
+    QFile::remove(files.at(1));
+}
+
+void Ut_CReporterDaemonMonitor::testUnrecordedDuplicatesAreKept()
+{
+    CReporterPrivacySettingsModel *settings = CReporterPrivacySettingsModel::instance();
+    settings->setNotificationsEnabled(false);
+    settings->setAutoDeleteDuplicates(false);
+    settings->setAggregateDuplicates(true);
+
+    monitor = new CReporterDaemonMonitor(this);
+    monitor->setAutoDeleteMaxSimilarCores(0);
+    CReporterDaemonMonitorPrivate *d = monitor->d_ptr;
+    delete d->signatures;
+    d->signatures = new CReporterSignatureIndex(QString(), d);
+    // Without a directory the summary can't be written.
+    delete d->duplicates;
+    d->duplicates = new CReporterDuplicateSummary(QString(), d);
+
+    QString path(QDir::tempPath() + "/recorder-0287-11-100.rcore");
+    writeRichCore(path, unresolvedStack);
+    d->handleNewCore(path);
+    QVERIFY(QFile::exists(path));
+
+    // Deleting doesn't depend on the summary.
+    settings->setAutoDeleteDuplicates(true);
+    d->handleNewCore(path);
+    QVERIFY(!QFile::exists(path));
+}
+
+void Ut_CReporterDaemonMonitor::testMissedCoresAreFoundOnOverflow()
+{
+    monitor = new CReporterDaemonMonitor(this);
+    QSignalSpy richCoreNotifySpy(monitor, SIGNAL(richCoreNotify(QString)));
+
+    QString filePath(paths.at(0) + "/missed-1234-11-4321.rcore.lzo");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    // The event of the file is lost, the rescan finds it.
+    QMetaObject::invokeMethod(&monitor->d_ptr->watcher, "overflowed");
+    QCOMPARE(richCoreNotifySpy.count(), 1);
+    QCOMPARE(richCoreNotifySpy.at(0).at(0).toString(), filePath);
+
+    // Events that did arrive don't report it again.
+    QTest::qWait(100);
+    QCOMPARE(richCoreNotifySpy.count(), 1);
+}
+
 void Ut_CReporterDaemonMonitor::testUIFailedToLaunch()
 {
     // Test situation, where UI is tried to launch for notification, but fails.
@@ -70,6 +70,10 @@ private slots:
     void testNewCoreFileFoundByTheSameName();
     void testDirectoryDeletedNotNotified();
     void testAutoDeleteDublicateCores();
+    void testUnresolvedStacksKeepBinaryName();
+    void testStormDuplicatesAreCapped();
+    void testUnrecordedDuplicatesAreKept();
+    void testMissedCoresAreFoundOnOverflow();
     void testUIFailedToLaunch();
 
     void cleanupTestCase();
@@ -32,6 +32,7 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
@@ -43,6 +44,7 @@ SOURCES += $$TEST_SOURCES \
            $${DAEMON_SRC_DIR}/creporterdaemon.cpp \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
            ut_creporterdaemonproxy.cpp \
 
@@ -0,0 +1,126 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QSignalSpy>
+
+#include "creporterdeviceidentity.h"
+#include "ut_creporterdeviceidentity.h"
+
+TestSsu::TestSsu()
+    : uid("ssu-uid"), queries(0)
+{
+    QDBusConnection::sessionBus().registerObject("/org/nemo/ssu", this,
+                                                 QDBusConnection::ExportAllSlots);
+    QDBusConnection::sessionBus().registerService("org.nemo.ssu");
+}
+
+TestSsu::~TestSsu()
+{
+    QDBusConnection::sessionBus().unregisterService("org.nemo.ssu");
+    QDBusConnection::sessionBus().unregisterObject("/org/nemo/ssu");
+}
+
+void TestSsu::emitRegistrationStatusChanged()
+{
+    QDBusConnection::sessionBus().send(QDBusMessage::createSignal(
+            "/org/nemo/ssu", "org.nemo.ssu", "registrationStatusChanged"));
+}
+
+QString TestSsu::deviceUid()
+{
+    queries++;
+    return uid;
+}
+
+void Ut_CReporterDeviceIdentity::init()
+{
+    m_ssu = 0;
+}
+
+void Ut_CReporterDeviceIdentity::testUidIsCached()
+{
+    m_ssu = new TestSsu;
+
+    CReporterDeviceIdentity *identity = CReporterDeviceIdentity::instance();
+    QSignalSpy resolvedSpy(identity, SIGNAL(resolved()));
+
+    QTest::qWait(100);
+    QVERIFY(identity->isResolved());
+    QCOMPARE(resolvedSpy.count(), 1);
+    QCOMPARE(identity->deviceUid(), QString("ssu-uid"));
+    QVERIFY(!identity->deviceModel().isEmpty());
+
+    // Read from the cache.
+    m_ssu->uid = "other-uid";
+    QCOMPARE(identity->deviceUid(), QString("ssu-uid"));
+    QCOMPARE(identity->deviceUid(), QString("ssu-uid"));
+    QCOMPARE(m_ssu->queries, 1);
+}
+
+void Ut_CReporterDeviceIdentity::testUidIsRefreshed()
+{
+    m_ssu = new TestSsu;
+
+    CReporterDeviceIdentity *identity = CReporterDeviceIdentity::instance();
+    QTest::qWait(100);
+    QCOMPARE(identity->deviceUid(), QString("ssu-uid"));
+
+    QSignalSpy uidChangedSpy(identity, SIGNAL(deviceUidChanged()));
+    QSignalSpy resolvedSpy(identity, SIGNAL(resolved()));
+
+    // Asked again when the device is registered.
+    m_ssu->uid = "registered-uid";
+    m_ssu->emitRegistrationStatusChanged();
+    QTest::qWait(100);
+
+    QCOMPARE(m_ssu->queries, 2);
+    QCOMPARE(uidChangedSpy.count(), 1);
+    QCOMPARE(identity->deviceUid(), QString("registered-uid"));
+    QCOMPARE(resolvedSpy.count(), 0);
+
+    // Same UID isn't a change.
+    m_ssu->emitRegistrationStatusChanged();
+    QTest::qWait(100);
+    QCOMPARE(m_ssu->queries, 3);
+    QCOMPARE(uidChangedSpy.count(), 1);
+}
+
+void Ut_CReporterDeviceIdentity::testLocalUidWithoutSsu()
+{
+    CReporterDeviceIdentity *identity = CReporterDeviceIdentity::instance();
+    QString localUid = identity->deviceUid();
+
+    // SSU not being there doesn't hold anyone waiting.
+    QTest::qWait(100);
+    QVERIFY(identity->isResolved());
+    QCOMPARE(identity->deviceUid(), localUid);
+}
+
+void Ut_CReporterDeviceIdentity::cleanup()
+{
+    CReporterDeviceIdentity::freeSingleton();
+
+    delete m_ssu;
+    m_ssu = 0;
+}
+
+QTEST_MAIN(Ut_CReporterDeviceIdentity)
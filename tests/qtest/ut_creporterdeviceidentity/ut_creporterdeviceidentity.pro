@@ -0,0 +1,27 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterdeviceidentity
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+CONFIG += link_pkgconfig
+PKGCONFIG += systemsettings
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterdeviceidentity.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/utils/creporterdeviceidentity.h \
+           ut_creporterdeviceidentity.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterdeviceidentity.cpp \
+
+include(../ut_coverage.pri)
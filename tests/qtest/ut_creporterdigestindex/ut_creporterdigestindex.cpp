@@ -0,0 +1,137 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+
+#include "ut_creporterdigestindex.h"
+#include "creporterdigestindex.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString indexFile(testDirectory + "/upload-digests");
+
+static QByteArray digest(int i)
+{
+    return QCryptographicHash::hash(QByteArray::number(i), QCryptographicHash::Sha256);
+}
+
+static QString submission(int i)
+{
+    return QString("https://crash-reports.example.com/#submissions/%1").arg(i);
+}
+
+void Ut_CReporterDigestIndex::init()
+{
+    QDir().mkpath(testDirectory);
+}
+
+void Ut_CReporterDigestIndex::testDigestIsFound()
+{
+    CReporterDigestIndex index(indexFile);
+    QCOMPARE(index.count(), 0);
+    QVERIFY(!index.containsSize(100));
+
+    QVERIFY(index.insert(digest(0), 100, submission(0)));
+    QVERIFY(index.containsSize(100));
+    QVERIFY(!index.containsSize(101));
+
+    QString url;
+    QVERIFY(index.contains(digest(0), 100, &url));
+    QCOMPARE(url, submission(0));
+
+    // Both the digest and size must match.
+    QVERIFY(!index.contains(digest(0), 101));
+    QVERIFY(!index.contains(digest(1), 100));
+
+    // Inserting the same content again doesn't add an entry.
+    QVERIFY(index.insert(digest(0), 100, submission(1)));
+    QCOMPARE(index.count(), 1);
+}
+
+void Ut_CReporterDigestIndex::testIndexSurvivesReload()
+{
+    {
+        CReporterDigestIndex index(indexFile);
+        index.insert(digest(0), 100, submission(0));
+    }
+
+    // Entries added by another process are kept when inserting.
+    CReporterDigestIndex first(indexFile);
+    CReporterDigestIndex second(indexFile);
+    QVERIFY(first.insert(digest(1), 200, submission(1)));
+    QVERIFY(second.insert(digest(2), 300, submission(2)));
+
+    CReporterDigestIndex reloaded(indexFile);
+    QCOMPARE(reloaded.count(), 3);
+    for (int i = 0; i < 3; ++i) {
+        QString url;
+        QVERIFY(reloaded.contains(digest(i), 100 * (i + 1), &url));
+        QCOMPARE(url, submission(i));
+    }
+}
+
+void Ut_CReporterDigestIndex::testOldestDigestIsDropped()
+{
+    const int Capacity = 10;
+
+    {
+        CReporterDigestIndex index(indexFile, Capacity);
+        for (int i = 0; i < 2 * Capacity; ++i) {
+            QVERIFY(index.insert(digest(i), i, submission(i)));
+        }
+        QCOMPARE(index.count(), Capacity);
+    }
+
+    CReporterDigestIndex index(indexFile, Capacity);
+    QCOMPARE(index.count(), Capacity);
+    QVERIFY(!index.contains(digest(Capacity - 1), Capacity - 1));
+    QVERIFY(index.contains(digest(Capacity), Capacity));
+    QVERIFY(index.contains(digest(2 * Capacity - 1), 2 * Capacity - 1));
+}
+
+void Ut_CReporterDigestIndex::testCorruptedIndexIsIgnored()
+{
+    {
+        CReporterDigestIndex index(indexFile);
+        index.insert(digest(0), 100, submission(0));
+        index.insert(digest(1), 200, submission(1));
+    }
+
+    QFile file(indexFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5));
+    file.close();
+
+    // Worst case is uploading a duplicate once more.
+    CReporterDigestIndex index(indexFile);
+    QCOMPARE(index.count(), 0);
+    QVERIFY(index.insert(digest(2), 300, submission(2)));
+
+    CReporterDigestIndex reloaded(indexFile);
+    QCOMPARE(reloaded.count(), 1);
+}
+
+void Ut_CReporterDigestIndex::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterDigestIndex)
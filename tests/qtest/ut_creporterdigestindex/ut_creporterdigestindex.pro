@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterdigestindex
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/httpclient \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/httpclient/creporterdigestindex.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/httpclient/creporterdigestindex.h \
+           ut_creporterdigestindex.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterdigestindex.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,135 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include "ut_creporterduplicatesummary.h"
+#include "creporterduplicatesummary.h"
+#include "creporterrichcorereader.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString summaryDirectory(testDirectory + "/duplicates");
+static const quint64 Signature = Q_UINT64_C(0x0123456789abcdef);
+
+static QString createCore(int pid)
+{
+    QString filePath(QString("%1/application-hwid-11-%2.rcore.lzo").arg(testDirectory).arg(pid));
+    QFile file(filePath);
+    file.open(QIODevice::WriteOnly);
+    return filePath;
+}
+
+static QStringList summaryLines()
+{
+    QFile file(summaryDirectory + "/0123456789abcdef.tsv");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QStringList();
+    }
+    return QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+}
+
+void Ut_CReporterDuplicateSummary::init()
+{
+    QDir().mkpath(testDirectory);
+}
+
+void Ut_CReporterDuplicateSummary::testOccurrencesAreRecorded()
+{
+    CReporterDuplicateSummary summary(testDirectory);
+
+    QVERIFY(summary.record(Signature, createCore(100)));
+    QVERIFY(summary.record(Signature, createCore(101)));
+    QVERIFY(summary.record(Signature + 1, createCore(102)));
+    QCOMPARE(summary.pendingRecords(), 3);
+
+    QStringList lines(summaryLines());
+    QCOMPARE(lines.count(), 3);
+    QCOMPARE(lines.at(0), QString("application\thwid"));
+
+    QStringList fields(lines.at(2).split('\t'));
+    QCOMPARE(fields.count(), 4);
+    QVERIFY(qAbs(fields.at(0).toLongLong() - QDateTime::currentMSecsSinceEpoch() / 1000) < 60);
+    QCOMPARE(fields.at(1), QString("101"));
+    QVERIFY(fields.at(2).toLongLong() > 0);
+    QCOMPARE(fields.at(3), QString("11"));
+}
+
+void Ut_CReporterDuplicateSummary::testOldRecordsAreDropped()
+{
+    CReporterDuplicateSummary summary(testDirectory);
+    summary.setMaxRecords(4);
+
+    for (int pid = 1; pid <= 10; ++pid) {
+        QVERIFY(summary.record(Signature, createCore(pid)));
+    }
+
+    QStringList lines(summaryLines());
+    QVERIFY(lines.count() - 1 <= 5);
+    QCOMPARE(summary.pendingRecords(), lines.count() - 1);
+    QCOMPARE(lines.last().section('\t', 1, 1), QString("10"));
+    QCOMPARE(lines.at(1).section('\t', 1, 1), QString::number(11 - (lines.count() - 1)));
+}
+
+void Ut_CReporterDuplicateSummary::testRecordsSurviveRestart()
+{
+    {
+        CReporterDuplicateSummary summary(testDirectory);
+        summary.record(Signature, createCore(100));
+        summary.record(Signature + 1, createCore(101));
+    }
+
+    CReporterDuplicateSummary summary(testDirectory);
+    QCOMPARE(summary.pendingRecords(), 2);
+}
+
+void Ut_CReporterDuplicateSummary::testSummaryIsPublished()
+{
+    CReporterDuplicateSummary summary(testDirectory);
+    QVERIFY(summary.publish().isEmpty());
+
+    summary.record(Signature, createCore(100));
+    summary.record(Signature, createCore(101));
+
+    QString reportPath(summary.publish());
+    QVERIFY(reportPath.startsWith(testDirectory + "/DuplicateSummary-hwid-0-"));
+    QVERIFY(reportPath.endsWith(".rcore.lzo"));
+    QVERIFY(QFile::exists(reportPath));
+    QCOMPARE(summary.pendingRecords(), 0);
+    QVERIFY(QDir(summaryDirectory).entryList(QDir::Files).isEmpty());
+
+    CReporterRichCoreReader reader(reportPath);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("duplicates 0123456789abcdef"));
+
+    QByteArray contents(reader.readSection());
+    QVERIFY(contents.startsWith("application: application\ncount: 2\ntime\tpid\tuptime\tsignal\n"));
+    QVERIFY(!reader.nextSection());
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void Ut_CReporterDuplicateSummary::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterDuplicateSummary)
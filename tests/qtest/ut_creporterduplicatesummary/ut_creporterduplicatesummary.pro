@@ -0,0 +1,25 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterduplicatesummary
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creporterduplicatesummary.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/coredir/creporterduplicatesummary.h \
+           ut_creporterduplicatesummary.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterduplicatesummary.cpp \
+
+include(../ut_coverage.pri)
@@ -16,6 +16,9 @@ INCLUDEPATH += .  \
 
 DEPENDPATH += $$INCLUDEPATH 
 
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
 TEST_STUBS += $${CREPORTER_STUBS_DIR}/qnetworkreply.cpp \
               $${CREPORTER_STUBS_DIR}/qnetworkaccessmanager.cpp \
 
@@ -24,6 +27,7 @@ TEST_SOURCES += $${CLIENT_SRC_DIR}/creporterhttpclient.cpp \
 
 HEADERS +=  $${CLIENT_SRC_DIR}/creporterhttpclient.h \
             $${CLIENT_SRC_DIR}/creporterhttpclient_p.h \
+            $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.h \
             $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
             $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
             $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
@@ -36,6 +40,7 @@ SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.cpp \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
            ut_creporterhttpclient.cpp \
 
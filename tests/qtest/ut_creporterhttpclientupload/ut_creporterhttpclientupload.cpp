@@ -0,0 +1,559 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "ut_creporterhttpclientupload.h"
+#include "creporterapplicationsettings.h"
+#include "creporterconnectionpool.h"
+#include "creportercoreregistry.h"
+#include "creporterhttpclient.h"
+
+// Upload must not grow peak memory usage by more than this.
+static const qint64 MemoryCeiling = 16 * 1024 * 1024;
+static const qint64 UploadSize = 8 * MemoryCeiling;
+
+static const int ChunkSize = 64 * 1024;
+
+// Bodies up to this size are kept for inspection.
+static const qint64 MaxKeptBody = 64 * 1024;
+
+static QByteArray headerValue(const QByteArray &header, const QByteArray &name)
+{
+    int start = header.indexOf("\r\n" + name + ":");
+    if (start == -1) {
+        return QByteArray();
+    }
+    start += name.length() + 3;
+    return header.mid(start, header.indexOf("\r\n", start) - start).trimmed();
+}
+
+static void setUploadRate(int rate)
+{
+    // Whichever network the test runs on.
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+    settings->setWlanUploadRate(rate);
+    settings->setEthernetUploadRate(rate);
+    settings->setMobileUploadRate(rate);
+    settings->setUsbUploadRate(rate);
+}
+
+// Returns peak resident set size of the process in bytes.
+static qint64 peakRss()
+{
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    foreach (const QByteArray &line, status.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+
+    return -1;
+}
+
+void Ut_CReporterHttpClientUpload::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+
+    // Keep the settings written below away from the real configuration,
+    // and the upload log and digest index away from the real core directory.
+    qputenv("XDG_CONFIG_HOME", QFile::encodeName(tempDir.path()));
+    qputenv("HOME", QFile::encodeName(tempDir.path()));
+    QVERIFY(QDir(tempDir.path()).mkpath("crash-reporter-tests/home/user/MyDocs/core-dumps"));
+    QCOMPARE(CReporterCoreRegistry::instance()->getCoreLocationPaths().count(), 1);
+
+    server = new QTcpServer(this);
+    connect(server, SIGNAL(newConnection()), this, SLOT(handleNewConnection()));
+    QVERIFY(server->listen(QHostAddress::LocalHost));
+
+    CReporterApplicationSettings *settings = CReporterApplicationSettings::instance();
+    settings->setServerUrl("http://127.0.0.1");
+    settings->setServerPort(server->serverPort());
+    settings->setUseSsl(false);
+    settings->setUseProxy(false);
+    settings->setResumableUploads(false);
+    setUploadRate(0);
+
+    failingChunk = -1;
+    totalBodySize = 0;
+    serverBusy = false;
+}
+
+void Ut_CReporterHttpClientUpload::testLargeUploadIsStreamed()
+{
+    // Sparse file, so creating it doesn't take any time or disk space.
+    QFile file(tempDir.path() + "/application-somehwid-11-1234.rcore.lzo");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.resize(UploadSize));
+    file.close();
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+    QSignalSpy errorSpy(&client, SIGNAL(uploadError(QString, QString)));
+
+    qint64 rssBefore = peakRss();
+    QVERIFY(rssBefore > 0);
+
+    client.initSession(false);
+    QVERIFY(client.upload(file.fileName()));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 60000);
+
+    QCOMPARE(errorSpy.count(), 0);
+    QCOMPARE(lastBodySize, UploadSize);
+
+    qint64 growth = peakRss() - rssBefore;
+    QVERIFY2(growth < MemoryCeiling, qPrintable(QString::number(growth)));
+}
+
+void Ut_CReporterHttpClientUpload::testConnectionIsReused()
+{
+    connections = 0;
+    requests = 0;
+    int poolRequests = CReporterConnectionPool::instance()->requestCount();
+
+    for (int i = 0; i < 3; ++i) {
+        QFile file(tempDir.path() + QString("/application-somehwid-11-%1.rcore.lzo").arg(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        // Distinct content, identical reports wouldn't be uploaded again.
+        file.write("small report " + QByteArray::number(i));
+        file.close();
+
+        // Every upload item creates its own client.
+        CReporterHttpClient client;
+        QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+
+        client.initSession(false);
+        QVERIFY(client.upload(file.fileName()));
+        QTRY_COMPARE(finishedSpy.count(), 1);
+    }
+
+    QCOMPARE(requests, 3);
+    // The connection left open by the previous test case may be used as well.
+    QVERIFY(connections <= 1);
+    QCOMPARE(CReporterConnectionPool::instance()->requestCount(), poolRequests + 3);
+}
+
+void Ut_CReporterHttpClientUpload::testInterruptedUploadIsResumed()
+{
+    CReporterApplicationSettings::instance()->setResumableUploads(true);
+    CReporterApplicationSettings::instance()->setUploadChunkSize(ChunkSize);
+
+    QByteArray content;
+    for (int i = 0; content.size() < 10 * ChunkSize + 100; ++i) {
+        content += QByteArray::number(i);
+    }
+
+    QString fileName("application-somehwid-11-5678.rcore.lzo");
+    QFile file(tempDir.path() + '/' + fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+    file.close();
+
+    QString offsetFile(tempDir.path() + "/." + fileName + ".upload");
+
+    storedSize = 0;
+    chunks = 0;
+    offsetQueries = 0;
+    totalBodySize = 0;
+    // Server fails while receiving the third chunk.
+    failingChunk = 3;
+
+    {
+        CReporterHttpClient client;
+        QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+        QSignalSpy errorSpy(&client, SIGNAL(uploadError(QString, QString)));
+
+        client.initSession(false);
+        QVERIFY(client.upload(file.fileName()));
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QCOMPARE(errorSpy.count(), 1);
+    }
+
+    QCOMPARE(storedSize, qint64(2 * ChunkSize));
+    QVERIFY(QFile::exists(offsetFile));
+
+    // New client, as after restart of the uploader, continues from the offset.
+    {
+        CReporterHttpClient client;
+        QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+        QSignalSpy errorSpy(&client, SIGNAL(uploadError(QString, QString)));
+
+        client.initSession(false);
+        QVERIFY(client.upload(file.fileName()));
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QCOMPARE(errorSpy.count(), 0);
+    }
+
+    QCOMPARE(offsetQueries, 1);
+    QCOMPARE(storedSize, qint64(content.size()));
+    // Only the failed chunk was sent twice.
+    QCOMPARE(totalBodySize, qint64(content.size() + ChunkSize));
+    QVERIFY(!QFile::exists(offsetFile));
+
+    CReporterApplicationSettings::instance()->setResumableUploads(false);
+}
+
+void Ut_CReporterHttpClientUpload::testRetryAfterIsReported()
+{
+    QFile file(tempDir.path() + "/application-somehwid-11-4321.rcore.lzo");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("small report");
+    file.close();
+
+    serverBusy = true;
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+    QSignalSpy errorSpy(&client, SIGNAL(uploadError(QString, QString)));
+
+    client.initSession(false);
+    QCOMPARE(client.retryAfter(), -1);
+    QVERIFY(client.upload(file.fileName()));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+
+    QCOMPARE(errorSpy.count(), 1);
+    QCOMPARE(client.retryAfter(), 120);
+
+    serverBusy = false;
+}
+
+void Ut_CReporterHttpClientUpload::testUploadIsRateLimited()
+{
+    const int Rate = 256;
+    setUploadRate(Rate);
+
+    QFile file(tempDir.path() + "/application-somehwid-11-8765.rcore.lzo");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.resize(3 * Rate * 1024));
+    file.close();
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+    QSignalSpy throughputSpy(&client, SIGNAL(updateThroughput(qint64)));
+
+    QElapsedTimer timer;
+    timer.start();
+    client.initSession(false);
+    QVERIFY(client.upload(file.fileName()));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+
+    // Initial burst is a quarter of a second's worth.
+    QVERIFY2(timer.elapsed() >= 2500, qPrintable(QString::number(timer.elapsed())));
+    QCOMPARE(lastBodySize, file.size());
+
+    QVERIFY(throughputSpy.count() >= 2);
+    for (int i = 0; i < throughputSpy.count(); ++i) {
+        qint64 throughput = throughputSpy.at(i).at(0).toLongLong();
+        QVERIFY2(throughput <= 2 * Rate * 1024, qPrintable(QString::number(throughput)));
+    }
+
+    setUploadRate(0);
+}
+
+void Ut_CReporterHttpClientUpload::testBatchUpload()
+{
+    QStringList files;
+    for (int i = 0; i < 3; ++i) {
+        // Stand-in server rejects the file with "rejected" in its name.
+        QString name(i == 1 ? "/rejected-somehwid-11-%1.rcore.lzo"
+                            : "/application-somehwid-11-%1.rcore.lzo");
+        QFile file(tempDir.path() + name.arg(100 + i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("batched report " + QByteArray::number(i));
+        file.close();
+        files << file.fileName();
+    }
+
+    requests = 0;
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+    QSignalSpy errorSpy(&client, SIGNAL(uploadError(QString, QString)));
+    QSignalSpy fileSpy(&client, SIGNAL(fileFinished(QString, bool, QString)));
+
+    client.initSession(false);
+    QVERIFY(client.uploadBatch(files));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+
+    // All files in one request.
+    QCOMPARE(requests, 1);
+    QCOMPARE(errorSpy.count(), 0);
+    QVERIFY(lastRequestHeader.startsWith("POST "));
+    QVERIFY(headerValue(lastRequestHeader, "Content-Type").startsWith("multipart/form-data"));
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(requestBody.contains("batched report " + QByteArray::number(i)));
+    }
+
+    QCOMPARE(fileSpy.count(), 3);
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(fileSpy.at(i).at(0).toString(), files.at(i));
+        QCOMPARE(fileSpy.at(i).at(1).toBool(), i != 1);
+    }
+    QCOMPARE(fileSpy.at(1).at(2).toString(), QString("Rejected"));
+
+    // Files were digested while sent, so the same content isn't sent again.
+    QFile copy(tempDir.path() + "/application-somehwid-11-200.rcore.lzo");
+    QVERIFY(QFile::copy(files.at(0), copy.fileName()));
+
+    client.initSession(false);
+    fileSpy.clear();
+    QVERIFY(client.uploadBatch(QStringList() << copy.fileName()));
+    QTRY_COMPARE(finishedSpy.count(), 2);
+
+    QCOMPARE(requests, 1);
+    QCOMPARE(fileSpy.count(), 1);
+    QVERIFY(fileSpy.at(0).at(1).toBool());
+}
+
+void Ut_CReporterHttpClientUpload::testBatchSameNamedFiles()
+{
+    // Same file name in different core directories.
+    QStringList files;
+    QStringList contents;
+    contents << "rejected report" << "accepted report";
+    for (int i = 0; i < 2; ++i) {
+        QDir dir(tempDir.path());
+        QString subdir(QString("dir%1").arg(i));
+        QVERIFY(dir.mkpath(subdir));
+        QFile file(dir.filePath(subdir + "/application-somehwid-11-400.rcore.lzo"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents.at(i).toLatin1());
+        file.close();
+        files << file.fileName();
+    }
+
+    requests = 0;
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+    QSignalSpy fileSpy(&client, SIGNAL(fileFinished(QString, bool, QString)));
+
+    client.initSession(false);
+    QVERIFY(client.uploadBatch(files));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+
+    // Each file gets the result of its own part.
+    QCOMPARE(requests, 1);
+    QCOMPARE(fileSpy.count(), 2);
+    QCOMPARE(fileSpy.at(0).at(0).toString(), files.at(0));
+    QCOMPARE(fileSpy.at(0).at(1).toBool(), false);
+    QCOMPARE(fileSpy.at(0).at(2).toString(), QString("Rejected"));
+    QCOMPARE(fileSpy.at(1).at(0).toString(), files.at(1));
+    QCOMPARE(fileSpy.at(1).at(1).toBool(), true);
+}
+
+void Ut_CReporterHttpClientUpload::testBatchUploadIsRateLimited()
+{
+    const int Rate = 256;
+    setUploadRate(Rate);
+
+    QStringList files;
+    for (int i = 0; i < 3; ++i) {
+        QFile file(tempDir.path() + QString("/application-somehwid-11-%1.rcore.lzo").arg(300 + i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.resize(Rate * 1024));
+        file.close();
+        files << file.fileName();
+    }
+
+    CReporterHttpClient client;
+    QSignalSpy finishedSpy(&client, SIGNAL(finished()));
+
+    QElapsedTimer timer;
+    timer.start();
+    client.initSession(false);
+    QVERIFY(client.uploadBatch(files));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+
+    // Same limit as for single uploads, see testUploadIsRateLimited().
+    QVERIFY2(timer.elapsed() >= 2500, qPrintable(QString::number(timer.elapsed())));
+    QVERIFY(lastBodySize > 3 * Rate * 1024);
+
+    setUploadRate(0);
+}
+
+void Ut_CReporterHttpClientUpload::cleanupTestCase()
+{
+    CReporterApplicationSettings::freeSingleton();
+    CReporterConnectionPool::freeSingleton();
+}
+
+void Ut_CReporterHttpClientUpload::handleNewConnection()
+{
+    QTcpSocket *socket = server->nextPendingConnection();
+    connect(socket, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
+
+    connections++;
+    requestHeader.clear();
+    requestBody.clear();
+    contentLength = -1;
+    bodyReceived = 0;
+}
+
+void Ut_CReporterHttpClientUpload::handleReadyRead()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+
+    forever {
+        while (contentLength < 0 && socket->canReadLine()) {
+            QByteArray line = socket->readLine();
+            if (line == "\r\n") {
+                int start = requestHeader.indexOf("Content-Length:");
+                if (start == -1) {
+                    socket->write("HTTP/1.1 411 Length Required\r\nContent-Length: 0\r\n\r\n");
+                    return;
+                }
+                int end = requestHeader.indexOf("\r\n", start);
+                contentLength = requestHeader.mid(start + 15, end - start - 15).trimmed().toLongLong();
+            } else {
+                if (requestHeader.isEmpty()) {
+                    requestBody.clear();
+                }
+                requestHeader += line;
+            }
+        }
+
+        if (contentLength < 0) {
+            return;
+        }
+
+        // Discard the body, only its size matters.
+        char buffer[64 * 1024];
+        qint64 length;
+        while (bodyReceived < contentLength
+                && (length = socket->read(buffer, qMin(qint64(sizeof(buffer)),
+                                                       contentLength - bodyReceived))) > 0) {
+            bodyReceived += length;
+            if (contentLength <= MaxKeptBody) {
+                requestBody.append(buffer, length);
+            }
+        }
+
+        if (bodyReceived < contentLength) {
+            return;
+        }
+
+        // Keep the connection open for the next request.
+        requests++;
+        lastBodySize = bodyReceived;
+        totalBodySize += bodyReceived;
+        if (requestHeader.startsWith("POST ")) {
+            respondToBatch(socket);
+        } else {
+            respond(socket);
+        }
+        lastRequestHeader = requestHeader;
+        requestHeader.clear();
+        contentLength = -1;
+        bodyReceived = 0;
+    }
+}
+
+void Ut_CReporterHttpClientUpload::respond(QTcpSocket *socket)
+{
+    static const QByteArray Ok("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+
+    if (serverBusy) {
+        socket->write("HTTP/1.1 503 Service Unavailable\r\nRetry-After: 120\r\n"
+                      "Content-Length: 0\r\n\r\n");
+        return;
+    }
+
+    QByteArray contentRange = headerValue(requestHeader, "Content-Range");
+    if (contentRange.isEmpty()) {
+        socket->write(Ok);
+        return;
+    }
+
+    // Content-Range: bytes <first>-<last>/<total> or bytes */<total>
+    QByteArray range = contentRange.mid(6, contentRange.indexOf('/') - 6);
+    qint64 total = contentRange.mid(contentRange.indexOf('/') + 1).toLongLong();
+
+    if (range == "*") {
+        offsetQueries++;
+    } else {
+        chunks++;
+        if (chunks == failingChunk) {
+            socket->write("HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n");
+            return;
+        }
+        if (range.left(range.indexOf('-')).toLongLong() != storedSize) {
+            socket->write("HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n\r\n");
+            return;
+        }
+        storedSize += bodyReceived;
+    }
+
+    if (storedSize == total) {
+        socket->write(Ok);
+    } else if (storedSize == 0) {
+        socket->write("HTTP/1.1 308 Resume Incomplete\r\nContent-Length: 0\r\n\r\n");
+    } else {
+        socket->write("HTTP/1.1 308 Resume Incomplete\r\nContent-Length: 0\r\nRange: bytes=0-"
+                      + QByteArray::number(storedSize - 1) + "\r\n\r\n");
+    }
+}
+
+void Ut_CReporterHttpClientUpload::respondToBatch(QTcpSocket *socket)
+{
+    // Reply with the result of each part, by its part name.
+    QJsonArray results;
+    int id = 1000;
+    int start = 0;
+    while ((start = requestBody.indexOf("form-data; name=\"", start)) != -1) {
+        start += 17;
+        int end = requestBody.indexOf('"', start);
+        QString name(QString::fromUtf8(requestBody.mid(start, end - start)));
+        start = requestBody.indexOf("filename=\"", end) + 10;
+        end = requestBody.indexOf('"', start);
+        QString fileName(QString::fromUtf8(requestBody.mid(start, end - start)));
+        start = requestBody.indexOf("\r\n\r\n", end) + 4;
+
+        QJsonObject result;
+        result.insert("name", name);
+        if (fileName.startsWith("rejected") || requestBody.mid(start).startsWith("rejected")) {
+            result.insert("error", QString("Rejected"));
+        } else {
+            result.insert("submission_id", id++);
+        }
+        results.append(result);
+    }
+
+    QJsonObject json;
+    json.insert("files", results);
+    QByteArray body(QJsonDocument(json).toJson(QJsonDocument::Compact));
+
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+                  + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+}
+
+QTEST_MAIN(Ut_CReporterHttpClientUpload)
@@ -0,0 +1,79 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERHTTPCLIENTUPLOAD_H
+#define UT_CREPORTERHTTPCLIENTUPLOAD_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class QTcpServer;
+class QTcpSocket;
+
+/*
+ * Uploads a large file to a local HTTP server using the real
+ * QNetworkAccessManager and checks that the file isn't buffered in memory.
+ */
+class Ut_CReporterHttpClientUpload : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testLargeUploadIsStreamed();
+    void testConnectionIsReused();
+    void testInterruptedUploadIsResumed();
+    void testRetryAfterIsReported();
+    void testUploadIsRateLimited();
+    void testBatchUpload();
+    void testBatchSameNamedFiles();
+    void testBatchUploadIsRateLimited();
+    void cleanupTestCase();
+
+    void handleNewConnection();
+    void handleReadyRead();
+
+private:
+    void respond(QTcpSocket *socket);
+    void respondToBatch(QTcpSocket *socket);
+
+    QTemporaryDir tempDir;
+    QTcpServer *server;
+    int connections;
+    int requests;
+    QByteArray requestHeader;
+    QByteArray lastRequestHeader;
+    qint64 contentLength;
+    qint64 bodyReceived;
+    qint64 lastBodySize;
+    qint64 totalBodySize;
+    // Body of the last request, if it was small.
+    QByteArray requestBody;
+    // Server rejects requests with Retry-After header.
+    bool serverBusy;
+
+    // Emulated resumable upload state of the server.
+    qint64 storedSize;
+    int chunks;
+    int failingChunk;
+    int offsetQueries;
+};
+
+#endif // UT_CREPORTERHTTPCLIENTUPLOAD_H
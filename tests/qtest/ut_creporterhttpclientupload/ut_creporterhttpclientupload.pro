@@ -0,0 +1,63 @@
+include(../ut_common_top.pri)
+
+CLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
+
+QT += network
+QT -= gui
+
+TARGET = ut_creporterhttpclientupload
+
+# Real QtNetwork is needed here, so the stubs directory isn't searched first.
+INCLUDEPATH -= $$CREPORTER_STUBS_DIR
+INCLUDEPATH += . \
+               $${CLIENT_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/coredir \
+               $${CREPORTER_SRC_DIR}/libs/settings \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+TEST_SOURCES += $${CLIENT_SRC_DIR}/creporterhttpclient.cpp \
+                $${CLIENT_SRC_DIR}/creporterconnectionpool.cpp \
+                $${CLIENT_SRC_DIR}/creportertokenbucket.cpp \
+
+HEADERS += $${CLIENT_SRC_DIR}/creporterhttpclient.h \
+           $${CLIENT_SRC_DIR}/creporterhttpclient_p.h \
+           $${CLIENT_SRC_DIR}/creporterconnectionpool.h \
+           $${CLIENT_SRC_DIR}/creporterdigestindex.h \
+           $${CLIENT_SRC_DIR}/creportertokenbucket.h \
+           $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.h \
+           ut_creporterhttpclientupload.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           $${CLIENT_SRC_DIR}/creporterdigestindex.cpp \
+           $${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreindex.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.cpp \
+           ut_creporterhttpclientupload.cpp \
+
+include(../ut_coverage.pri)
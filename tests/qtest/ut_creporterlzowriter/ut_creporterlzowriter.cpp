@@ -0,0 +1,156 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+
+#include "ut_creporterlzowriter.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString testFile(testDirectory + "/test.rcore.lzo");
+
+static QByteArray lzopDecompress(const QString &filePath)
+{
+    QProcess lzop;
+    lzop.start("/usr/bin/lzop", QStringList() << "-d" << "-c" << filePath);
+    if (!lzop.waitForFinished() || lzop.exitStatus() != QProcess::NormalExit
+            || lzop.exitCode() != 0) {
+        return QByteArray("lzop failed: ") + lzop.readAllStandardError();
+    }
+    return lzop.readAllStandardOutput();
+}
+
+void Ut_CReporterLzoWriter::init()
+{
+    QDir().mkpath(testDirectory);
+}
+
+void Ut_CReporterLzoWriter::testLzopReadsStream_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray text;
+    while (text.size() < 600 * 1024) {
+        text += "\n[---rich-core: note---]\nUser comment that compresses well.\n";
+    }
+
+    // Doesn't compress, so blocks are stored.
+    QByteArray random;
+    qsrand(2260);
+    while (random.size() < 300 * 1024) {
+        random += char(qrand());
+    }
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("short") << QByteArray("\n[---rich-core: note---]\nHello\n");
+    QTest::newRow("several blocks") << text;
+    QTest::newRow("incompressible") << random;
+}
+
+void Ut_CReporterLzoWriter::testLzopReadsStream()
+{
+    QFETCH(QByteArray, data);
+
+    // The reference decompressor is a dependency of the tests.
+    QVERIFY2(QFile::exists("/usr/bin/lzop"), "lzop is not installed");
+
+    CReporterLzoWriter writer(testFile);
+    QVERIFY(writer.open());
+    // Odd sized writes end up in the same blocks.
+    for (int i = 0; i < data.size(); i += 100003) {
+        QVERIFY(writer.write(data.mid(i, 100003)));
+    }
+    QVERIFY(writer.finish());
+    QVERIFY(writer.errorString().isEmpty());
+
+    QCOMPARE(lzopDecompress(testFile), data);
+}
+
+void Ut_CReporterLzoWriter::testStreamsAreAppended()
+{
+    QVERIFY(CReporterLzoWriter::append("\n[---rich-core: first---]\none\n", testFile));
+    QVERIFY(CReporterLzoWriter::append("\n[---rich-core: second---]\ntwo\n", testFile));
+
+    CReporterRichCoreReader reader(testFile);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("first"));
+    QCOMPARE(reader.readSection(), QByteArray("one\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("second"));
+    QCOMPARE(reader.readSection(), QByteArray("two\n"));
+    QVERIFY(!reader.nextSection());
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void Ut_CReporterLzoWriter::testStoredBlocks()
+{
+    QByteArray data(300 * 1024, 'x');
+
+    CReporterLzoWriter writer(testFile);
+    QVERIFY(writer.open());
+    writer.setStored(true);
+    QVERIFY(writer.write("\n[---rich-core: stored---]\n"));
+    QVERIFY(writer.write(data));
+    QVERIFY(writer.finish());
+
+    QVERIFY(QFileInfo(testFile).size() > data.size());
+
+    CReporterRichCoreReader reader(testFile);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("stored"));
+    QCOMPARE(reader.readSection(), data);
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void Ut_CReporterLzoWriter::testUnfinishedStreamIsDropped()
+{
+    QVERIFY(CReporterLzoWriter::append("\n[---rich-core: first---]\none\n", testFile));
+    qint64 size = QFileInfo(testFile).size();
+
+    {
+        CReporterLzoWriter writer(testFile);
+        QVERIFY(writer.open());
+        QVERIFY(writer.write(QByteArray(512 * 1024, 'x')));
+    }
+
+    QCOMPARE(QFileInfo(testFile).size(), size);
+}
+
+void Ut_CReporterLzoWriter::testOpenFails()
+{
+    CReporterLzoWriter writer(testDirectory + "/missing/test.rcore.lzo");
+    QVERIFY(!writer.open());
+    QVERIFY(!writer.errorString().isEmpty());
+    QVERIFY(!writer.write("text"));
+    QVERIFY(!writer.finish());
+}
+
+void Ut_CReporterLzoWriter::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterLzoWriter)
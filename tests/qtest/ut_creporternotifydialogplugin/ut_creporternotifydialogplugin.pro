@@ -34,6 +34,8 @@ HEADERS += $${PLUGIN_SRC_DIR}/creporternotifydialogplugin.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit_p.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.h \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver_p.h \
            $${CREPORTER_SRC_DIR}/libs/infobanner/creporterinfobanner.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
            ut_creporternotifydialogplugin.h \
@@ -45,6 +47,7 @@ SOURCES += $$TEST_SOURCES \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterprivacysettingsmodel.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
+           $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.cpp \
            ut_creporternotifydialogplugin.cpp \
 
 include(../ut_coverage.pri)
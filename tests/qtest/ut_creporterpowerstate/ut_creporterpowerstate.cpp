@@ -0,0 +1,190 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDir>
+#include <QSignalSpy>
+
+#include <mce/dbus-names.h>
+#include <mce/mode-names.h>
+
+#include "creporterpowerstate.h"
+#include "creporterprivacysettingsmodel.h"
+#include "creportersettingsinit_p.h"
+#include "ut_creporterpowerstate.h"
+
+const QString systemSettingsPath("/tmp/crash-reporter-powerstate-tests/system");
+const QString userSettingsPath("/tmp/crash-reporter-powerstate-tests/user");
+const QString settingsFile(userSettingsPath + "/crash-reporter-settings/crash-reporter-privacy.conf");
+
+const QString restrictWhenLowBattery("Settings/restrict-when-low-battery");
+const QString restrictWhenDischarging("Settings/restrict-when-discharging");
+const QString dischargingThreshold("Settings/discharging-threshold");
+
+TestMce::TestMce()
+    : batteryStatus(MCE_BATTERY_STATUS_OK), batteryLevel(80),
+      chargerState(MCE_CHARGER_STATE_OFF), queries(0)
+{
+    QDBusConnection::sessionBus().registerObject(MCE_REQUEST_PATH, this,
+                                                 QDBusConnection::ExportAllSlots);
+    QDBusConnection::sessionBus().registerService(MCE_SERVICE);
+}
+
+TestMce::~TestMce()
+{
+    QDBusConnection::sessionBus().unregisterService(MCE_SERVICE);
+    QDBusConnection::sessionBus().unregisterObject(MCE_REQUEST_PATH);
+}
+
+void TestMce::emitChange(const char *signal, const QVariant &value)
+{
+    QDBusMessage message = QDBusMessage::createSignal(MCE_SIGNAL_PATH, MCE_SIGNAL_IF, signal);
+    message << value;
+    QDBusConnection::sessionBus().send(message);
+}
+
+QString TestMce::get_battery_status()
+{
+    queries++;
+    return batteryStatus;
+}
+
+int TestMce::get_battery_level()
+{
+    queries++;
+    return batteryLevel;
+}
+
+QString TestMce::get_charger_state()
+{
+    queries++;
+    return chargerState;
+}
+
+void Ut_CReporterPowerState::initTestCase()
+{
+    QDir dir;
+    dir.mkpath(systemSettingsPath);
+    dir.mkpath(userSettingsPath + "/crash-reporter-settings");
+
+    creporterSettingsInit(systemSettingsPath, userSettingsPath);
+}
+
+void Ut_CReporterPowerState::init()
+{
+    m_settings = new QSettings(settingsFile, QSettings::NativeFormat);
+    m_settings->setValue(restrictWhenLowBattery, true);
+    m_settings->setValue(restrictWhenDischarging, true);
+    m_settings->setValue(dischargingThreshold, 20);
+    m_settings->sync();
+
+    m_mce = new TestMce;
+}
+
+void Ut_CReporterPowerState::testInitialStateIsWaitedFor()
+{
+    m_mce->batteryLevel = 10;
+
+    // Asked right away, before the event loop has run.
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+    QCOMPARE(m_mce->queries, 3);
+
+    // The state is kept, MCE isn't asked again.
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+    QCOMPARE(m_mce->queries, 3);
+}
+
+void Ut_CReporterPowerState::testSignalsUpdateState()
+{
+    QVERIFY(!CReporterPowerState::instance()->shouldSavePower());
+
+    m_mce->emitChange(MCE_BATTERY_LEVEL_SIG, 10);
+    QTest::qWait(100);
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+
+    // Charging isn't restricted while the battery is fine.
+    m_mce->emitChange(MCE_CHARGER_STATE_SIG, QString(MCE_CHARGER_STATE_ON));
+    QTest::qWait(100);
+    QVERIFY(!CReporterPowerState::instance()->shouldSavePower());
+
+    m_mce->emitChange(MCE_BATTERY_STATUS_SIG, QString(MCE_BATTERY_STATUS_LOW));
+    QTest::qWait(100);
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+
+    QCOMPARE(m_mce->queries, 3);
+}
+
+void Ut_CReporterPowerState::testRestrictionLifted()
+{
+    m_mce->batteryLevel = 10;
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+
+    QSignalSpy liftedSpy(CReporterPowerState::instance(), SIGNAL(restrictionLifted()));
+
+    // Still restricted.
+    m_mce->emitChange(MCE_BATTERY_LEVEL_SIG, 15);
+    QTest::qWait(100);
+    QCOMPARE(liftedSpy.count(), 0);
+
+    m_mce->emitChange(MCE_CHARGER_STATE_SIG, QString(MCE_CHARGER_STATE_ON));
+    QTest::qWait(100);
+    QCOMPARE(liftedSpy.count(), 1);
+
+    // Sent only when the restriction ends.
+    m_mce->emitChange(MCE_BATTERY_LEVEL_SIG, 16);
+    QTest::qWait(100);
+    QCOMPARE(liftedSpy.count(), 1);
+}
+
+void Ut_CReporterPowerState::testSettingsChangedElsewhere()
+{
+    m_mce->batteryLevel = 10;
+    QVERIFY(CReporterPowerState::instance()->shouldSavePower());
+
+    QSignalSpy liftedSpy(CReporterPowerState::instance(), SIGNAL(restrictionLifted()));
+
+    // As if written by the settings UI.
+    m_settings->setValue(restrictWhenDischarging, false);
+    m_settings->sync();
+
+    QTest::qWait(500);
+    QCOMPARE(liftedSpy.count(), 1);
+    QVERIFY(!CReporterPowerState::instance()->shouldSavePower());
+}
+
+void Ut_CReporterPowerState::cleanupTestCase()
+{
+    CReporterPrivacySettingsModel::instance()->freeSingleton();
+    QDir("/tmp/crash-reporter-powerstate-tests").removeRecursively();
+}
+
+void Ut_CReporterPowerState::cleanup()
+{
+    CReporterPowerState::freeSingleton();
+
+    delete m_mce;
+    m_mce = 0;
+
+    delete m_settings;
+    m_settings = 0;
+}
+
+QTEST_MAIN(Ut_CReporterPowerState)
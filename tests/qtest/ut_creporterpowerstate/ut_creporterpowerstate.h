@@ -0,0 +1,72 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERPOWERSTATE_H
+#define UT_CREPORTERPOWERSTATE_H
+
+#include <QSettings>
+#include <QTest>
+#include <QVariant>
+
+class TestMce : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.nokia.mce.request")
+public:
+    TestMce();
+
+    ~TestMce();
+
+    void emitChange(const char *signal, const QVariant &value);
+
+public Q_SLOTS:
+    QString get_battery_status();
+    int get_battery_level();
+    QString get_charger_state();
+
+public:
+    QString batteryStatus;
+    int batteryLevel;
+    QString chargerState;
+    int queries;
+};
+
+class Ut_CReporterPowerState : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testInitialStateIsWaitedFor();
+    void testSignalsUpdateState();
+    void testRestrictionLifted();
+    void testSettingsChangedElsewhere();
+
+    void cleanupTestCase();
+    void cleanup();
+
+private:
+    TestMce *m_mce;
+    QSettings *m_settings;
+};
+
+#endif // UT_CREPORTERPOWERSTATE_H
@@ -0,0 +1,54 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterpowerstate
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/settings \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2 \
+             mce \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterpowerstate.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/utils/creporterpowerstate.h \
+           $$CREPORTER_SRC_DIR/libs/autouploader_interface.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoreindex.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creporterprivacysettingsmodel.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsbase.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsbase_p.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsinit_p.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsobserver.h \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsobserver_p.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creportercrashinfo.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterlzowriter.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterutils.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporteruploadnotifier.h \
+           ut_creporterpowerstate.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           $$CREPORTER_SRC_DIR/libs/autouploader_interface.cpp \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.cpp \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoreindex.cpp \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.cpp \
+           $$CREPORTER_SRC_DIR/libs/settings/creporterprivacysettingsmodel.cpp \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsbase.cpp \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsinit.cpp \
+           $$CREPORTER_SRC_DIR/libs/settings/creportersettingsobserver.cpp \
+           $$CREPORTER_SRC_DIR/libs/utils/creportercrashinfo.cpp \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterlzowriter.cpp \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterutils.cpp \
+           $$CREPORTER_SRC_DIR/libs/utils/creporteruploadnotifier.cpp \
+           ut_creporterpowerstate.cpp \
+
+include(../ut_coverage.pri)
@@ -12,18 +12,27 @@ INCLUDEPATH += \
 	$$CREPORTER_SRC_DIR/libs/serviceif \
 	$$CREPORTER_SRC_DIR/libs/utils \
 
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
 TEST_SOURCES += $${SETTINGS_SRC_DIR}/creporterprivacysettingsmodel.cpp \
                 $${SETTINGS_SRC_DIR}/creportersettingsbase.cpp \
                 $${SETTINGS_SRC_DIR}/creportersettingsinit.cpp \
+                $${SETTINGS_SRC_DIR}/creportersettingsobserver.cpp \
 
 HEADERS += $${SETTINGS_SRC_DIR}/creporterprivacysettingsmodel.h \
             $${SETTINGS_SRC_DIR}/creportersettingsinit_p.h \
             $${SETTINGS_SRC_DIR}/creportersettingsbase_p.h \
             $${SETTINGS_SRC_DIR}/creportersettingsbase.h \
+            $${SETTINGS_SRC_DIR}/creportersettingsobserver.h \
+            $${SETTINGS_SRC_DIR}/creportersettingsobserver_p.h \
            $$CREPORTER_SRC_DIR/libs/autouploader_interface.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercoreindex.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporterlzowriter.h \
            $$CREPORTER_SRC_DIR/libs/utils/creporterutils.h \
+           $$CREPORTER_SRC_DIR/libs/utils/creporteruploadnotifier.h \
             ut_creporterprivacysettingsmodel.h \
 
 SOURCES += \
@@ -31,7 +40,10 @@ SOURCES += \
 	ut_creporterprivacysettingsmodel.cpp \
 	$$CREPORTER_SRC_DIR/libs/autouploader_interface.cpp \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.cpp \
+	$$CREPORTER_SRC_DIR/libs/coredir/creportercoreindex.cpp \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.cpp \
+	$$CREPORTER_SRC_DIR/libs/utils/creporterlzowriter.cpp \
 	$$CREPORTER_SRC_DIR/libs/utils/creporterutils.cpp \
+	$$CREPORTER_SRC_DIR/libs/utils/creporteruploadnotifier.cpp \
 
 include(../ut_coverage.pri)
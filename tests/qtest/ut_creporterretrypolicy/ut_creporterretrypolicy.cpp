@@ -0,0 +1,79 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QSet>
+
+#include "ut_creporterretrypolicy.h"
+#include "creporterretrypolicy.h"
+
+void Ut_CReporterRetryPolicy::testDelayGrowsExponentially()
+{
+    CReporterRetryPolicy policy(10, 3600, 10);
+
+    for (int attempts = 1; attempts <= 5; ++attempts) {
+        qint64 full = 10000 << (attempts - 1);
+        qint64 delay = policy.retryDelay(attempts);
+        QVERIFY2(delay >= full / 2 && delay <= full,
+                 qPrintable(QString("attempt %1: %2 ms").arg(attempts).arg(delay)));
+    }
+}
+
+void Ut_CReporterRetryPolicy::testDelayIsCapped()
+{
+    CReporterRetryPolicy policy(10, 100, 100);
+
+    QVERIFY(policy.retryDelay(5) <= 100000);
+    // Doesn't overflow with a huge number of attempts.
+    qint64 delay = policy.retryDelay(99);
+    QVERIFY(delay >= 50000 && delay <= 100000);
+}
+
+void Ut_CReporterRetryPolicy::testDelaysAreSpread()
+{
+    CReporterRetryPolicy policy(60, 3600, 10);
+
+    QSet<qint64> delays;
+    for (int i = 0; i < 20; ++i) {
+        delays << policy.retryDelay(3);
+    }
+
+    QVERIFY(delays.count() > 1);
+}
+
+void Ut_CReporterRetryPolicy::testRetryAfterIsObeyed()
+{
+    CReporterRetryPolicy policy(10, 100, 10);
+
+    // Longer than the computed delay and the cap.
+    QCOMPARE(policy.retryDelay(1, 300), qint64(300000));
+    // Shorter one doesn't make the retry sooner.
+    QVERIFY(policy.retryDelay(4, 1) >= 40000);
+}
+
+void Ut_CReporterRetryPolicy::testAttemptsAreLimited()
+{
+    CReporterRetryPolicy policy(10, 100, 3);
+
+    QVERIFY(policy.canRetry(1));
+    QVERIFY(policy.canRetry(2));
+    QVERIFY(!policy.canRetry(3));
+}
+
+QTEST_MAIN(Ut_CReporterRetryPolicy)
@@ -0,0 +1,25 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterretrypolicy
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/httpclient \
+               $$CREPORTER_SRC_DIR/libs/settings \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/httpclient/creporterretrypolicy.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/httpclient/creporterretrypolicy.h \
+           ut_creporterretrypolicy.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterretrypolicy.cpp \
+
+include(../ut_coverage.pri)
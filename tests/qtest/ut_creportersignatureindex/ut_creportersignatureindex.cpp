@@ -0,0 +1,140 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+
+#include "ut_creportersignatureindex.h"
+#include "creportersignatureindex.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString indexFile(testDirectory + "/crash-signatures");
+
+static const qint64 Hour = 60 * 60 * 1000;
+// Some fixed point of time, aligned to the time slots.
+static const qint64 Start = 1000 * 24 * Hour;
+
+void Ut_CReporterSignatureIndex::init()
+{
+    QDir().mkpath(testDirectory);
+}
+
+void Ut_CReporterSignatureIndex::testSignatureDependsOnDetails()
+{
+    quint64 signature = CReporterSignatureIndex::signature("application", 11);
+
+    QCOMPARE(CReporterSignatureIndex::signature("application", 11), signature);
+    QVERIFY(CReporterSignatureIndex::signature("application", 6) != signature);
+    QVERIFY(CReporterSignatureIndex::signature("other", 11) != signature);
+    QVERIFY(CReporterSignatureIndex::signature("application", 11, "stack") != signature);
+    // Parts are separated, so they can't be mixed up.
+    QVERIFY(CReporterSignatureIndex::signature("app1", 1)
+            != CReporterSignatureIndex::signature("app", 11));
+}
+
+void Ut_CReporterSignatureIndex::testOccurrencesAreCounted()
+{
+    CReporterSignatureIndex index(QString());
+    quint64 first = CReporterSignatureIndex::signature("first", 11);
+    quint64 second = CReporterSignatureIndex::signature("second", 11);
+
+    QCOMPARE(index.occurrences(first, Start), 0);
+    QCOMPARE(index.record(first, Start), 1);
+    QCOMPARE(index.record(first, Start + 1), 2);
+    QCOMPARE(index.record(second, Start + 2), 1);
+    QCOMPARE(index.record(first, Start + Hour), 3);
+
+    QCOMPARE(index.occurrences(first, Start + Hour), 3);
+    QCOMPARE(index.occurrences(second, Start + Hour), 1);
+    QCOMPARE(index.count(), 2);
+}
+
+void Ut_CReporterSignatureIndex::testOldOccurrencesExpire()
+{
+    CReporterSignatureIndex index(QString());
+    quint64 signature = CReporterSignatureIndex::signature("application", 11);
+
+    QCOMPARE(index.window(), 24 * Hour);
+
+    index.record(signature, Start);
+    index.record(signature, Start + 12 * Hour);
+    QCOMPARE(index.record(signature, Start + 23 * Hour), 3);
+
+    // Window slides, first one drops out but the others are still counted.
+    QCOMPARE(index.record(signature, Start + 24 * Hour), 3);
+    QCOMPARE(index.occurrences(signature, Start + 36 * Hour), 2);
+    QCOMPARE(index.occurrences(signature, Start + 100 * Hour), 0);
+
+    QCOMPARE(index.record(signature, Start + 100 * Hour), 1);
+}
+
+void Ut_CReporterSignatureIndex::testIndexSurvivesRestart()
+{
+    quint64 signature = CReporterSignatureIndex::signature("application", 11);
+
+    {
+        CReporterSignatureIndex index(indexFile);
+        index.record(signature, Start);
+        index.record(signature, Start + Hour);
+        // Saved on destruction.
+    }
+
+    CReporterSignatureIndex index(indexFile);
+    QCOMPARE(index.count(), 1);
+    QCOMPARE(index.record(signature, Start + 2 * Hour), 3);
+
+    // Counts can't be kept if the window changes.
+    index.setWindow(48 * Hour);
+    QVERIFY(index.save());
+
+    CReporterSignatureIndex other(indexFile);
+    QCOMPARE(other.count(), 0);
+}
+
+void Ut_CReporterSignatureIndex::testLeastRecentSignatureIsDropped()
+{
+    const int Capacity = 10;
+
+    CReporterSignatureIndex index(QString());
+    index.setCapacity(Capacity);
+
+    for (int i = 0; i < 2 * Capacity; ++i) {
+        quint64 signature = CReporterSignatureIndex::signature("application", i);
+        index.record(signature, Start + i);
+        if (i == 0) {
+            // Seen again, so this one is kept.
+            index.record(signature, Start + 2 * Capacity);
+        }
+    }
+
+    QCOMPARE(index.count(), Capacity);
+    QCOMPARE(index.occurrences(CReporterSignatureIndex::signature("application", 0),
+                               Start + 2 * Capacity), 2);
+    QCOMPARE(index.occurrences(CReporterSignatureIndex::signature("application", 1),
+                               Start + 2 * Capacity), 0);
+    QCOMPARE(index.occurrences(CReporterSignatureIndex::signature("application", 19),
+                               Start + 2 * Capacity), 1);
+}
+
+void Ut_CReporterSignatureIndex::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterSignatureIndex)
@@ -0,0 +1,25 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creportersignatureindex
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creportersignatureindex.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/coredir/creportersignatureindex.h \
+           ut_creportersignatureindex.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportersignatureindex.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,249 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <lzo/lzo1x.h>
+
+#include <QDir>
+#include <QFile>
+#include <QtEndian>
+
+#include "ut_creporterstackfingerprint.h"
+#include "creporterrichcorereader.h"
+#include "creporterstackfingerprint.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString testDataFile("/usr/lib/crash-reporter-tests/testdata/"
+                                  "crashapplication-0287-11-2260.rcore.lzo");
+
+static const QByteArray stackTrace(
+        "Thread 2 (Thread 0xb5f1e460 (LWP 2261)):\n"
+        "#0  0xb6c1a2b0 in poll () from /lib/libc.so.6\n"
+        "#1  0xb6e4c2f4 in g_main_context_iterate () from /usr/lib/libglib-2.0.so.0\n"
+        "\n"
+        "Thread 1 (Thread 0xb6f2c000 (LWP 2260)):\n"
+        "#0  0xb6b8e2c4 in raise () from /lib/libc.so.6\n"
+        "#1  0xb6b913ee in abort () from /lib/libc.so.6\n"
+        "#2  0x00012345 in Crasher::crash (this=0x1e2f0, depth=3) at crasher.cpp:42\n"
+        "#3  0xb6d00100 in ?? () from /usr/lib/libplugin.so.1\n"
+        "#4  0x00012400 in main (argc=1, argv=0xbefff6d4) at main.cpp:50\n");
+
+static QByteArray richCore(const QByteArray &trace)
+{
+    return "\n[---rich-core: date---]\nSat Jan  1 06:47:25 UTC 2000\n"
+           "\n[---rich-core: stack-trace---]\n" + trace +
+           "\n[---rich-core: coredump---]\nELF";
+}
+
+static void putU32(QByteArray *data, quint32 value)
+{
+    uchar bytes[4];
+    qToBigEndian(value, bytes);
+    data->append(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+}
+
+// Writes @a data as a single lzop stream, like lzop itself does.
+static QByteArray lzopStream(const QByteArray &data)
+{
+    static const char magic[] = { '\x89', 'L', 'Z', 'O', '\0', '\r', '\n', '\x1a', '\n' };
+    static const uchar header[] = {
+        0x10, 0x30,             // version
+        0x20, 0xa0,             // library version
+        0x09, 0x40,             // version needed to extract
+        0x01,                   // method LZO1X-1
+        0x05,                   // level
+        0x00, 0x00, 0x00, 0x01, // flags, adler32 of uncompressed data
+        0x00, 0x00, 0x81, 0xa4, // mode
+        0x00, 0x00, 0x00, 0x00, // mtime
+        0x00, 0x00, 0x00, 0x00, // mtime high
+        0x00,                   // file name length
+    };
+
+    QByteArray result(magic, sizeof(magic));
+    result.append(reinterpret_cast<const char *>(header), sizeof(header));
+    putU32(&result, lzo_adler32(1, const_cast<uchar *>(header), sizeof(header)));
+
+    QByteArray source(data);
+    QByteArray compressed(source.size() + source.size() / 16 + 64 + 3, 0);
+    QByteArray workMemory(LZO1X_1_MEM_COMPRESS, 0);
+    lzo_uint compressedSize = compressed.size();
+    lzo1x_1_compress(reinterpret_cast<lzo_bytep>(source.data()), source.size(),
+                     reinterpret_cast<lzo_bytep>(compressed.data()), &compressedSize,
+                     workMemory.data());
+    compressed.truncate(compressedSize);
+
+    putU32(&result, source.size());
+    putU32(&result, qMin<int>(compressed.size(), source.size()));
+    putU32(&result, lzo_adler32(1, reinterpret_cast<lzo_bytep>(source.data()), source.size()));
+    result.append(compressed.size() < source.size() ? compressed : source);
+    putU32(&result, 0);
+
+    return result;
+}
+
+static void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+void Ut_CReporterStackFingerprint::init()
+{
+    QDir().mkpath(testDirectory);
+    QCOMPARE(lzo_init(), LZO_E_OK);
+}
+
+void Ut_CReporterStackFingerprint::testFramesAreNormalized()
+{
+    QStringList expected;
+    expected << "Crasher::crash" << "??@libplugin.so.1" << "main";
+
+    QCOMPARE(CReporterStackFingerprint::frames(stackTrace), expected);
+    QCOMPARE(CReporterStackFingerprint::frames(stackTrace, 2), expected.mid(0, 2));
+
+    // Without thread headers the first thread is taken.
+    QByteArray euStack(
+            "PID 2260 - process\n"
+            "TID 2260:\n"
+            "#0  0xb6b8e2c4 raise - /lib/libc.so.6\n"
+            "#1  0x00012345 Crasher::crash - /usr/bin/crasher\n"
+            "TID 2261:\n"
+            "#0  0xb6c1a2b0 poll - /lib/libc.so.6\n");
+    QCOMPARE(CReporterStackFingerprint::frames(euStack), QStringList() << "Crasher::crash");
+}
+
+void Ut_CReporterStackFingerprint::testCrashHandlerIsSkipped()
+{
+    QByteArray trace(
+            "#0  0xb6c1a2b0 in waitpid () from /lib/libc.so.6\n"
+            "#1  0x00011000 in handleCrash (signal=11) at handler.cpp:10\n"
+            "#2  <signal handler called>\n"
+            "#3  0x00012345 in Crasher::crash (this=0x0) at crasher.cpp:42\n");
+
+    QCOMPARE(CReporterStackFingerprint::frames(trace), QStringList() << "Crasher::crash");
+}
+
+void Ut_CReporterStackFingerprint::testFingerprintIgnoresAddresses()
+{
+    QByteArray fingerprint(CReporterStackFingerprint::fromStackTrace(stackTrace));
+    QCOMPARE(fingerprint.size(), 20);
+
+    QByteArray relocated(stackTrace);
+    relocated.replace("0xb6d00100", "0xa6d00100").replace("depth=3", "depth=4")
+             .replace("crasher.cpp:42", "crasher.cpp:45");
+    QCOMPARE(CReporterStackFingerprint::fromStackTrace(relocated), fingerprint);
+
+    QByteArray other(stackTrace);
+    other.replace("Crasher::crash", "Crasher::crashHarder");
+    QVERIFY(CReporterStackFingerprint::fromStackTrace(other) != fingerprint);
+
+    QVERIFY(CReporterStackFingerprint::fromStackTrace("no frames here").isEmpty());
+}
+
+void Ut_CReporterStackFingerprint::testUnresolvedFramesAreReported()
+{
+    bool symbolized = true;
+    QVERIFY(!CReporterStackFingerprint::fromStackTrace(stackTrace,
+            CReporterStackFingerprint::DefaultFrameCount, &symbolized).isEmpty());
+    QVERIFY(!symbolized);
+
+    // Only the frames included in the fingerprint count.
+    QVERIFY(!CReporterStackFingerprint::fromStackTrace(stackTrace, 1, &symbolized).isEmpty());
+    QVERIFY(symbolized);
+
+    QVERIFY(CReporterStackFingerprint::fromStackTrace("no frames here",
+            CReporterStackFingerprint::DefaultFrameCount, &symbolized).isEmpty());
+    QVERIFY(!symbolized);
+}
+
+void Ut_CReporterStackFingerprint::testPlainRichCore()
+{
+    QString path(testDirectory + "/crasher-0287-11-2260.rcore");
+    writeFile(path, richCore(stackTrace));
+
+    CReporterRichCoreReader reader(path);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("date"));
+    QCOMPARE(reader.readSection(), QByteArray("Sat Jan  1 06:47:25 UTC 2000\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("stack-trace"));
+    // Core dump is never returned.
+    QVERIFY(!reader.nextSection());
+    QVERIFY(reader.readSection().isEmpty());
+    QVERIFY(reader.errorString().isEmpty());
+
+    QCOMPARE(CReporterStackFingerprint::fromFile(path),
+             CReporterStackFingerprint::fromStackTrace(stackTrace));
+}
+
+void Ut_CReporterStackFingerprint::testCompressedSectionsAreRead()
+{
+    CReporterRichCoreReader reader(testDataFile);
+    QVERIFY(reader.open());
+
+    QStringList sections;
+    while (reader.nextSection()) {
+        sections << reader.sectionName();
+        // Partial reads skip the rest of the section.
+        QVERIFY(reader.readSection(16).size() <= 16);
+    }
+
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(sections.count(), 13);
+    QCOMPARE(sections.first(), QString("date"));
+    QCOMPARE(sections.last(), QString("/tmp/osso-product-info"));
+    QVERIFY(sections.contains("packagelist"));
+
+    // The test report was created without a stack trace.
+    QVERIFY(CReporterStackFingerprint::fromFile(testDataFile).isEmpty());
+}
+
+void Ut_CReporterStackFingerprint::testConcatenatedStreams()
+{
+    QString path(testDirectory + "/crasher-0287-11-2260.rcore.lzo");
+
+    // Rich cores get data appended to them as additional lzop streams.
+    QByteArray data(richCore(stackTrace));
+    int split = data.indexOf("#2");
+    writeFile(path, lzopStream(data.left(split)) + lzopStream(data.mid(split)));
+
+    QCOMPARE(CReporterStackFingerprint::fromFile(path),
+             CReporterStackFingerprint::fromStackTrace(stackTrace));
+
+    // Corruption is detected by the checksum.
+    QByteArray corrupted(lzopStream(data));
+    corrupted[corrupted.size() - 10] = corrupted.at(corrupted.size() - 10) ^ 0x55;
+    writeFile(path, corrupted);
+
+    CReporterRichCoreReader reader(path);
+    QVERIFY(reader.open());
+    while (reader.nextSection()) {
+        reader.readSection();
+    }
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+void Ut_CReporterStackFingerprint::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterStackFingerprint)
@@ -0,0 +1,31 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterstackfingerprint
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterrichcorereader.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creporterlzoreader.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creporterstackfingerprint.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/utils/creporterrichcorereader.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterlzoreader.h \
+           $${CREPORTER_SRC_DIR}/libs/utils/creporterstackfingerprint.h \
+           ut_creporterstackfingerprint.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterstackfingerprint.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,113 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QSignalSpy>
+
+#include "ut_creporterstormdetector.h"
+#include "creporterstormdetector.h"
+
+static const qint64 Minute = 60 * 1000;
+static const qint64 Start = 1000 * Minute;
+
+void Ut_CReporterStormDetector::testBurstIsAdmitted()
+{
+    CReporterStormDetector detector;
+    detector.setSourceLimit(3, 1);
+
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(detector.admit("service", Start + 1));
+    QVERIFY(detector.admit("service", Start + 2));
+    QVERIFY(!detector.inStorm());
+
+    QVERIFY(!detector.admit("service", Start + 3));
+    QVERIFY(detector.inStorm());
+}
+
+void Ut_CReporterStormDetector::testSourcesAreLimitedSeparately()
+{
+    CReporterStormDetector detector;
+    detector.setSourceLimit(2, 1);
+
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(!detector.admit("service", Start));
+
+    // Other applications are still handled normally.
+    QVERIFY(detector.admit("application", Start));
+    QVERIFY(detector.admit("application", Start));
+}
+
+void Ut_CReporterStormDetector::testGlobalLimit()
+{
+    CReporterStormDetector detector;
+    detector.setSourceLimit(2, 1);
+    detector.setGlobalLimit(5, 1);
+
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(detector.admit(QString("application%1").arg(i), Start));
+    }
+    QVERIFY(!detector.admit("application5", Start));
+}
+
+void Ut_CReporterStormDetector::testTokensAreRefilled()
+{
+    CReporterStormDetector detector;
+    detector.setSourceLimit(2, 2);
+
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(!detector.admit("service", Start + 10 * 1000));
+
+    // One token in 30 seconds.
+    QVERIFY(detector.admit("service", Start + 30 * 1000));
+    QVERIFY(!detector.admit("service", Start + 31 * 1000));
+
+    // Burst is refilled only up to its size.
+    QVERIFY(detector.admit("service", Start + 10 * Minute));
+    QVERIFY(detector.admit("service", Start + 10 * Minute));
+    QVERIFY(!detector.admit("service", Start + 10 * Minute));
+}
+
+void Ut_CReporterStormDetector::testStormEndIsSummarized()
+{
+    CReporterStormDetector detector;
+    detector.setSourceLimit(1, 1);
+    detector.setQuietPeriod(100);
+
+    qRegisterMetaType<QMap<QString, int> >();
+    QSignalSpy spy(&detector, SIGNAL(stormEnded(QMap<QString, int>, qint64)));
+
+    QVERIFY(detector.admit("service", Start));
+    QVERIFY(detector.admit("application", Start));
+    for (int i = 1; i <= 4; ++i) {
+        QVERIFY(!detector.admit("service", Start + i * 1000));
+    }
+    QVERIFY(!detector.admit("application", Start + 5000));
+
+    QTRY_COMPARE(spy.count(), 1);
+    QVERIFY(!detector.inStorm());
+
+    QMap<QString, int> suppressed(spy.at(0).at(0).value<QMap<QString, int> >());
+    QCOMPARE(suppressed.value("service"), 4);
+    QCOMPARE(suppressed.value("application"), 1);
+    QCOMPARE(spy.at(0).at(1).toLongLong(), qint64(4000));
+}
+
+QTEST_MAIN(Ut_CReporterStormDetector)
@@ -0,0 +1,24 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creporterstormdetector
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterstormdetector.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/utils/creporterstormdetector.h \
+           ut_creporterstormdetector.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterstormdetector.cpp \
+
+include(../ut_coverage.pri)
@@ -32,12 +32,14 @@
 #include "ut_creporteruploadengine.h"
 
 static CReporterHttpClient *httpInstance = 0;
+static QList<CReporterHttpClient *> httpInstances;
 
 // CReporterHttpClient mock object.
 CReporterHttpClient::CReporterHttpClient(QObject *parent)
 {
     Q_UNUSED(parent);
     httpInstance = this;
+    httpInstances << this;
 }
 
 CReporterHttpClient::~CReporterHttpClient()
@@ -74,6 +76,17 @@ void CReporterHttpClient::emitUpdateProgress(int done)
     emit updateProgress(done);
 }
 
+int CReporterHttpClient::retryAfter() const
+{
+    return -1;
+}
+
+bool CReporterHttpClient::uploadBatch(const QStringList &files)
+{
+    Q_UNUSED(files);
+    return true;
+}
+
 static CReporterNwSessionMgr *sesManager = 0;
 static bool openedCalled;
 static bool openCalled;
@@ -144,6 +157,7 @@ void Ut_CReporterUploadEngine::init()
 {
     m_Queue = new CReporterUploadQueue();
     m_Subject = new CReporterUploadEngine(m_Queue);
+    httpInstances.clear();
 }
 
 void Ut_CReporterUploadEngine::testUploadItems()
@@ -186,6 +200,49 @@ void Ut_CReporterUploadEngine::testUploadItems()
     QVERIFY(m_Subject->lastError().isNull() == true);
 }
 
+void Ut_CReporterUploadEngine::testParallelUploads()
+{
+    QSignalSpy finishedSpy(m_Subject, SIGNAL(finished(int, int, int)));
+    QSignalSpy nextItemSpy(m_Queue, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    m_Queue->setMaxActiveItems(2);
+
+    // Queue 3 files.
+    m_Queue->enqueue(
+        new CReporterUploadItem("/media/mmc1/core-dumps/application-1234-11-4321.rcore.lzo"));
+    m_Queue->enqueue(
+        new CReporterUploadItem("/media/mmc1/core-dumps/application-1234-11-4322.rcore.lzo"));
+    m_Queue->enqueue(
+        new CReporterUploadItem("/media/mmc1/core-dumps/application-1234-11-4323.rcore.lzo"));
+
+    // Two items are handed out, but wait for the network session.
+    QCOMPARE(nextItemSpy.count(), 2);
+    QCOMPARE(httpInstances.count(), 0);
+
+    sesManager->emitSessionOpened();
+    QCOMPARE(httpInstances.count(), 2);
+
+    // Second item finishes first, which frees a slot for the third one.
+    httpInstances.at(1)->emitFinished();
+    QCOMPARE(nextItemSpy.count(), 3);
+    QCOMPARE(httpInstances.count(), 3);
+    QCOMPARE(m_Queue->activeItems(), 2);
+
+    // Second upload fails, the others still go on.
+    httpInstances.at(2)->emitUploadError("application-1234-11-4323.rcore.lzo", "Error");
+    QVERIFY(closeCalled == false);
+
+    httpInstances.at(0)->emitFinished();
+    QVERIFY(closeCalled == true);
+
+    sesManager->emitSessionDisconnected();
+    QCOMPARE(finishedSpy.count(), 1);
+    QList<QVariant> arguments = finishedSpy.takeFirst();
+    QCOMPARE(arguments.at(0).toInt(), int(CReporterUploadEngine::ProtocolError));
+    QCOMPARE(arguments.at(1).toInt(), 2);
+    QCOMPARE(arguments.at(2).toInt(), 3);
+}
+
 void Ut_CReporterUploadEngine::testOpeningNetworkSessionFails()
 {
     // Test situation when network session doesn't open.
@@ -27,6 +27,8 @@
 
 #include <QTest>
 
+#include "creportercoreindex.h"
+
 class CReporterUploadEngine;
 class CReporterUploadQueue;
 
@@ -40,14 +42,19 @@ class CReporterHttpClient : public QObject
     ~CReporterHttpClient();
 
     void initSession(bool deleteAfterSending = true);
+    int retryAfter() const;
 
 Q_SIGNALS:
     void finished();
     void uploadError(const QString &file, const QString &errorString);
     void updateProgress(int done);
+    void updateThroughput(qint64 bytesPerSecond);
+    void fileFinished(const QString &file, bool success, const QString &errorString);
+    void uploadStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
 
 public Q_SLOTS:
     bool upload(const QString &file);
+    bool uploadBatch(const QStringList &files);
     void cancel();
 
 public:
@@ -89,6 +96,7 @@ private Q_SLOTS:
     void init();
 
     void testUploadItems();
+    void testParallelUploads();
     void testOpeningNetworkSessionFails();
     void testNetworkSessionDisconnectsDuringUpload();
     void testUploadCancelledByTheUser();
@@ -6,6 +6,7 @@ HTTPCLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
 
 INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/coredir \
                $${CREPORTER_SRC_DIR}/libs \
                $${CREPORTER_SRC_DIR}/libs/settings \
 
@@ -19,6 +20,7 @@ HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploadengine.h \
            $${HTTPCLIENT_SRC_DIR}/creporteruploadengine_p.h \
            $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.h \
            $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.h \
+           $${HTTPCLIENT_SRC_DIR}/creporteruploadbatch.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase_p.h \
@@ -29,6 +31,7 @@ HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploadengine.h \
 SOURCES += $$TEST_SOURCES \
            $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.cpp \
            $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.cpp \
+           $${HTTPCLIENT_SRC_DIR}/creporteruploadbatch.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creporterapplicationsettings.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.cpp \
            $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
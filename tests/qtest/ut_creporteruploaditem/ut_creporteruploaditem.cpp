@@ -76,6 +76,23 @@ void CReporterHttpClient::emitUpdateProgress(int done)
     emit updateProgress(done);
 }
 
+void CReporterHttpClient::emitUploadStateChanged(const QString &file,
+                                                 CReporterCoreIndex::UploadState state)
+{
+    emit uploadStateChanged(file, state);
+}
+
+int CReporterHttpClient::retryAfter() const
+{
+    return -1;
+}
+
+bool CReporterHttpClient::uploadBatch(const QStringList &files)
+{
+    Q_UNUSED(files);
+    return true;
+}
+
 // Unit test object.
 void Ut_CReporterUploadItem::init()
 {
@@ -90,7 +107,7 @@ void Ut_CReporterUploadItem::init()
 
 void Ut_CReporterUploadItem::initTestCase()
 {
-
+    qRegisterMetaType<CReporterCoreIndex::UploadState>("CReporterCoreIndex::UploadState");
 }
 
 void Ut_CReporterUploadItem::testSendingItem()
@@ -193,6 +210,26 @@ void Ut_CReporterUploadItem::testCancellingWaitingItem()
     QVERIFY(m_Subject->status() == CReporterUploadItem::Cancelled);
 }
 
+void Ut_CReporterUploadItem::testUploadStateIsForwarded()
+{
+    // Item doesn't store the state, its owner does.
+    QSignalSpy stateSpy(m_Subject,
+                        SIGNAL(uploadStateChanged(QString, CReporterCoreIndex::UploadState)));
+
+    uploadStarted = true;
+    m_Subject->startUpload();
+
+    httpInstance->emitUploadStateChanged(m_Subject->filePath(), CReporterCoreIndex::Uploading);
+    httpInstance->emitUploadStateChanged(m_Subject->filePath(), CReporterCoreIndex::Uploaded);
+
+    QCOMPARE(stateSpy.count(), 2);
+    QCOMPARE(stateSpy.at(0).at(0).toString(), m_Subject->filePath());
+    QCOMPARE(stateSpy.at(0).at(1).value<CReporterCoreIndex::UploadState>(),
+             CReporterCoreIndex::Uploading);
+    QCOMPARE(stateSpy.at(1).at(1).value<CReporterCoreIndex::UploadState>(),
+             CReporterCoreIndex::Uploaded);
+}
+
 void Ut_CReporterUploadItem::cleanup()
 {
     if (m_Subject != 0) {
@@ -27,6 +27,8 @@
 
 #include <QTest>
 
+#include "creportercoreindex.h"
+
 class CReporterUploadItem;
 
 class CReporterHttpClient : public QObject
@@ -39,20 +41,26 @@ public:
     ~CReporterHttpClient();
 
     void initSession(bool deleteAfterSending = true);
+    int retryAfter() const;
 
 Q_SIGNALS:
     void finished();
     void uploadError(const QString &file, const QString &errorString);
     void updateProgress(int done);
+    void updateThroughput(qint64 bytesPerSecond);
+    void fileFinished(const QString &file, bool success, const QString &errorString);
+    void uploadStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
 
 public Q_SLOTS:
     bool upload(const QString &file);
+    bool uploadBatch(const QStringList &files);
     void cancel();
 
 public:
     void emitFinished();
     void emitUploadError(const QString &file, const QString &errorString);
     void emitUpdateProgress(int done);
+    void emitUploadStateChanged(const QString &file, CReporterCoreIndex::UploadState state);
 };
 
 class Ut_CReporterUploadItem : public QObject
@@ -69,6 +77,7 @@ private Q_SLOTS:
     void testSendingItemCancelled();
     void testFailingUploadStarting();
     void testCancellingWaitingItem();
+    void testUploadStateIsForwarded();
 
     void cleanupTestCase();
     void cleanup();
@@ -6,6 +6,7 @@ HTTPCLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
 
 INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/coredir \
                $${CREPORTER_SRC_DIR}/libs
 
 DEPENDPATH += $$INCLUDEPATH \
@@ -13,10 +14,12 @@ DEPENDPATH += $$INCLUDEPATH \
 TEST_SOURCES += $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.cpp \
 
 HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploaditem.h \
+           $${HTTPCLIENT_SRC_DIR}/creporteruploadbatch.h \
            ut_creporteruploaditem.h \
 
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
+           $${HTTPCLIENT_SRC_DIR}/creporteruploadbatch.cpp \
            ut_creporteruploaditem.cpp \
 
 include(../ut_coverage.pri)
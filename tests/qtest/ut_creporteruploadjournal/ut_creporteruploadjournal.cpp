@@ -0,0 +1,165 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "ut_creporteruploadjournal.h"
+#include "creporteruploadjournal.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString journalFile(testDirectory + "/upload-journal");
+
+static QString corePath(int i)
+{
+    return QString("/var/cache/core-dumps/app-1234-11-%1.rcore.lzo").arg(1000 + i);
+}
+
+void Ut_CReporterUploadJournal::init()
+{
+    QDir().mkpath(testDirectory);
+}
+
+void Ut_CReporterUploadJournal::testStateSurvivesReload()
+{
+    {
+        CReporterUploadJournal journal(journalFile);
+        QCOMPARE(journal.count(), 0);
+
+        journal.add(corePath(0));
+        journal.add(corePath(1));
+        journal.add(corePath(2));
+        journal.setState(corePath(0), CReporterUploadJournal::Uploading);
+        journal.setState(corePath(0), CReporterUploadJournal::Failed, "Server error");
+        journal.setNextEligible(corePath(0), 123456);
+        journal.setState(corePath(1), CReporterUploadJournal::Uploading);
+        journal.remove(corePath(1));
+    }
+
+    CReporterUploadJournal journal(journalFile);
+    QList<CReporterUploadJournal::Entry> entries = journal.entries();
+    QCOMPARE(entries.count(), 2);
+    QCOMPARE(entries.at(0).filePath, corePath(0));
+    QCOMPARE(entries.at(1).filePath, corePath(2));
+
+    QCOMPARE(entries.at(0).state, CReporterUploadJournal::Failed);
+    QCOMPARE(entries.at(0).attempts, 1);
+    QCOMPARE(entries.at(0).lastError, QString("Server error"));
+    QCOMPARE(entries.at(0).nextEligible, qint64(123456));
+
+    QCOMPARE(entries.at(1).state, CReporterUploadJournal::Pending);
+    QCOMPARE(entries.at(1).attempts, 0);
+    QVERIFY(!journal.contains(corePath(1)));
+}
+
+void Ut_CReporterUploadJournal::testTornRecordIsDropped()
+{
+    {
+        CReporterUploadJournal journal(journalFile);
+        journal.add(corePath(0));
+        journal.add(corePath(1));
+    }
+
+    // Simulate crash in the middle of appending the last record.
+    QFile file(journalFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5));
+    file.close();
+
+    {
+        CReporterUploadJournal journal(journalFile);
+        QCOMPARE(journal.count(), 1);
+        QVERIFY(journal.contains(corePath(0)));
+
+        // New records must be readable after the truncated one.
+        journal.add(corePath(2));
+    }
+
+    CReporterUploadJournal journal(journalFile);
+    QCOMPARE(journal.count(), 2);
+    QVERIFY(journal.contains(corePath(0)));
+    QVERIFY(journal.contains(corePath(2)));
+}
+
+void Ut_CReporterUploadJournal::testCompaction()
+{
+    CReporterUploadJournal journal(journalFile);
+    journal.add(corePath(0));
+    for (int i = 1; i < 1000; ++i) {
+        journal.add(corePath(i));
+        journal.setState(corePath(i), CReporterUploadJournal::Uploading);
+        journal.remove(corePath(i));
+    }
+
+    // Superseded records are dropped automatically, the file doesn't grow without bound.
+    qint64 size = QFileInfo(journalFile).size();
+    QVERIFY(size < 16 * 1024);
+
+    QVERIFY(journal.compact());
+    QVERIFY(QFileInfo(journalFile).size() < size);
+
+    CReporterUploadJournal reloaded(journalFile);
+    QCOMPARE(reloaded.count(), 1);
+    QVERIFY(reloaded.contains(corePath(0)));
+}
+
+void Ut_CReporterUploadJournal::testWithoutFile()
+{
+    CReporterUploadJournal journal((QString()));
+    journal.add(corePath(0));
+    journal.setState(corePath(0), CReporterUploadJournal::Failed, "Network down");
+    QCOMPARE(journal.entry(corePath(0)).state, CReporterUploadJournal::Failed);
+    QVERIFY(journal.compact());
+
+    journal.remove(corePath(0));
+    QCOMPARE(journal.count(), 0);
+    QVERIFY(!QFile::exists(journalFile));
+}
+
+void Ut_CReporterUploadJournal::testEarliestEligible()
+{
+    QCOMPARE(CReporterUploadJournal::earliestEligible(journalFile), qint64(-1));
+
+    {
+        CReporterUploadJournal journal(journalFile);
+        journal.add(corePath(0));
+        journal.add(corePath(1));
+        journal.setNextEligible(corePath(0), 5000);
+        journal.setNextEligible(corePath(1), 3000);
+    }
+    QCOMPARE(CReporterUploadJournal::earliestEligible(journalFile), qint64(3000));
+
+    // Reading doesn't touch the file, not even a torn record.
+    QFile file(journalFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    file.write("torn");
+    qint64 size = file.size();
+    file.close();
+    QCOMPARE(CReporterUploadJournal::earliestEligible(journalFile), qint64(3000));
+    QCOMPARE(QFileInfo(journalFile).size(), size);
+}
+
+void Ut_CReporterUploadJournal::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_CReporterUploadJournal)
@@ -29,11 +29,12 @@
 #include "ut_creporteruploadqueue.h"
 
 static QList<CReporterUploadItem *> items;
+static QList<QList<CReporterUploadItem *> > batches;
 
 // CReporterUploadItem mock object.
 CReporterUploadItem::CReporterUploadItem(const QString &file)
+    : size(0), path(file)
 {
-    Q_UNUSED(file);
     items.append(this);
 }
 
@@ -41,6 +42,21 @@ CReporterUploadItem::~CReporterUploadItem()
 {
 }
 
+qint64 CReporterUploadItem::filesize() const
+{
+    return size;
+}
+
+QString CReporterUploadItem::filePath() const
+{
+    return path;
+}
+
+void CReporterUploadItem::makeBatch(const QList<CReporterUploadItem *> &items)
+{
+    batches.append(items);
+}
+
 void CReporterUploadItem::emitDone()
 {
     emit done();
@@ -85,6 +101,171 @@ void Ut_CReporterUploadQueue::testEnqueueItems()
     QVERIFY(nextItemSpy.count() == 3);
 }
 
+void Ut_CReporterUploadQueue::testSmallItemsAreBatched()
+{
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    m_Subject->setBatchLimits(100, 3);
+    m_Subject->setOrder(CReporterUploadQueue::Fifo);
+
+    QList<qint64> sizes;
+    sizes << 1000 << 10 << 20 << 2000 << 30 << 40;
+
+    foreach (qint64 size, sizes) {
+        CReporterUploadItem *item = new CReporterUploadItem("file");
+        item->size = size;
+        m_Subject->enqueue(item);
+    }
+
+    // First item was handed out alone before the others were queued.
+    QCOMPARE(nextItemSpy.count(), 1);
+    items.at(0)->emitDone();
+
+    // Three small items from around the large one.
+    QCOMPARE(batches.count(), 1);
+    QCOMPARE(batches.at(0), QList<CReporterUploadItem *>()
+             << items.at(1) << items.at(2) << items.at(4));
+    QCOMPARE(nextItemSpy.count(), 4);
+
+    // Batch takes one slot.
+    items.at(1)->emitDone();
+    items.at(2)->emitDone();
+    QCOMPARE(nextItemSpy.count(), 4);
+    items.at(4)->emitDone();
+    QCOMPARE(nextItemSpy.count(), 5);
+    QCOMPARE(nextItemSpy.last().at(0).value<CReporterUploadItem *>(), items.at(3));
+
+    // Single small item isn't a batch.
+    items.at(3)->emitDone();
+    QCOMPARE(nextItemSpy.count(), 6);
+    QCOMPARE(batches.count(), 1);
+    items.at(5)->emitDone();
+}
+
+void Ut_CReporterUploadQueue::enqueueBehindFirst(const QStringList &files,
+                                                 const QList<qint64> &sizes)
+{
+    // The first item is handed out at once, the rest wait in the queue.
+    CReporterUploadItem *first = new CReporterUploadItem("/core-dumps/first-1234-11-1.rcore.lzo");
+    m_Subject->enqueue(first);
+
+    for (int i = 0; i < files.count(); ++i) {
+        CReporterUploadItem *item = new CReporterUploadItem("/core-dumps/" + files.at(i));
+        item->size = sizes.at(i);
+        m_Subject->enqueue(item);
+    }
+
+    first->emitDone();
+}
+
+QStringList Ut_CReporterUploadQueue::uploadOrder(QSignalSpy &nextItemSpy)
+{
+    QStringList order;
+
+    for (int i = 1; i < nextItemSpy.count(); ++i) {
+        CReporterUploadItem *item = nextItemSpy.at(i).at(0).value<CReporterUploadItem *>();
+        order << item->filePath().mid(QString("/core-dumps/").length());
+        item->emitDone();
+    }
+
+    return order;
+}
+
+void Ut_CReporterUploadQueue::testCrashReportsGoFirst()
+{
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    QStringList files;
+    files << "Endurance-1234-0-1.rcore.lzo"
+          << "JournalSpy-1234-0-2.rcore.lzo"
+          << "application-1234-11-3.rcore.lzo"
+          << "application-1234-6-4.rcore.lzo"
+          << "Quickie-1234-0-5.rcore.lzo";
+    QList<qint64> sizes;
+    sizes << 1000 << 100 << 5000 << 3000 << 10;
+
+    enqueueBehindFirst(files, sizes);
+
+    // Crash reports by size, then feedback, logs and endurance data.
+    QStringList expected;
+    expected << files.at(3) << files.at(2) << files.at(4) << files.at(1) << files.at(0);
+    QCOMPARE(uploadOrder(nextItemSpy), expected);
+}
+
+void Ut_CReporterUploadQueue::testFifoOrder()
+{
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    m_Subject->setOrder(CReporterUploadQueue::Fifo);
+    QCOMPARE(m_Subject->order(), CReporterUploadQueue::Fifo);
+
+    QStringList files;
+    files << "Endurance-1234-0-1.rcore.lzo"
+          << "application-1234-11-2.rcore.lzo"
+          << "JournalSpy-1234-0-3.rcore.lzo";
+    QList<qint64> sizes;
+    sizes << 1000 << 100 << 10;
+
+    enqueueBehindFirst(files, sizes);
+
+    QCOMPARE(uploadOrder(nextItemSpy), files);
+}
+
+void Ut_CReporterUploadQueue::testWaitingItemIsNotStarved()
+{
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    m_Subject->setAgingInterval(100);
+
+    CReporterUploadItem *first = new CReporterUploadItem("/core-dumps/first-1234-11-1.rcore.lzo");
+    m_Subject->enqueue(first);
+
+    CReporterUploadItem *endurance = new CReporterUploadItem("/core-dumps/Endurance-1234-0-2.rcore.lzo");
+    endurance->size = 1000;
+    m_Subject->enqueue(endurance);
+
+    // Waiting for more than three intervals outranks a fresh crash report.
+    QTest::qWait(500);
+
+    CReporterUploadItem *crash = new CReporterUploadItem("/core-dumps/application-1234-11-3.rcore.lzo");
+    crash->size = 10;
+    m_Subject->enqueue(crash);
+
+    first->emitDone();
+
+    QStringList expected;
+    expected << "Endurance-1234-0-2.rcore.lzo" << "application-1234-11-3.rcore.lzo";
+    QCOMPARE(uploadOrder(nextItemSpy), expected);
+}
+
+void Ut_CReporterUploadQueue::testBatchKeepsReportClass()
+{
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    m_Subject->setBatchLimits(100, 3);
+
+    QStringList files;
+    files << "Endurance-1234-0-1.rcore.lzo"
+          << "application-1234-11-2.rcore.lzo"
+          << "Endurance-1234-0-3.rcore.lzo"
+          << "application-1234-6-4.rcore.lzo";
+    QList<qint64> sizes;
+    sizes << 10 << 50 << 20 << 40;
+
+    enqueueBehindFirst(files, sizes);
+
+    // Endurance data doesn't ride along with the crash reports.
+    QCOMPARE(batches.count(), 1);
+    QCOMPARE(batches.at(0), QList<CReporterUploadItem *>()
+             << items.at(4) << items.at(2));
+
+    items.at(4)->emitDone();
+    items.at(2)->emitDone();
+    QCOMPARE(batches.count(), 2);
+    QCOMPARE(batches.at(1), QList<CReporterUploadItem *>()
+             << items.at(1) << items.at(3));
+}
+
 
 void Ut_CReporterUploadQueue::cleanup()
 {
@@ -94,6 +275,7 @@ void Ut_CReporterUploadQueue::cleanup()
     }
 
     items.clear();
+    batches.clear();
 }
 
 void Ut_CReporterUploadQueue::cleanupTestCase()
@@ -25,6 +25,7 @@
 #ifndef UT_CREPORTERUPLOADQUEUE_H
 #define UT_CREPORTERUPLOADQUEUE_H
 
+#include <QSignalSpy>
 #include <QTest>
 
 class CReporterUploadQueue;
@@ -38,8 +39,15 @@ public:
 
     ~CReporterUploadItem();
 
+    qint64 filesize() const;
+    QString filePath() const;
+    static void makeBatch(const QList<CReporterUploadItem *> &items);
+
     void emitDone();
 
+    qint64 size;
+    QString path;
+
 Q_SIGNALS:
     void done();
 };
@@ -54,11 +62,19 @@ private Q_SLOTS:
     void init();
 
     void testEnqueueItems();
+    void testSmallItemsAreBatched();
+    void testCrashReportsGoFirst();
+    void testFifoOrder();
+    void testWaitingItemIsNotStarved();
+    void testBatchKeepsReportClass();
 
     void cleanupTestCase();
     void cleanup();
 
 private:
+    void enqueueBehindFirst(const QStringList &files, const QList<qint64> &sizes);
+    QStringList uploadOrder(QSignalSpy &nextItemSpy);
+
     CReporterUploadQueue *m_Subject;
 };
 
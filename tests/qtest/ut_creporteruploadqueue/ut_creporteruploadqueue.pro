@@ -6,11 +6,13 @@ HTTPCLIENT_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/httpclient
 
 INCLUDEPATH += . \
                $${HTTPCLIENT_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/utils \
                $${CREPORTER_SRC_DIR}/libs \
 
 DEPENDPATH += $$INCLUDEPATH \
 
 TEST_SOURCES += $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
 
 HEADERS += $${HTTPCLIENT_SRC_DIR}/creporteruploadqueue.h \
            ut_creporteruploadqueue.h \
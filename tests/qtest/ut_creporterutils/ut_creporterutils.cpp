@@ -28,6 +28,7 @@
 #include <QFileInfo>
 #include <QDir>
 
+#include "creportercrashinfo.h"
 #include "creporterutils.h"
 #include "ut_creporterutils.h"
 
@@ -94,8 +95,17 @@ void Ut_CReporterUtils::testRemoveFile()
     file.close();
 
     QString path = QDir::homePath() + "/" + file.fileName();
+
+    // Offset of an interrupted upload goes with the file.
+    QString offsetFile(CReporterUtils::uploadOffsetFile(path));
+    QCOMPARE(offsetFile, QDir::homePath() + "/.test-1234-11-4321.rcore.lzo.upload");
+    QFile offset(offsetFile);
+    QVERIFY(offset.open(QIODevice::WriteOnly));
+    offset.close();
+
     bool retVal = CReporterUtils::removeFile(path);
     QVERIFY(retVal == true);
+    QVERIFY(!QFile::exists(offsetFile));
 }
 
 void Ut_CReporterUtils::testParseCrashInfoFromFilename()
@@ -109,6 +119,106 @@ void Ut_CReporterUtils::testParseCrashInfoFromFilename()
     QVERIFY(info.at(3) == "4321");
 }
 
+void Ut_CReporterUtils::testCrashInfoFromFileName_data()
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<QString>("applicationName");
+    QTest::addColumn<QString>("hwId");
+    QTest::addColumn<int>("signalNumber");
+    QTest::addColumn<int>("pid");
+    QTest::addColumn<int>("type");
+
+    QTest::newRow("crash")
+            << "/media/mmc1/core-dumps/application-somehwid-11-4321.rcore.lzo"
+            << true << "application" << "somehwid" << 11 << 4321
+            << int(CReporterCrashInfo::Crash);
+    QTest::newRow("dashes in name")
+            << "/var/cache/core-dumps/my-fancy-app-somehwid-6-12.rcore.lzo"
+            << true << "my-fancy-app" << "somehwid" << 6 << 12
+            << int(CReporterCrashInfo::Crash);
+    QTest::newRow("dots in name")
+            << "/var/cache/core-dumps/org.example.app-somehwid-6-12.rcore"
+            << true << "org.example.app" << "somehwid" << 6 << 12
+            << int(CReporterCrashInfo::Crash);
+    QTest::newRow("no directory")
+            << "application-somehwid-11-4321.rcore.lzo"
+            << true << "application" << "somehwid" << 11 << 4321
+            << int(CReporterCrashInfo::Crash);
+    QTest::newRow("quickie")
+            << "/var/cache/core-dumps/Quickie-somehwid-0-1234.rcore.lzo"
+            << true << "Quickie" << "somehwid" << 0 << 1234
+            << int(CReporterCrashInfo::QuickFeedback);
+    QTest::newRow("endurance")
+            << "/var/cache/core-dumps/Endurance-somehwid-1600000000-25.rcore.lzo"
+            << true << "Endurance" << "somehwid" << 1600000000 << 25
+            << int(CReporterCrashInfo::Endurance);
+    QTest::newRow("non-numeric pid")
+            << "/var/cache/core-dumps/application-somehwid-11-abc.rcore.lzo"
+            << false << "application" << "somehwid" << 11 << 0
+            << int(CReporterCrashInfo::Crash);
+    QTest::newRow("too few fields")
+            << "/var/cache/core-dumps/application-11.rcore.lzo"
+            << false << "application-11" << "" << 0 << 0
+            << int(CReporterCrashInfo::Crash);
+}
+
+void Ut_CReporterUtils::testCrashInfoFromFileName()
+{
+    QFETCH(QString, path);
+    QFETCH(bool, valid);
+    QFETCH(QString, applicationName);
+    QFETCH(QString, hwId);
+    QFETCH(int, signalNumber);
+    QFETCH(int, pid);
+    QFETCH(int, type);
+
+    CReporterCrashInfo info = CReporterCrashInfo::fromFileName(path);
+
+    QCOMPARE(info.isValid(), valid);
+    QCOMPARE(info.applicationName(), applicationName);
+    QCOMPARE(info.hwId(), hwId);
+    if (valid) {
+        QCOMPARE(info.signalNumber(), signalNumber);
+        QCOMPARE(info.pid(), pid);
+    }
+    QCOMPARE(int(info.type()), type);
+}
+
+void Ut_CReporterUtils::benchmarkParseCrashInfo_data()
+{
+    QTest::addColumn<bool>("legacy");
+
+    QTest::newRow("parseCrashInfoFromFilename") << true;
+    QTest::newRow("CReporterCrashInfo") << false;
+}
+
+void Ut_CReporterUtils::benchmarkParseCrashInfo()
+{
+    QFETCH(bool, legacy);
+
+    QStringList paths;
+    for (int i = 0; i < 1000; ++i) {
+        paths << QString("/var/cache/core-dumps/some-application-somehwid-11-%1.rcore.lzo").arg(i);
+    }
+
+    int pidSum = 0;
+    if (legacy) {
+        QBENCHMARK {
+            foreach (const QString &path, paths) {
+                pidSum += CReporterUtils::parseCrashInfoFromFilename(path).at(3).toInt();
+            }
+        }
+    } else {
+        QBENCHMARK {
+            foreach (const QString &path, paths) {
+                pidSum += CReporterCrashInfo::fromFileName(path).pid();
+            }
+        }
+    }
+    QVERIFY(pidSum > 0);
+}
+
 void Ut_CReporterUtils::testFileSizeToString()
 {
     QString sizeToStr = CReporterUtils::fileSizeToString(0);
@@ -39,6 +39,10 @@ private Q_SLOTS:
     void testValidateCore();
     void testRemoveFile();
     void testParseCrashInfoFromFilename();
+    void testCrashInfoFromFileName_data();
+    void testCrashInfoFromFileName();
+    void benchmarkParseCrashInfo_data();
+    void benchmarkParseCrashInfo();
     void testFileSizeToString();
 
     void cleanupTestCase();
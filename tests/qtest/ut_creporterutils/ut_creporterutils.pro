@@ -9,14 +9,23 @@ INCLUDEPATH += . \
 
 DEPENDPATH += $$INCLUDEPATH \
 
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
 TEST_STUBS += \
 
 # sources to be tested
 TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.cpp \
+                $${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.cpp \
 
 HEADERS += \
 	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporterlzowriter.h \
 	$${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creporteruploadnotifier.h \
+	$${CREPORTER_SRC_DIR}/libs/utils/creportercrashinfo.h \
 	ut_creporterutils.h \
 
 # unit test and sources
@@ -0,0 +1,218 @@
+/*
+ * This file is part of crash-reporter
+ *
+ * Copyright (C) 2021 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <lzma.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+
+#include "ut_endurancepacker.h"
+#include "endurancepacker.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+
+static const QString testDirectory("/tmp/crash-reporter-tests");
+static const QString snapshotDirectory(testDirectory + "/endurance.1600000000");
+static const QString reportPath(testDirectory + "/Endurance-hwid-1600000000-1599990000.rcore.lzo");
+
+static void writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(data), qint64(data.size()));
+}
+
+static QByteArray xzDecompress(const QByteArray &data)
+{
+    lzma_stream xz = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&xz, UINT64_MAX, 0) != LZMA_OK) {
+        return QByteArray();
+    }
+
+    QByteArray result(16 * 1024 * 1024, '\0');
+    xz.next_in = reinterpret_cast<const uint8_t *>(data.constData());
+    xz.avail_in = data.size();
+    xz.next_out = reinterpret_cast<uint8_t *>(result.data());
+    xz.avail_out = result.size();
+
+    lzma_ret ret = lzma_code(&xz, LZMA_FINISH);
+    result.truncate(result.size() - xz.avail_out);
+    lzma_end(&xz);
+
+    return ret == LZMA_STREAM_END ? result : QByteArray();
+}
+
+/*
+ * Reads the archive into name -> contents map, verifying header checksums
+ * and the end of archive marker.
+ */
+static QMap<QString, QByteArray> readTar(const QByteArray &tar)
+{
+    QMap<QString, QByteArray> files;
+
+    int offset = 0;
+    while (offset + 512 <= tar.size()) {
+        QByteArray header(tar.mid(offset, 512));
+        if (header == QByteArray(512, '\0')) {
+            if (tar.mid(offset) == QByteArray(1024, '\0')) {
+                return files;
+            }
+            break;
+        }
+
+        unsigned int checksum = 0;
+        for (int i = 0; i < 512; ++i) {
+            checksum += (i >= 148 && i < 156) ? ' ' : uchar(header.at(i));
+        }
+        if (header.mid(148, 6).toUInt(0, 8) != checksum || header.mid(257, 6) != QByteArray("ustar", 6)) {
+            break;
+        }
+
+        QByteArray name(header.constData());
+        name.truncate(100);
+        QByteArray prefix(header.constData() + 345);
+        prefix.truncate(155);
+        if (!prefix.isEmpty()) {
+            name = prefix + '/' + name;
+        }
+
+        int size = header.mid(124, 11).toInt(0, 8);
+        files.insert(QString::fromUtf8(name), tar.mid(offset + 512, size));
+        offset += 512 + (size + 511) / 512 * 512;
+    }
+
+    // Marks a broken archive.
+    files.insert(QString(), QByteArray());
+    return files;
+}
+
+void Ut_EndurancePacker::init()
+{
+    QDir().mkpath(snapshotDirectory);
+}
+
+void Ut_EndurancePacker::testReportSections()
+{
+    writeFile(snapshotDirectory + "/000/stat", "btime 1599990000\n");
+
+    EndurancePacker packer(reportPath);
+    QVERIFY(packer.open());
+    QVERIFY(packer.addSection("device-uid", "1234\n"));
+    QVERIFY(packer.addSection("boot-time", "1599990000\n"));
+    QVERIFY(packer.addSnapshotPack(snapshotDirectory));
+    QVERIFY(packer.finish());
+    QVERIFY(packer.errorString().isEmpty());
+
+    QCOMPARE(QDir(testDirectory).entryList(QDir::Files | QDir::Hidden),
+             QStringList() << QFileInfo(reportPath).fileName());
+
+    CReporterRichCoreReader reader(reportPath);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("device-uid"));
+    QCOMPARE(reader.readSection(), QByteArray("1234\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("boot-time"));
+    QCOMPARE(reader.readSection(), QByteArray("1599990000\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("endurance-snapshot-pack.tar.xz"));
+    QVERIFY(reader.readSection().startsWith("\xfd" "7zXZ"));
+    QVERIFY(!reader.nextSection());
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void Ut_EndurancePacker::testSnapshotArchive_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("single thread") << 1;
+    QTest::newRow("multiple threads") << 4;
+}
+
+void Ut_EndurancePacker::testSnapshotArchive()
+{
+    QFETCH(int, threads);
+
+    QByteArray smaps;
+    while (smaps.size() < 600 * 1024) {
+        smaps += "7f000000-7f001000 r-xp 00000000 b3:0e 1234 /usr/lib/libfoo.so\n";
+    }
+    QByteArray block(512, 'b');
+
+    writeFile(snapshotDirectory + "/000/stat", "btime 1599990000\n");
+    writeFile(snapshotDirectory + "/000/empty", QByteArray());
+    writeFile(snapshotDirectory + "/000/aligned", block);
+    QVERIFY(CReporterLzoWriter::append(smaps, snapshotDirectory + "/000/smaps.cap.lzo"));
+    writeFile(snapshotDirectory + "/001/usage.csv", "time,pid\n");
+    writeFile(snapshotDirectory + "/001/sub/file", "nested\n");
+    QString longName("001/" + QString(120, 'd') + "/file");
+    writeFile(snapshotDirectory + '/' + longName, "long\n");
+    // Only snapshot directories are packed.
+    writeFile(snapshotDirectory + "/snapshot_count", "2");
+
+    EndurancePacker packer(reportPath);
+    packer.setMaxThreads(threads);
+    QVERIFY(packer.open());
+    QVERIFY(packer.addSnapshotPack(snapshotDirectory));
+    QVERIFY(packer.finish());
+
+    CReporterRichCoreReader reader(reportPath);
+    QVERIFY(reader.open());
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("endurance-snapshot-pack.tar.xz"));
+
+    QMap<QString, QByteArray> files(readTar(xzDecompress(reader.readSection(16 * 1024 * 1024))));
+    QMap<QString, QByteArray> expected;
+    expected.insert("000/stat", "btime 1599990000\n");
+    expected.insert("000/empty", QByteArray());
+    expected.insert("000/aligned", block);
+    expected.insert("000/smaps.cap", smaps);
+    expected.insert("001/usage.csv", "time,pid\n");
+    expected.insert("001/sub/file", "nested\n");
+    expected.insert(longName, "long\n");
+
+    QCOMPARE(files.keys(), expected.keys());
+    QVERIFY(files == expected);
+}
+
+void Ut_EndurancePacker::testFailedReportIsRemoved()
+{
+    {
+        EndurancePacker packer(reportPath);
+        QVERIFY(packer.open());
+        QVERIFY(packer.addSection("device-uid", "1234\n"));
+    }
+
+    QCOMPARE(QDir(testDirectory).entryList(QDir::Files | QDir::Hidden), QStringList());
+
+    EndurancePacker packer(testDirectory + "/missing/report.rcore.lzo");
+    QVERIFY(!packer.open());
+    QVERIFY(!packer.errorString().isEmpty());
+}
+
+void Ut_EndurancePacker::cleanup()
+{
+    QDir(testDirectory).removeRecursively();
+}
+
+QTEST_MAIN(Ut_EndurancePacker)
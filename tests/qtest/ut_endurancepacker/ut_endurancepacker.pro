@@ -0,0 +1,30 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+ENDURANCEPACK_SRC_DIR = $${CREPORTER_SRC_DIR}/endurancepack
+
+TARGET = ut_endurancepacker
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += liblzma lzo2
+
+INCLUDEPATH += . \
+               $${ENDURANCEPACK_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${ENDURANCEPACK_SRC_DIR}/endurancepacker.cpp \
+
+HEADERS += $${ENDURANCEPACK_SRC_DIR}/endurancepacker.h \
+           ut_endurancepacker.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_endurancepacker.cpp \
+
+include(../ut_coverage.pri)